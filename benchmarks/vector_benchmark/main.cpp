@@ -30,6 +30,41 @@ static const size_t kIterations = 100;
 using mathfu::Random;
 using mathfu::Vector;
 
+// Measure integer vector operations on an array of d-dimensional vectors,
+// printing the elapsed time.
+template <int d>
+static void IntVectorBenchmark() {
+  Vector<int, d> *vectors = new Vector<int, d>[kVectorSize];
+  for (size_t i = 0; i < kVectorSize; i++) {
+    for (int e = 0; e < d; e++) {
+      vectors[i][e] = static_cast<int>(mathfu::RandomRange<float>(100.0f));
+    }
+  }
+  Vector<int, d> sum(0);
+  Vector<int, d> product(1);
+  int num_equal = 0;
+  Timer timer;
+  PERFTEST_2D_VECTOR_LOOP(kIterations, kVectorSize) sum += vectors[j];
+  PERFTEST_2D_VECTOR_LOOP(kIterations, kVectorSize) sum -= vectors[j];
+  PERFTEST_2D_VECTOR_LOOP(kIterations, kVectorSize) product *= vectors[j];
+  PERFTEST_2D_VECTOR_LOOP(kIterations, kVectorSize) {
+    sum = Vector<int, d>::Min(sum, vectors[i] + vectors[j]);
+  }
+  PERFTEST_2D_VECTOR_LOOP(kIterations, kVectorSize) {
+    sum = Vector<int, d>::Max(sum, vectors[i] - vectors[j]);
+  }
+  PERFTEST_2D_VECTOR_LOOP(kIterations, kVectorSize) {
+    num_equal += vectors[i] == vectors[j];
+  }
+  PERFTEST_2D_VECTOR_LOOP(kIterations, kVectorSize) {
+    sum += Vector<int, d>(Vector<float, d>(vectors[j]) * 0.5f);
+  }
+  const double elapsed = timer.GetElapsedSeconds();
+  printf("Vector<int, %d> took %f seconds (%d)\n", d, elapsed,
+         sum[0] + product[0] + num_equal);
+  delete [] vectors;
+}
+
 // This test creates a number of vectors and performs some mathematical
 // operations on them in order to measure expected performance of vector
 // operations.
@@ -72,5 +107,8 @@ int main(int argc, char** argv) {
   double elapsed = timer.GetElapsedSeconds();
   printf("Took %f seconds\n", elapsed);
   delete [] vectors;
+  IntVectorBenchmark<2>();
+  IntVectorBenchmark<3>();
+  IntVectorBenchmark<4>();
   return 0;
 }
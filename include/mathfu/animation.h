@@ -0,0 +1,246 @@
+/*
+* Copyright 2016 Google Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef MATHFU_ANIMATION_H_
+#define MATHFU_ANIMATION_H_
+
+#include "mathfu/matrix.h"
+#include "mathfu/quaternion.h"
+#include "mathfu/utilities.h"
+#include "mathfu/vector.h"
+
+#include <algorithm>
+#include <vector>
+
+/// @file mathfu/animation.h
+/// @brief Keyframe animation sampling.
+/// @addtogroup mathfu_animation
+///
+/// MathFu provides an AnimationSampler which interpolates the keyframes of
+/// all tracks of a skeleton at a point in time.
+
+namespace mathfu {
+
+/// @addtogroup mathfu_animation
+/// @{
+
+/// @class AnimationChannel "mathfu/animation.h"
+/// @brief Keyframes of a single animated value.
+///
+/// The channel references keyframe data owned by the caller.  Times must be
+/// sorted in ascending order.
+///
+/// @tparam T type of the keyframe times.
+/// @tparam Value type of the keyframe values.
+template <class T, class Value>
+struct AnimationChannel {
+  /// @brief Create an empty channel, which samples the default value.
+  AnimationChannel() : times(NULL), values(NULL), count(0) {}
+
+  /// @brief Create a channel from arrays of keyframes.
+  ///
+  /// @param times Array of count keyframe times in ascending order.
+  /// @param values Array of count keyframe values.
+  /// @param count Number of keyframes.
+  AnimationChannel(const T* times, const Value* values, int count)
+      : times(times), values(values), count(count) {}
+
+  /// Keyframe times in ascending order.
+  const T* times;
+  /// Keyframe values.
+  const Value* values;
+  /// Number of keyframes.
+  int count;
+};
+
+/// @class AnimationTrack "mathfu/animation.h"
+/// @brief Translation, rotation and scale keyframes of a single bone.
+///
+/// Channels without keyframes sample a zero translation, an identity rotation
+/// and a unit scale respectively.
+///
+/// @tparam T type of the keyframe times and values.
+template <class T>
+struct AnimationTrack {
+  /// Translation keyframes.
+  AnimationChannel<T, Vector<T, 3> > translation;
+  /// Rotation keyframes.
+  AnimationChannel<T, Quaternion<T> > rotation;
+  /// Scale keyframes.
+  AnimationChannel<T, Vector<T, 3> > scale;
+};
+
+/// @class AnimationSampler "mathfu/animation.h"
+/// @brief Samples all tracks of a skeleton at a point in time.
+///
+/// The sampler keeps a cursor to the last keyframe used in each channel, so
+/// when the animation is played forward each sample only has to check the
+/// next keyframe, which is O(1) per channel.  Seeking falls back to a binary
+/// search.  Each channel type is processed for all tracks in a separate
+/// pass, which keeps the interpolation loops free of per-bone dispatch.
+///
+/// Vector values are linearly interpolated and rotations are interpolated
+/// using Quaternion::SlerpFast().
+///
+/// @tparam T type of the keyframe times and values.
+template <class T>
+class AnimationSampler {
+ public:
+  /// @brief Create a sampler for an array of tracks.
+  ///
+  /// @param tracks Array of num_tracks tracks.  The array and the keyframes
+  /// it references must remain valid while the sampler is in use.
+  /// @param num_tracks Number of tracks.
+  AnimationSampler(const AnimationTrack<T>* tracks, int num_tracks)
+      : tracks_(tracks),
+        num_tracks_(num_tracks),
+        cursors_(static_cast<size_t>(num_tracks) * 3, 0) {}
+
+  /// @brief Get the number of tracks sampled by this object.
+  ///
+  /// @return Number of tracks.
+  int num_tracks() const { return num_tracks_; }
+
+  /// @brief Reset the cached keyframe cursors to the start of the animation.
+  void Reset() { std::fill(cursors_.begin(), cursors_.end(), 0); }
+
+  /// @brief Sample the translation, rotation and scale of all tracks.
+  ///
+  /// @param time Time to sample.  Times outside of the range of keyframes of
+  /// a channel are clamped to the first or last keyframe.
+  /// @param translations Array of num_tracks() entries which receives the
+  /// translation of each track.
+  /// @param rotations Array of num_tracks() entries which receives the
+  /// rotation of each track.
+  /// @param scales Array of num_tracks() entries which receives the scale of
+  /// each track.
+  void Sample(T time, Vector<T, 3>* translations, Quaternion<T>* rotations,
+              Vector<T, 3>* scales) {
+    int* const cursors = cursors_.empty() ? NULL : &cursors_[0];
+    int* const translation_cursors = cursors;
+    int* const rotation_cursors = cursors + num_tracks_;
+    int* const scale_cursors = cursors + 2 * num_tracks_;
+    for (int i = 0; i < num_tracks_; ++i) {
+      translations[i] = SampleVector(tracks_[i].translation, time,
+                                     static_cast<T>(0),
+                                     &translation_cursors[i]);
+    }
+    for (int i = 0; i < num_tracks_; ++i) {
+      rotations[i] =
+          SampleRotation(tracks_[i].rotation, time, &rotation_cursors[i]);
+    }
+    for (int i = 0; i < num_tracks_; ++i) {
+      scales[i] = SampleVector(tracks_[i].scale, time, static_cast<T>(1),
+                               &scale_cursors[i]);
+    }
+  }
+
+  /// @brief Sample the local transform of all tracks.
+  ///
+  /// @param time Time to sample.
+  /// @param transforms Array of num_tracks() entries which receives the
+  /// transform of each track, see Matrix::Transform().
+  void Sample(T time, Matrix<T, 4, 4>* transforms) {
+    translations_.resize(num_tracks_);
+    rotations_.resize(num_tracks_);
+    scales_.resize(num_tracks_);
+    if (num_tracks_ == 0) return;
+    Sample(time, &translations_[0], &rotations_[0], &scales_[0]);
+    for (int i = 0; i < num_tracks_; ++i) {
+      transforms[i] = Matrix<T, 4, 4>::Transform(
+          translations_[i], rotations_[i].ToMatrix(), scales_[i]);
+    }
+  }
+
+  /// @brief Find the keyframe interval containing a point in time.
+  ///
+  /// @param times Array of count keyframe times in ascending order.
+  /// @param count Number of keyframes, must be greater than 0.
+  /// @param time Time to find.
+  /// @param cursor Index of the keyframe found by the previous call for
+  /// this channel, which is checked before searching.  Receives the index
+  /// of the keyframe at the start of the interval.
+  /// @return Interpolation factor in [0, 1] between the keyframe at
+  /// cursor and the next keyframe.
+  static inline T FindKeyframe(const T* times, int count, T time,
+                               int* cursor) {
+    const int last = count - 1;
+    if (last <= 0 || time <= times[0]) {
+      *cursor = 0;
+      return static_cast<T>(0);
+    }
+    if (time >= times[last]) {
+      *cursor = last;
+      return static_cast<T>(0);
+    }
+    int index = *cursor;
+    if (index < 0 || index >= last || times[index] > time) {
+      index = Search(times, count, time);
+    } else if (times[index + 1] <= time) {
+      // Playback usually advances by at most one keyframe per sample.
+      ++index;
+      if (times[index + 1] <= time) index = Search(times, count, time);
+    }
+    *cursor = index;
+    const T start = times[index];
+    const T duration = times[index + 1] - start;
+    return duration > static_cast<T>(0) ? (time - start) / duration
+                                        : static_cast<T>(0);
+  }
+
+  MATHFU_DEFINE_CLASS_SIMD_AWARE_NEW_DELETE
+
+ private:
+  /// @cond MATHFU_INTERNAL
+  // Index of the last keyframe with a time <= time.
+  static inline int Search(const T* times, int count, T time) {
+    return static_cast<int>(std::upper_bound(times, times + count, time) -
+                            times) -
+           1;
+  }
+
+  static inline Vector<T, 3> SampleVector(
+      const AnimationChannel<T, Vector<T, 3> >& channel, T time,
+      T default_value, int* cursor) {
+    if (channel.count == 0) return Vector<T, 3>(default_value);
+    const T t = FindKeyframe(channel.times, channel.count, time, cursor);
+    const Vector<T, 3>& start = channel.values[*cursor];
+    if (*cursor == channel.count - 1) return start;
+    return Vector<T, 3>::Lerp(start, channel.values[*cursor + 1], t);
+  }
+
+  static inline Quaternion<T> SampleRotation(
+      const AnimationChannel<T, Quaternion<T> >& channel, T time,
+      int* cursor) {
+    if (channel.count == 0) return Quaternion<T>::identity;
+    const T t = FindKeyframe(channel.times, channel.count, time, cursor);
+    const Quaternion<T>& start = channel.values[*cursor];
+    if (*cursor == channel.count - 1) return start;
+    return Quaternion<T>::SlerpFast(start, channel.values[*cursor + 1], t);
+  }
+  /// @endcond
+
+  const AnimationTrack<T>* tracks_;
+  int num_tracks_;
+  std::vector<int> cursors_;
+  std::vector<Vector<T, 3>, simd_allocator<Vector<T, 3> > > translations_;
+  std::vector<Quaternion<T>, simd_allocator<Quaternion<T> > > rotations_;
+  std::vector<Vector<T, 3>, simd_allocator<Vector<T, 3> > > scales_;
+};
+/// @}
+
+}  // namespace mathfu
+
+#endif  // MATHFU_ANIMATION_H_
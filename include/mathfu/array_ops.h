@@ -0,0 +1,492 @@
+/*
+* Copyright 2016 Google Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef MATHFU_ARRAY_OPS_H_
+#define MATHFU_ARRAY_OPS_H_
+
+#include "mathfu/utilities.h"
+#include "mathfu/vector.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+/// @file mathfu/array_ops.h
+/// @brief Functions which process arrays of values and Vectors.
+///
+/// Reductions use several independent accumulators so each iteration does
+/// not wait for the result of the previous one.  Element-wise functions
+/// compute each result in a single pass over the arrays.  Arrays of floats
+/// are processed 4 values at a time with Vector<float, 4> when SIMD is
+/// enabled.
+
+namespace mathfu {
+
+/// @addtogroup mathfu_utilities
+/// @{
+
+/// @brief Calculate the sum of an array of values.
+///
+/// @param values Array of count values.
+/// @param count Number of values.
+/// @return Sum of the values, 0 if the array is empty.
+template <class T>
+inline T Sum(const T* values, size_t count) {
+  T sum0 = static_cast<T>(0), sum1 = sum0, sum2 = sum0, sum3 = sum0;
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    sum0 += values[i];
+    sum1 += values[i + 1];
+    sum2 += values[i + 2];
+    sum3 += values[i + 3];
+  }
+  for (; i < count; ++i) sum0 += values[i];
+  return (sum0 + sum1) + (sum2 + sum3);
+}
+
+/// @brief Find the smallest and largest values in an array.
+///
+/// @param values Array of count values, which must not be empty.
+/// @param count Number of values.
+/// @param min Receives the smallest value.
+/// @param max Receives the largest value.
+template <class T>
+inline void Bounds(const T* values, size_t count, T* min, T* max) {
+  assert(count > 0);
+  T lower0 = values[0], lower1 = lower0, upper0 = lower0, upper1 = lower0;
+  size_t i = 1;
+  for (; i + 2 <= count; i += 2) {
+    const T value0 = values[i];
+    const T value1 = values[i + 1];
+    lower0 = value0 < lower0 ? value0 : lower0;
+    lower1 = value1 < lower1 ? value1 : lower1;
+    upper0 = value0 > upper0 ? value0 : upper0;
+    upper1 = value1 > upper1 ? value1 : upper1;
+  }
+  if (i < count) {
+    lower0 = values[i] < lower0 ? values[i] : lower0;
+    upper0 = values[i] > upper0 ? values[i] : upper0;
+  }
+  *min = lower1 < lower0 ? lower1 : lower0;
+  *max = upper1 > upper0 ? upper1 : upper0;
+}
+
+#ifdef MATHFU_COMPILE_WITH_SIMD
+/// @cond MATHFU_INTERNAL
+// Float overloads which process 4 values at a time with Vector<float, 4>,
+// which is SIMD on every supported architecture.
+inline float Sum(const float* values, size_t count) {
+  const Vector<float, 4> zero(0.0f);
+  Vector<float, 4> sum0 = zero, sum1 = zero, sum2 = zero, sum3 = zero;
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    sum0 += Vector<float, 4>(&values[i]);
+    sum1 += Vector<float, 4>(&values[i + 4]);
+    sum2 += Vector<float, 4>(&values[i + 8]);
+    sum3 += Vector<float, 4>(&values[i + 12]);
+  }
+  for (; i + 4 <= count; i += 4) sum0 += Vector<float, 4>(&values[i]);
+  float result = ((sum0 + sum1) + (sum2 + sum3)).Sum();
+  for (; i < count; ++i) result += values[i];
+  return result;
+}
+
+inline void Bounds(const float* values, size_t count, float* min,
+                   float* max) {
+  typedef Vector<float, 4> Vec4;
+  assert(count > 0);
+  Vec4 lower0(values[0]), lower1 = lower0, upper0 = lower0, upper1 = lower0;
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const Vec4 value0(&values[i]);
+    const Vec4 value1(&values[i + 4]);
+    lower0 = Vec4::Min(lower0, value0);
+    lower1 = Vec4::Min(lower1, value1);
+    upper0 = Vec4::Max(upper0, value0);
+    upper1 = Vec4::Max(upper1, value1);
+  }
+  for (; i + 4 <= count; i += 4) {
+    const Vec4 value(&values[i]);
+    lower0 = Vec4::Min(lower0, value);
+    upper0 = Vec4::Max(upper0, value);
+  }
+  for (; i < count; ++i) {
+    const Vec4 value(values[i]);
+    lower0 = Vec4::Min(lower0, value);
+    upper0 = Vec4::Max(upper0, value);
+  }
+  *min = Vec4::Min(lower0, lower1).MinComponent();
+  *max = Vec4::Max(upper0, upper1).MaxComponent();
+}
+/// @endcond
+#endif  // MATHFU_COMPILE_WITH_SIMD
+
+/// @brief Calculate the sum of an array of Vectors.
+///
+/// @param vectors Array of count Vectors.
+/// @param count Number of Vectors.
+/// @return Sum of the Vectors, a zero Vector if the array is empty.
+template <class T, int Dims>
+inline Vector<T, Dims> Sum(const Vector<T, Dims>* vectors, size_t count) {
+  Vector<T, Dims> sum0(static_cast<T>(0)), sum1 = sum0, sum2 = sum0,
+      sum3 = sum0;
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    sum0 += vectors[i];
+    sum1 += vectors[i + 1];
+    sum2 += vectors[i + 2];
+    sum3 += vectors[i + 3];
+  }
+  for (; i < count; ++i) sum0 += vectors[i];
+  return (sum0 + sum1) + (sum2 + sum3);
+}
+
+/// @brief Calculate the axis aligned bounds of an array of Vectors.
+///
+/// @param vectors Array of count Vectors, which must not be empty.
+/// @param count Number of Vectors.
+/// @param min Receives the smallest value of each element of the Vectors.
+/// @param max Receives the largest value of each element of the Vectors.
+template <class T, int Dims>
+inline void Bounds(const Vector<T, Dims>* vectors, size_t count,
+                   Vector<T, Dims>* min, Vector<T, Dims>* max) {
+  assert(count > 0);
+  Vector<T, Dims> lower0 = vectors[0], lower1 = lower0, upper0 = lower0,
+                  upper1 = lower0;
+  size_t i = 1;
+  for (; i + 2 <= count; i += 2) {
+    lower0 = Vector<T, Dims>::Min(lower0, vectors[i]);
+    lower1 = Vector<T, Dims>::Min(lower1, vectors[i + 1]);
+    upper0 = Vector<T, Dims>::Max(upper0, vectors[i]);
+    upper1 = Vector<T, Dims>::Max(upper1, vectors[i + 1]);
+  }
+  if (i < count) {
+    lower0 = Vector<T, Dims>::Min(lower0, vectors[i]);
+    upper0 = Vector<T, Dims>::Max(upper0, vectors[i]);
+  }
+  *min = Vector<T, Dims>::Min(lower0, lower1);
+  *max = Vector<T, Dims>::Max(upper0, upper1);
+}
+
+/// @brief Calculate the centroid (mean) of an array of Vectors.
+///
+/// @param vectors Array of count Vectors, which must not be empty.
+/// @param count Number of Vectors.
+/// @return Mean of the Vectors.
+template <class T, int Dims>
+inline Vector<T, Dims> Centroid(const Vector<T, Dims>* vectors,
+                                size_t count) {
+  assert(count > 0);
+  return Sum(vectors, count) / static_cast<T>(count);
+}
+
+/// @brief Clamp each value of an array within [lower, upper].
+///
+/// @note Results are undefined if lower > upper.
+///
+/// @param values Array of count values or Vectors.
+/// @param count Number of values.
+/// @param lower Lower value of the range.
+/// @param upper Upper value of the range.
+/// @param results Array of count elements which receives the clamped values,
+/// this can be the same array as values.
+template <class T>
+inline void Clamp(const T* values, size_t count, const T& lower,
+                  const T& upper, T* results) {
+  for (size_t i = 0; i < count; ++i) {
+    results[i] = Clamp(values[i], lower, upper);
+  }
+}
+
+/// @brief Linearly interpolate between the elements of two arrays.
+///
+/// @param range_start Array of count values or Vectors at the start of each
+/// range.
+/// @param range_end Array of count values or Vectors at the end of each
+/// range.
+/// @param count Number of elements in each array.
+/// @param percent Value between 0.0 and 1.0 used to interpolate each range.
+/// @param results Array of count elements which receives the interpolated
+/// values, this can be the same array as range_start or range_end.
+template <class T, class T2>
+inline void Lerp(const T* range_start, const T* range_end, size_t count,
+                 const T2& percent, T* results) {
+  const T2 one_minus_percent = static_cast<T2>(1) - percent;
+  for (size_t i = 0; i < count; ++i) {
+    results[i] = range_start[i] * one_minus_percent + range_end[i] * percent;
+  }
+}
+
+/// @brief Linearly interpolate between the elements of two arrays with a
+/// separate interpolation value for each element.
+///
+/// @param range_start Array of count values or Vectors at the start of each
+/// range.
+/// @param range_end Array of count values or Vectors at the end of each
+/// range.
+/// @param percent Array of count values between 0.0 and 1.0 used to
+/// interpolate each range.
+/// @param count Number of elements in each array.
+/// @param results Array of count elements which receives the interpolated
+/// values, this can be the same array as any of the inputs.
+template <class T, class T2>
+inline void Lerp(const T* range_start, const T* range_end, const T2* percent,
+                 size_t count, T* results) {
+  for (size_t i = 0; i < count; ++i) {
+    const T2 one_minus_percent = static_cast<T2>(1) - percent[i];
+    results[i] =
+        range_start[i] * one_minus_percent + range_end[i] * percent[i];
+  }
+}
+
+/// @brief Map each value of an array from one range to another.
+///
+/// Each value is mapped with a single multiply and add, values outside
+/// [from_start, from_end] are extrapolated.
+///
+/// @param values Array of count values or Vectors.
+/// @param count Number of values.
+/// @param from_start Start of the range of values, which maps to to_start.
+/// @param from_end End of the range of values, which maps to to_end.  This
+/// must differ from from_start.
+/// @param to_start Start of the range of results.
+/// @param to_end End of the range of results.
+/// @param results Array of count elements which receives the mapped values,
+/// this can be the same array as values.
+template <class T>
+inline void Remap(const T* values, size_t count, const T& from_start,
+                  const T& from_end, const T& to_start, const T& to_end,
+                  T* results) {
+  assert(from_start != from_end);
+  const T scale = (to_end - to_start) / (from_end - from_start);
+  const T offset = to_start - from_start * scale;
+  for (size_t i = 0; i < count; ++i) results[i] = values[i] * scale + offset;
+}
+
+/// @brief Map each value of an array from one range to another, clamping
+/// the results to the destination range.
+///
+/// @param values Array of count values.
+/// @param count Number of values.
+/// @param from_start Start of the range of values, which maps to to_start.
+/// @param from_end End of the range of values, which maps to to_end.  This
+/// must differ from from_start.
+/// @param to_start Start of the range of results.
+/// @param to_end End of the range of results.
+/// @param results Array of count elements which receives the mapped values,
+/// this can be the same array as values.
+template <class T>
+inline void RemapClamped(const T* values, size_t count, T from_start,
+                         T from_end, T to_start, T to_end, T* results) {
+  assert(from_start != from_end);
+  const T scale = static_cast<T>(1) / (from_end - from_start);
+  const T offset = -from_start * scale;
+  const T range = to_end - to_start;
+  for (size_t i = 0; i < count; ++i) {
+    const T t = Clamp(values[i] * scale + offset, static_cast<T>(0),
+                      static_cast<T>(1));
+    results[i] = t * range + to_start;
+  }
+}
+
+/// @brief Calculate the smoothstep (cubic Hermite) function of each value of
+/// an array.
+///
+/// Each result is 0 for values <= edge0, 1 for values >= edge1 and
+/// 3t^2 - 2t^3 between them where t = (value - edge0) / (edge1 - edge0).
+///
+/// @param values Array of count values.
+/// @param count Number of values.
+/// @param edge0 Value where the results start to increase from 0.
+/// @param edge1 Value where the results reach 1.  This must differ from
+/// edge0.
+/// @param results Array of count elements which receives the smoothstep
+/// values, this can be the same array as values.
+template <class T>
+inline void SmoothStep(const T* values, size_t count, T edge0, T edge1,
+                       T* results) {
+  assert(edge0 != edge1);
+  const T scale = static_cast<T>(1) / (edge1 - edge0);
+  const T offset = -edge0 * scale;
+  for (size_t i = 0; i < count; ++i) {
+    const T t = Clamp(values[i] * scale + offset, static_cast<T>(0),
+                      static_cast<T>(1));
+    results[i] = t * t * (static_cast<T>(3) - static_cast<T>(2) * t);
+  }
+}
+
+#ifdef MATHFU_COMPILE_WITH_SIMD
+/// @cond MATHFU_INTERNAL
+// Store 4 results to an array which may not be aligned.
+inline void StoreArrayFloat4(const Vector<float, 4>& v, float* results) {
+  VectorPacked<float, 4> packed;
+  v.Pack(&packed);
+  memcpy(results, packed.data_, sizeof(packed.data_));
+}
+
+// Float overloads which process 4 values at a time with Vector<float, 4>
+// and the remaining values with the templates above.
+inline void Clamp(const float* values, size_t count, const float& lower,
+                  const float& upper, float* results) {
+  typedef Vector<float, 4> Vec4;
+  const Vec4 lower4(lower), upper4(upper);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    StoreArrayFloat4(Vec4::Max(lower4, Vec4::Min(Vec4(&values[i]), upper4)),
+                     &results[i]);
+  }
+  Clamp<float>(values + i, count - i, lower, upper, results + i);
+}
+
+inline void Lerp(const float* range_start, const float* range_end,
+                 size_t count, const float& percent, float* results) {
+  typedef Vector<float, 4> Vec4;
+  const Vec4 percent4(percent), one_minus_percent4(1.0f - percent);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    StoreArrayFloat4(Vec4(&range_start[i]) * one_minus_percent4 +
+                         Vec4(&range_end[i]) * percent4,
+                     &results[i]);
+  }
+  Lerp<float, float>(range_start + i, range_end + i, count - i, percent,
+                     results + i);
+}
+
+inline void Lerp(const float* range_start, const float* range_end,
+                 const float* percent, size_t count, float* results) {
+  typedef Vector<float, 4> Vec4;
+  const Vec4 one(1.0f);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const Vec4 percent4(&percent[i]);
+    StoreArrayFloat4(Vec4(&range_start[i]) * (one - percent4) +
+                         Vec4(&range_end[i]) * percent4,
+                     &results[i]);
+  }
+  Lerp<float, float>(range_start + i, range_end + i, percent + i, count - i,
+                     results + i);
+}
+
+inline void Remap(const float* values, size_t count, const float& from_start,
+                  const float& from_end, const float& to_start,
+                  const float& to_end, float* results) {
+  typedef Vector<float, 4> Vec4;
+  assert(from_start != from_end);
+  const float scale = (to_end - to_start) / (from_end - from_start);
+  const float offset = to_start - from_start * scale;
+  const Vec4 scale4(scale), offset4(offset);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    StoreArrayFloat4(Vec4(&values[i]) * scale4 + offset4, &results[i]);
+  }
+  Remap<float>(values + i, count - i, from_start, from_end, to_start, to_end,
+               results + i);
+}
+
+inline void RemapClamped(const float* values, size_t count, float from_start,
+                         float from_end, float to_start, float to_end,
+                         float* results) {
+  typedef Vector<float, 4> Vec4;
+  assert(from_start != from_end);
+  const float scale = 1.0f / (from_end - from_start);
+  const Vec4 scale4(scale), offset4(-from_start * scale);
+  const Vec4 range4(to_end - to_start), to_start4(to_start);
+  const Vec4 zero(0.0f), one(1.0f);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const Vec4 t =
+        Vec4::Max(zero, Vec4::Min(Vec4(&values[i]) * scale4 + offset4, one));
+    StoreArrayFloat4(t * range4 + to_start4, &results[i]);
+  }
+  RemapClamped<float>(values + i, count - i, from_start, from_end, to_start,
+                      to_end, results + i);
+}
+
+inline void SmoothStep(const float* values, size_t count, float edge0,
+                       float edge1, float* results) {
+  typedef Vector<float, 4> Vec4;
+  assert(edge0 != edge1);
+  const float scale = 1.0f / (edge1 - edge0);
+  const Vec4 scale4(scale), offset4(-edge0 * scale);
+  const Vec4 zero(0.0f), one(1.0f), two(2.0f), three(3.0f);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const Vec4 t =
+        Vec4::Max(zero, Vec4::Min(Vec4(&values[i]) * scale4 + offset4, one));
+    StoreArrayFloat4(t * t * (three - two * t), &results[i]);
+  }
+  SmoothStep<float>(values + i, count - i, edge0, edge1, results + i);
+}
+/// @endcond
+#endif  // MATHFU_COMPILE_WITH_SIMD
+
+/// @brief Map each Vector of an array from one range to another, clamping
+/// each element of the results to the destination range.
+///
+/// @param vectors Array of count Vectors.
+/// @param count Number of Vectors.
+/// @param from_start Start of the range of Vectors, which maps to to_start.
+/// @param from_end End of the range of Vectors, which maps to to_end.  No
+/// element of this can equal the same element of from_start.
+/// @param to_start Start of the range of results.
+/// @param to_end End of the range of results.
+/// @param results Array of count Vectors which receives the mapped Vectors,
+/// this can be the same array as vectors.
+template <class T, int Dims>
+inline void RemapClamped(const Vector<T, Dims>* vectors, size_t count,
+                         const Vector<T, Dims>& from_start,
+                         const Vector<T, Dims>& from_end,
+                         const Vector<T, Dims>& to_start,
+                         const Vector<T, Dims>& to_end,
+                         Vector<T, Dims>* results) {
+  const Vector<T, Dims> zero(static_cast<T>(0)), one(static_cast<T>(1));
+  const Vector<T, Dims> scale = one / (from_end - from_start);
+  const Vector<T, Dims> offset = -from_start * scale;
+  const Vector<T, Dims> range = to_end - to_start;
+  for (size_t i = 0; i < count; ++i) {
+    const Vector<T, Dims> t = Clamp(vectors[i] * scale + offset, zero, one);
+    results[i] = t * range + to_start;
+  }
+}
+
+/// @brief Calculate the smoothstep (cubic Hermite) function of each element
+/// of an array of Vectors.
+///
+/// @param vectors Array of count Vectors.
+/// @param count Number of Vectors.
+/// @param edge0 Values where the elements of the results start to increase
+/// from 0.
+/// @param edge1 Values where the elements of the results reach 1.  No
+/// element of this can equal the same element of edge0.
+/// @param results Array of count Vectors which receives the smoothstep
+/// values, this can be the same array as vectors.
+template <class T, int Dims>
+inline void SmoothStep(const Vector<T, Dims>* vectors, size_t count,
+                       const Vector<T, Dims>& edge0,
+                       const Vector<T, Dims>& edge1,
+                       Vector<T, Dims>* results) {
+  const Vector<T, Dims> zero(static_cast<T>(0)), one(static_cast<T>(1));
+  const Vector<T, Dims> scale = one / (edge1 - edge0);
+  const Vector<T, Dims> offset = -edge0 * scale;
+  for (size_t i = 0; i < count; ++i) {
+    const Vector<T, Dims> t = Clamp(vectors[i] * scale + offset, zero, one);
+    results[i] = t * t * (static_cast<T>(3) - t * static_cast<T>(2));
+  }
+}
+/// @}
+
+}  // namespace mathfu
+
+#endif  // MATHFU_ARRAY_OPS_H_
@@ -0,0 +1,587 @@
+/*
+* Copyright 2016 Google Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef MATHFU_BINARY_ARCHIVE_H_
+#define MATHFU_BINARY_ARCHIVE_H_
+
+#include "mathfu/matrix.h"
+#include "mathfu/quaternion.h"
+#include "mathfu/utilities.h"
+#include "mathfu/vector.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#define MATHFU_BINARY_ARCHIVE_UNDEF_NOMINMAX
+#endif  // NOMINMAX
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#define MATHFU_BINARY_ARCHIVE_UNDEF_WIN32_LEAN_AND_MEAN
+#endif  // WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#ifdef MATHFU_BINARY_ARCHIVE_UNDEF_NOMINMAX
+#undef NOMINMAX
+#undef MATHFU_BINARY_ARCHIVE_UNDEF_NOMINMAX
+#endif  // MATHFU_BINARY_ARCHIVE_UNDEF_NOMINMAX
+#ifdef MATHFU_BINARY_ARCHIVE_UNDEF_WIN32_LEAN_AND_MEAN
+#undef WIN32_LEAN_AND_MEAN
+#undef MATHFU_BINARY_ARCHIVE_UNDEF_WIN32_LEAN_AND_MEAN
+#endif  // MATHFU_BINARY_ARCHIVE_UNDEF_WIN32_LEAN_AND_MEAN
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // defined(_WIN32)
+
+/// @file mathfu/binary_archive.h
+/// @brief Binary archives of MathFu types which are used in place.
+/// @addtogroup mathfu_binary_archive
+///
+/// A binary archive stores arrays of scalars, VectorPacked, Matrix and
+/// Quaternion objects in their in-memory representation.  An archive is
+/// loaded by mapping the file into memory, after which each array is
+/// accessed through a BinaryArrayView without parsing or copying any data.
+///
+/// The archive is tagged with the byte order of the machine that wrote it
+/// and a format version.  Archives written with a different byte order or
+/// version are rejected, as are arrays of types whose size differs from the
+/// type of the view, for example Matrix<float, 3> archived by a build using
+/// MATHFU_COMPILE_WITH_PADDING and read by a build which does not use it.
+///
+/// The archive layout is:
+///   - BinaryArchiveHeader.
+///   - BinaryArchiveHeader::num_arrays BinaryArchiveArray descriptors.
+///   - Array data, each array aligned to kBinaryArchiveAlignment bytes.
+
+namespace mathfu {
+
+/// @addtogroup mathfu_binary_archive
+/// @{
+
+/// Version of the archive format written by BinaryArchiveWriter.
+static const uint32_t kBinaryArchiveVersion = 1;
+
+/// Value of BinaryArchiveHeader::byte_order, which reads as 0x04030201 on a
+/// machine with the opposite byte order.
+static const uint32_t kBinaryArchiveByteOrder = 0x01020304;
+
+/// Alignment in bytes of each array within an archive.
+static const uint32_t kBinaryArchiveAlignment = 64;
+
+/// @brief Header at the start of a binary archive.
+struct BinaryArchiveHeader {
+  /// Identifies the file as an archive, contains "MFBA".
+  char magic[4];
+  /// kBinaryArchiveByteOrder in the byte order of the writer.
+  uint32_t byte_order;
+  /// Version of the archive format, kBinaryArchiveVersion.
+  uint32_t version;
+  /// Number of arrays in the archive.
+  uint32_t num_arrays;
+  /// Size of the archive in bytes.
+  uint64_t size;
+  /// Reserved, set to 0.
+  uint64_t reserved;
+};
+
+/// @brief Descriptor of an array in a binary archive.
+struct BinaryArchiveArray {
+  /// Identifier of the array specified by the application.
+  uint32_t id;
+  /// Type of the elements, see BinaryArchiveType.
+  uint32_t type;
+  /// Size of each element in bytes.
+  uint32_t element_size;
+  /// Reserved, set to 0.
+  uint32_t reserved;
+  /// Number of elements in the array.
+  uint64_t count;
+  /// Offset of the first element from the start of the archive.
+  uint64_t offset;
+};
+
+/// @cond MATHFU_INTERNAL
+// Kinds of objects stored in an archive.
+enum BinaryArchiveKind {
+  kBinaryArchiveScalar = 1,
+  kBinaryArchiveVectorPacked = 2,
+  kBinaryArchiveMatrix = 3,
+  kBinaryArchiveQuaternion = 4
+};
+
+// Identifies the type of each scalar in an archive.
+template <class T>
+struct BinaryArchiveScalar;
+
+#define MATHFU_BINARY_ARCHIVE_SCALAR(type, code)   \
+  template <>                                      \
+  struct BinaryArchiveScalar<type> {               \
+    static inline uint32_t Code() { return code; } \
+  }
+
+MATHFU_BINARY_ARCHIVE_SCALAR(float, 1);
+MATHFU_BINARY_ARCHIVE_SCALAR(double, 2);
+MATHFU_BINARY_ARCHIVE_SCALAR(int8_t, 3);
+MATHFU_BINARY_ARCHIVE_SCALAR(uint8_t, 4);
+MATHFU_BINARY_ARCHIVE_SCALAR(int16_t, 5);
+MATHFU_BINARY_ARCHIVE_SCALAR(uint16_t, 6);
+MATHFU_BINARY_ARCHIVE_SCALAR(int32_t, 7);
+MATHFU_BINARY_ARCHIVE_SCALAR(uint32_t, 8);
+
+#undef MATHFU_BINARY_ARCHIVE_SCALAR
+
+inline uint32_t BinaryArchiveTypeTag(BinaryArchiveKind kind,
+                                     uint32_t scalar, int rows,
+                                     int columns) {
+  return (static_cast<uint32_t>(kind) << 24) | (scalar << 16) |
+         (static_cast<uint32_t>(rows) << 8) | static_cast<uint32_t>(columns);
+}
+/// @endcond
+
+/// @brief Identifies the type of the elements of an array in an archive.
+///
+/// @tparam T type of each element, a scalar, VectorPacked, Matrix or
+/// Quaternion.
+template <class T>
+struct BinaryArchiveType {
+  /// @return Value of BinaryArchiveArray::type for arrays of T.
+  static inline uint32_t Tag() {
+    return BinaryArchiveTypeTag(kBinaryArchiveScalar,
+                                BinaryArchiveScalar<T>::Code(), 1, 1);
+  }
+};
+
+/// @cond MATHFU_INTERNAL
+template <class T, int Dims>
+struct BinaryArchiveType<VectorPacked<T, Dims> > {
+  static inline uint32_t Tag() {
+    return BinaryArchiveTypeTag(kBinaryArchiveVectorPacked,
+                                BinaryArchiveScalar<T>::Code(), Dims, 1);
+  }
+};
+
+template <class T, int Rows, int Columns>
+struct BinaryArchiveType<Matrix<T, Rows, Columns> > {
+  static inline uint32_t Tag() {
+    return BinaryArchiveTypeTag(kBinaryArchiveMatrix,
+                                BinaryArchiveScalar<T>::Code(), Rows, Columns);
+  }
+};
+
+template <class T>
+struct BinaryArchiveType<Quaternion<T> > {
+  static inline uint32_t Tag() {
+    return BinaryArchiveTypeTag(kBinaryArchiveQuaternion,
+                                BinaryArchiveScalar<T>::Code(), 4, 1);
+  }
+};
+/// @endcond
+
+/// @class BinaryArrayView "mathfu/binary_archive.h"
+/// @brief Read-only view of an array stored in a BinaryArchive.
+///
+/// @tparam T type of each element.
+template <class T>
+class BinaryArrayView {
+ public:
+  /// @brief Create an empty view.
+  BinaryArrayView() : data_(NULL), size_(0) {}
+
+  /// @brief Create a view of an array.
+  ///
+  /// @param data Pointer to the first element.
+  /// @param size Number of elements.
+  BinaryArrayView(const T* data, size_t size) : data_(data), size_(size) {}
+
+  /// @brief Get an element of the array.
+  ///
+  /// @param i Index of the element, must be less than size().
+  /// @return Reference to the element.
+  inline const T& operator[](size_t i) const {
+    assert(i < size_);
+    return data_[i];
+  }
+
+  /// @return Pointer to the first element.
+  inline const T* data() const { return data_; }
+
+  /// @return Number of elements in the array.
+  inline size_t size() const { return size_; }
+
+  /// @return true if the array has no elements.
+  inline bool empty() const { return size_ == 0; }
+
+  /// @return Pointer to the first element.
+  inline const T* begin() const { return data_; }
+
+  /// @return Pointer past the last element.
+  inline const T* end() const { return data_ + size_; }
+
+ private:
+  const T* data_;
+  size_t size_;
+};
+
+/// @class BinaryArchiveWriter "mathfu/binary_archive.h"
+/// @brief Writes arrays to a binary archive.
+///
+/// The writer references the arrays added to it, which must remain valid
+/// until the archive has been written.
+class BinaryArchiveWriter {
+ public:
+  /// @brief Add an array to the archive.
+  ///
+  /// @param id Identifier of the array, used to find it in the archive.
+  /// @param elements Array of count elements.
+  /// @param count Number of elements.
+  template <class T>
+  void AddArray(uint32_t id, const T* elements, size_t count) {
+    Array array;
+    array.descriptor.id = id;
+    array.descriptor.type = BinaryArchiveType<T>::Tag();
+    array.descriptor.element_size = static_cast<uint32_t>(sizeof(T));
+    array.descriptor.reserved = 0;
+    array.descriptor.count = count;
+    array.descriptor.offset = 0;
+    array.data = elements;
+    arrays_.push_back(array);
+  }
+
+  /// @brief Get the size of the archive.
+  ///
+  /// @return Size of the archive in bytes.
+  size_t size() const { return Layout(NULL, NULL); }
+
+  /// @brief Write the archive to memory.
+  ///
+  /// @param buffer Buffer which receives the archive.
+  /// @param size Size of buffer in bytes.
+  /// @return true if the archive was written, false if the buffer is too
+  /// small.
+  bool Write(void* buffer, size_t size) const {
+    BinaryArchiveHeader header;
+    std::vector<BinaryArchiveArray> descriptors;
+    Layout(&header, &descriptors);
+    if (size < header.size) return false;
+    uint8_t* const output = static_cast<uint8_t*>(buffer);
+    memset(output, 0, static_cast<size_t>(header.size));
+    memcpy(output, &header, sizeof(header));
+    for (size_t i = 0; i < descriptors.size(); ++i) {
+      memcpy(output + sizeof(header) + i * sizeof(descriptors[i]),
+             &descriptors[i], sizeof(descriptors[i]));
+      memcpy(output + descriptors[i].offset, arrays_[i].data,
+             DataSize(descriptors[i]));
+    }
+    return true;
+  }
+
+  /// @brief Write the archive to a file.
+  ///
+  /// @param filename Name of the file to create or replace.
+  /// @return true if the archive was written, false otherwise.
+  bool Write(const char* filename) const {
+    BinaryArchiveHeader header;
+    std::vector<BinaryArchiveArray> descriptors;
+    Layout(&header, &descriptors);
+    FILE* const file = fopen(filename, "wb");
+    if (!file) return false;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok && !descriptors.empty()) {
+      ok = fwrite(&descriptors[0], sizeof(descriptors[0]), descriptors.size(),
+                  file) == descriptors.size();
+    }
+    uint64_t position =
+        sizeof(header) + descriptors.size() * sizeof(BinaryArchiveArray);
+    for (size_t i = 0; ok && i < descriptors.size(); ++i) {
+      ok = WritePadding(file, descriptors[i].offset - position);
+      const size_t data_size = DataSize(descriptors[i]);
+      if (ok && data_size) {
+        ok = fwrite(arrays_[i].data, 1, data_size, file) == data_size;
+      }
+      position = descriptors[i].offset + data_size;
+    }
+    if (ok) ok = WritePadding(file, header.size - position);
+    return fclose(file) == 0 && ok;
+  }
+
+ private:
+  /// @cond MATHFU_INTERNAL
+  struct Array {
+    BinaryArchiveArray descriptor;
+    const void* data;
+  };
+
+  static inline size_t DataSize(const BinaryArchiveArray& descriptor) {
+    return static_cast<size_t>(descriptor.count * descriptor.element_size);
+  }
+
+  static inline uint64_t Align(uint64_t offset) {
+    return (offset + kBinaryArchiveAlignment - 1) &
+           ~static_cast<uint64_t>(kBinaryArchiveAlignment - 1);
+  }
+
+  // Write less than kBinaryArchiveAlignment zero bytes.
+  static inline bool WritePadding(FILE* file, uint64_t size) {
+    static const uint8_t kZeros[kBinaryArchiveAlignment] = {0};
+    assert(size < kBinaryArchiveAlignment);
+    return size == 0 ||
+           fwrite(kZeros, 1, static_cast<size_t>(size), file) == size;
+  }
+
+  // Calculate the header and array descriptors, returning the archive size.
+  size_t Layout(BinaryArchiveHeader* header,
+                std::vector<BinaryArchiveArray>* descriptors) const {
+    uint64_t offset = sizeof(BinaryArchiveHeader) +
+                      arrays_.size() * sizeof(BinaryArchiveArray);
+    for (size_t i = 0; i < arrays_.size(); ++i) {
+      offset = Align(offset);
+      if (descriptors) {
+        descriptors->push_back(arrays_[i].descriptor);
+        descriptors->back().offset = offset;
+      }
+      offset += DataSize(arrays_[i].descriptor);
+    }
+    offset = Align(offset);
+    if (header) {
+      memcpy(header->magic, "MFBA", sizeof(header->magic));
+      header->byte_order = kBinaryArchiveByteOrder;
+      header->version = kBinaryArchiveVersion;
+      header->num_arrays = static_cast<uint32_t>(arrays_.size());
+      header->size = offset;
+      header->reserved = 0;
+    }
+    return static_cast<size_t>(offset);
+  }
+  /// @endcond
+
+  std::vector<Array> arrays_;
+};
+
+/// @class BinaryArchive "mathfu/binary_archive.h"
+/// @brief Provides access to the arrays in a binary archive.
+///
+/// The archive is either read from memory owned by the application or
+/// from a file mapped into memory by the archive.  Views returned by the
+/// archive are valid until it is closed or destroyed.
+class BinaryArchive {
+ public:
+  /// @brief Create an archive with no arrays.
+  BinaryArchive() : data_(NULL), size_(0), mapped_(false) {}
+
+  /// @brief Unmap the file if the archive was opened from a file.
+  ~BinaryArchive() { Close(); }
+
+  /// @brief Use an archive in memory.
+  ///
+  /// @param data Archive, which must be aligned to MATHFU_ALIGNMENT bytes
+  /// and remain valid while this object references it.
+  /// @param size Size of the data in bytes.
+  /// @return true if data contains a valid archive, false otherwise.
+  bool Initialize(const void* data, size_t size) {
+    Close();
+    if (!Validate(static_cast<const uint8_t*>(data), size)) return false;
+    data_ = static_cast<const uint8_t*>(data);
+    size_ = size;
+    return true;
+  }
+
+  /// @brief Map an archive file into memory.
+  ///
+  /// @param filename Name of the file.
+  /// @return true if the file was mapped and contains a valid archive, false
+  /// otherwise.
+  bool Open(const char* filename) {
+    Close();
+    const void* data;
+    size_t size;
+    if (!MapFile(filename, &data, &size)) return false;
+    if (!Validate(static_cast<const uint8_t*>(data), size)) {
+      UnmapFile(data, size);
+      return false;
+    }
+    data_ = static_cast<const uint8_t*>(data);
+    size_ = size;
+    mapped_ = true;
+    return true;
+  }
+
+  /// @brief Release the archive, invalidating all views of it.
+  void Close() {
+    if (mapped_) UnmapFile(data_, size_);
+    data_ = NULL;
+    size_ = 0;
+    mapped_ = false;
+  }
+
+  /// @return Number of arrays in the archive.
+  size_t num_arrays() const {
+    return data_ ? Header()->num_arrays : 0;
+  }
+
+  /// @brief Get the descriptor of an array.
+  ///
+  /// @param index Index of the array, must be less than num_arrays().
+  /// @return Descriptor of the array.
+  const BinaryArchiveArray& array(size_t index) const {
+    assert(index < num_arrays());
+    return Arrays()[index];
+  }
+
+  /// @brief Get a view of an array.
+  ///
+  /// @param index Index of the array.
+  /// @param view View which receives the array.
+  /// @return true if the array exists and contains elements of type T,
+  /// false otherwise.
+  template <class T>
+  bool GetArray(size_t index, BinaryArrayView<T>* view) const {
+    if (index >= num_arrays()) return false;
+    const BinaryArchiveArray& descriptor = Arrays()[index];
+    if (descriptor.type != BinaryArchiveType<T>::Tag() ||
+        descriptor.element_size != sizeof(T)) {
+      return false;
+    }
+    *view = BinaryArrayView<T>(
+        reinterpret_cast<const T*>(data_ + descriptor.offset),
+        static_cast<size_t>(descriptor.count));
+    return true;
+  }
+
+  /// @brief Get a view of the first array with an identifier.
+  ///
+  /// @param id Identifier of the array.
+  /// @param view View which receives the array.
+  /// @return true if the array exists and contains elements of type T,
+  /// false otherwise.
+  template <class T>
+  bool FindArray(uint32_t id, BinaryArrayView<T>* view) const {
+    const BinaryArchiveArray* const arrays = Arrays();
+    for (size_t i = 0; i < num_arrays(); ++i) {
+      if (arrays[i].id == id) return GetArray(i, view);
+    }
+    return false;
+  }
+
+ private:
+  /// @cond MATHFU_INTERNAL
+  // Archives own mapped files so can't be copied.
+  BinaryArchive(const BinaryArchive&);
+  BinaryArchive& operator=(const BinaryArchive&);
+
+  const BinaryArchiveHeader* Header() const {
+    return reinterpret_cast<const BinaryArchiveHeader*>(data_);
+  }
+
+  const BinaryArchiveArray* Arrays() const {
+    return reinterpret_cast<const BinaryArchiveArray*>(
+        data_ + sizeof(BinaryArchiveHeader));
+  }
+
+  static bool Validate(const uint8_t* data, size_t size) {
+    if (!data || reinterpret_cast<uintptr_t>(data) % MATHFU_ALIGNMENT != 0 ||
+        size < sizeof(BinaryArchiveHeader)) {
+      return false;
+    }
+    const BinaryArchiveHeader* const header =
+        reinterpret_cast<const BinaryArchiveHeader*>(data);
+    if (memcmp(header->magic, "MFBA", sizeof(header->magic)) != 0 ||
+        header->byte_order != kBinaryArchiveByteOrder ||
+        header->version != kBinaryArchiveVersion || header->size > size ||
+        header->size < sizeof(BinaryArchiveHeader) ||
+        header->num_arrays > (header->size - sizeof(BinaryArchiveHeader)) /
+                                 sizeof(BinaryArchiveArray)) {
+      return false;
+    }
+    const BinaryArchiveArray* const arrays =
+        reinterpret_cast<const BinaryArchiveArray*>(
+            data + sizeof(BinaryArchiveHeader));
+    for (uint32_t i = 0; i < header->num_arrays; ++i) {
+      const BinaryArchiveArray& array = arrays[i];
+      if (array.offset % kBinaryArchiveAlignment != 0 ||
+          array.offset > header->size || array.element_size == 0 ||
+          array.count > (header->size - array.offset) / array.element_size) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+#if defined(_WIN32)
+  static bool MapFile(const char* filename, const void** data, size_t* size) {
+    const HANDLE file =
+        CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER file_size;
+    HANDLE mapping = NULL;
+    *data = NULL;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0 &&
+        static_cast<uint64_t>(file_size.QuadPart) <= SIZE_MAX) {
+      mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    }
+    if (mapping) {
+      *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+      *size = static_cast<size_t>(file_size.QuadPart);
+      // The view keeps the file mapped after the handles are closed.
+      CloseHandle(mapping);
+    }
+    CloseHandle(file);
+    return *data != NULL;
+  }
+
+  static void UnmapFile(const void* data, size_t /*size*/) {
+    UnmapViewOfFile(data);
+  }
+#else
+  static bool MapFile(const char* filename, const void** data, size_t* size) {
+    const int file = open(filename, O_RDONLY);
+    if (file < 0) return false;
+    struct stat status;
+    void* mapping = MAP_FAILED;
+    if (fstat(file, &status) == 0 && status.st_size > 0 &&
+        static_cast<uint64_t>(status.st_size) <= SIZE_MAX) {
+      *size = static_cast<size_t>(status.st_size);
+      mapping = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, file, 0);
+    }
+    // The mapping keeps the file open after the descriptor is closed.
+    close(file);
+    if (mapping == MAP_FAILED) return false;
+    *data = mapping;
+    return true;
+  }
+
+  static void UnmapFile(const void* data, size_t size) {
+    munmap(const_cast<void*>(data), size);
+  }
+#endif  // defined(_WIN32)
+  /// @endcond
+
+  const uint8_t* data_;
+  size_t size_;
+  bool mapped_;
+};
+/// @}
+
+}  // namespace mathfu
+
+#endif  // MATHFU_BINARY_ARCHIVE_H_
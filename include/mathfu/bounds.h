@@ -0,0 +1,363 @@
+/*
+* Copyright 2016 Google Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef MATHFU_BOUNDS_H_
+#define MATHFU_BOUNDS_H_
+
+#include "mathfu/matrix.h"
+#include "mathfu/svd.h"
+#include "mathfu/utilities.h"
+#include "mathfu/vector.h"
+
+#include <stddef.h>
+#include <cmath>
+#include <limits>
+
+/// @file mathfu/bounds.h
+/// @brief Oriented bounding boxes, view frustums and point set statistics.
+
+namespace mathfu {
+
+/// @cond MATHFU_INTERNAL
+// Whether any element of a is greater than the corresponding element of b.
+template <class T>
+inline bool AnyGreater(const Vector<T, 3>& a, const Vector<T, 3>& b) {
+  return a[0] > b[0] || a[1] > b[1] || a[2] > b[2];
+}
+
+template <class T>
+inline Vector<T, 3> AbsVector(const Vector<T, 3>& v) {
+  return Vector<T, 3>::Max(v, -v);
+}
+
+template <class T>
+inline Vector<T, 3> MatrixRow(const Matrix<T, 3>& m, int row) {
+  return Vector<T, 3>(m(row, 0), m(row, 1), m(row, 2));
+}
+/// @endcond
+
+/// @addtogroup mathfu_matrix
+/// @{
+
+/// @class CovarianceAccumulator "mathfu/bounds.h"
+/// @brief Calculates the mean and covariance of a stream of points.
+///
+/// Points are accumulated relative to the first point added using a
+/// numerically stable update, so the mean and covariance of large point sets
+/// far from the origin remain accurate.
+/// Point sets can be split into chunks which are accumulated independently,
+/// for example on separate threads, then combined with Merge().
+///
+/// @tparam T type of each element, float or double.
+template <class T>
+class CovarianceAccumulator {
+ public:
+  /// Number of points which Add(const Vector<T, 3>*, size_t) processes in
+  /// each pass.
+  static const size_t kChunkSize = 1024;
+
+  /// @brief Create an accumulator which contains no points.
+  CovarianceAccumulator()
+      : shift_(static_cast<T>(0)),
+        mean_(static_cast<T>(0)),
+        scatter_(static_cast<T>(0)),
+        count_(0) {}
+
+  /// @brief Add a point.
+  ///
+  /// @param point Point to add.
+  inline void Add(const Vector<T, 3>& point) {
+    if (count_ == 0) shift_ = point;
+    ++count_;
+    const Vector<T, 3> offset = point - shift_;
+    const Vector<T, 3> delta = offset - mean_;
+    mean_ += delta / static_cast<T>(count_);
+    scatter_ += Matrix<T, 3>::OuterProduct(delta, offset - mean_);
+  }
+
+  /// @brief Add an array of points.
+  ///
+  /// The points are processed in chunks of kChunkSize.  The mean of each
+  /// chunk is calculated first so the scatter of the chunk is accumulated
+  /// in a second pass with Vector operations, then the chunk is merged into
+  /// this object.
+  ///
+  /// @param points Array of count points to add.
+  /// @param count Number of points.
+  inline void Add(const Vector<T, 3>* points, size_t count) {
+    for (size_t i = 0; i < count; i += kChunkSize) {
+      const size_t chunk_count =
+          count - i < kChunkSize ? count - i : kChunkSize;
+      const Vector<T, 3>* const chunk_points = &points[i];
+      CovarianceAccumulator chunk;
+      chunk.shift_ = chunk_points[0];
+      chunk.count_ = chunk_count;
+      Vector<T, 3> sum(static_cast<T>(0));
+      for (size_t j = 1; j < chunk_count; ++j) {
+        sum += chunk_points[j] - chunk.shift_;
+      }
+      chunk.mean_ = sum / static_cast<T>(chunk_count);
+      const Vector<T, 3> mean = chunk.shift_ + chunk.mean_;
+      Vector<T, 3> column0(static_cast<T>(0));
+      Vector<T, 3> column1(static_cast<T>(0));
+      Vector<T, 3> column2(static_cast<T>(0));
+      for (size_t j = 0; j < chunk_count; ++j) {
+        const Vector<T, 3> delta = chunk_points[j] - mean;
+        column0 += delta * delta[0];
+        column1 += delta * delta[1];
+        column2 += delta * delta[2];
+      }
+      chunk.scatter_.GetColumn(0) = column0;
+      chunk.scatter_.GetColumn(1) = column1;
+      chunk.scatter_.GetColumn(2) = column2;
+      Merge(chunk);
+    }
+  }
+
+  /// @brief Add all points accumulated by another object.
+  ///
+  /// @param other Accumulator to merge into this object.
+  inline void Merge(const CovarianceAccumulator& other) {
+    if (other.count_ == 0) return;
+    if (count_ == 0) {
+      *this = other;
+      return;
+    }
+    const size_t count = count_ + other.count_;
+    const Vector<T, 3> delta = (other.shift_ - shift_) + other.mean_ - mean_;
+    const T other_weight =
+        static_cast<T>(other.count_) / static_cast<T>(count);
+    mean_ += delta * other_weight;
+    scatter_ += other.scatter_ +
+                Matrix<T, 3>::OuterProduct(delta, delta) *
+                    (static_cast<T>(count_) * other_weight);
+    count_ = count;
+  }
+
+  /// @return Number of points added.
+  inline size_t count() const { return count_; }
+
+  /// @return Mean of the points added.
+  inline Vector<T, 3> mean() const { return shift_ + mean_; }
+
+  /// @return Covariance Matrix of the points added, or zero if no points
+  /// have been added.
+  inline Matrix<T, 3> covariance() const {
+    return count_ ? scatter_ / static_cast<T>(count_)
+                  : Matrix<T, 3>(static_cast<T>(0));
+  }
+
+  MATHFU_DEFINE_CLASS_SIMD_AWARE_NEW_DELETE
+
+ private:
+  // First point added, which all other points are accumulated relative to.
+  Vector<T, 3> shift_;
+  // Mean of the points relative to shift_.
+  Vector<T, 3> mean_;
+  // Sum of the outer products of the offsets of each point from the mean.
+  Matrix<T, 3> scatter_;
+  size_t count_;
+};
+
+template <class T>
+const size_t CovarianceAccumulator<T>::kChunkSize;
+
+/// @class Frustum "mathfu/bounds.h"
+/// @brief View frustum represented by 6 planes.
+///
+/// @tparam T type of each element, float or double.
+template <class T>
+struct Frustum {
+  /// @brief Extract the frustum of a projection Matrix.
+  ///
+  /// @param clip_from_world Matrix which transforms points into clip space,
+  /// where visible points satisfy -w <= x, y, z <= w, for example
+  /// <code>projection * view</code>.
+  /// @return Frustum of the matrix.
+  static inline Frustum FromMatrix(const Matrix<T, 4>& clip_from_world) {
+    const Matrix<T, 4> m = clip_from_world.Transpose();
+    const Vector<T, 4>& w = m.GetColumn(3);
+    Frustum frustum;
+    for (int i = 0; i < 3; ++i) {
+      frustum.planes[i * 2] = w + m.GetColumn(i);
+      frustum.planes[i * 2 + 1] = w - m.GetColumn(i);
+    }
+    for (int i = 0; i < 6; ++i) {
+      frustum.planes[i] /= frustum.planes[i].xyz().Length();
+    }
+    return frustum;
+  }
+
+  /// Planes in the order left, right, bottom, top, near and far.  The
+  /// normal of each plane (x, y, z) points into the frustum and points p
+  /// inside the frustum satisfy <code>dot(normal, p) + w >= 0</code>.
+  Vector<T, 4> planes[6];
+
+  MATHFU_DEFINE_CLASS_SIMD_AWARE_NEW_DELETE
+};
+
+/// @class OrientedBox "mathfu/bounds.h"
+/// @brief Box with an arbitrary orientation.
+///
+/// Oriented boxes usually bound objects much more tightly than axis aligned
+/// boxes, which reduces the number of false positives when culling and in
+/// collision detection.
+///
+/// @tparam T type of each element, float or double.
+template <class T>
+struct OrientedBox {
+  /// @brief Create an empty box at the origin.
+  OrientedBox()
+      : center(static_cast<T>(0)),
+        axes(Matrix<T, 3>::Identity()),
+        extents(static_cast<T>(0)) {}
+
+  /// @brief Create a box.
+  ///
+  /// @param center Center of the box.
+  /// @param axes Rotation Matrix whose columns are the axes of the box.
+  /// @param extents Half the size of the box along each axis.
+  OrientedBox(const Vector<T, 3>& center, const Matrix<T, 3>& axes,
+              const Vector<T, 3>& extents)
+      : center(center), axes(axes), extents(extents) {}
+
+  /// @brief Fit a box to a set of points.
+  ///
+  /// The axes of the box are the principal axes of the points, which are
+  /// the eigenvectors of their covariance.
+  ///
+  /// @param points Array of count points to bound.
+  /// @param count Number of points.
+  /// @return Box which contains every point.
+  static inline OrientedBox FromPoints(const Vector<T, 3>* points,
+                                       size_t count) {
+    if (count == 0) return OrientedBox();
+    CovarianceAccumulator<T> accumulator;
+    accumulator.Add(points, count);
+    Vector<T, 3> eigenvalues;
+    Matrix<T, 3> eigenvectors;
+    EigenDecompose(accumulator.covariance(), &eigenvalues, &eigenvectors);
+    return FromAxes(eigenvectors, points, count);
+  }
+
+  /// @brief Fit a box with the specified axes to a set of points.
+  ///
+  /// @param axes Rotation Matrix whose columns are the axes of the box.
+  /// @param points Array of count points to bound, which must not be empty.
+  /// @param count Number of points.
+  /// @return Box which contains every point.
+  static inline OrientedBox FromAxes(const Matrix<T, 3>& axes,
+                                     const Vector<T, 3>* points,
+                                     size_t count) {
+    const Matrix<T, 3> local_from_world = axes.Transpose();
+    Vector<T, 3> lower = local_from_world * points[0];
+    Vector<T, 3> upper = lower;
+    for (size_t i = 1; i < count; ++i) {
+      const Vector<T, 3> local = local_from_world * points[i];
+      lower = Vector<T, 3>::Min(lower, local);
+      upper = Vector<T, 3>::Max(upper, local);
+    }
+    const T half = static_cast<T>(0.5);
+    return OrientedBox(axes * ((lower + upper) * half), axes,
+                       (upper - lower) * half);
+  }
+
+  /// @brief Determine whether this box intersects another box.
+  ///
+  /// This tests the 15 potential separating axes of the boxes.  The tests
+  /// for each group of 3 axes are evaluated with Vector operations.
+  ///
+  /// @param other Box to test.
+  /// @return true if the boxes intersect.
+  inline bool Intersects(const OrientedBox& other) const {
+    // Work in the frame of this box.  r(i, j) is the cosine of the angle
+    // between axis i of this box and axis j of the other box.  The epsilon
+    // prevents false separation along the cross product of parallel axes.
+    const Matrix<T, 3> local_from_world = axes.Transpose();
+    const Matrix<T, 3> r = local_from_world * other.axes;
+    const T epsilon = std::numeric_limits<T>::epsilon() * 16;
+    Matrix<T, 3> abs_r;
+    for (int i = 0; i < 3; ++i) {
+      abs_r.GetColumn(i) =
+          AbsVector(r.GetColumn(i)) + Vector<T, 3>(epsilon);
+    }
+    const Vector<T, 3> t = local_from_world * (other.center - center);
+
+    // Axes of this box.
+    if (AnyGreater(AbsVector(t), extents + abs_r * other.extents)) {
+      return false;
+    }
+    // Axes of the other box.
+    if (AnyGreater(AbsVector(r.Transpose() * t),
+                   abs_r.Transpose() * extents + other.extents)) {
+      return false;
+    }
+    // Cross products of axis i of this box with each axis of the other box.
+    const Vector<T, 3>& e = other.extents;
+    const Vector<T, 3> e_yzx(e[1], e[2], e[0]);
+    const Vector<T, 3> e_zxy(e[2], e[0], e[1]);
+    for (int i = 0; i < 3; ++i) {
+      const int i1 = (i + 1) % 3;
+      const int i2 = (i + 2) % 3;
+      const Vector<T, 3> abs_row = MatrixRow(abs_r, i);
+      const Vector<T, 3> abs_row_yzx(abs_row[1], abs_row[2], abs_row[0]);
+      const Vector<T, 3> abs_row_zxy(abs_row[2], abs_row[0], abs_row[1]);
+      const Vector<T, 3> radius =
+          MatrixRow(abs_r, i2) * extents[i1] +
+          MatrixRow(abs_r, i1) * extents[i2] + e_yzx * abs_row_zxy +
+          e_zxy * abs_row_yzx;
+      const Vector<T, 3> distance =
+          MatrixRow(r, i1) * t[i2] - MatrixRow(r, i2) * t[i1];
+      if (AnyGreater(AbsVector(distance), radius)) return false;
+    }
+    return true;
+  }
+
+  /// @brief Determine whether this box intersects a view frustum.
+  ///
+  /// The box is tested against each plane of the frustum, so boxes which are
+  /// outside the frustum but intersect more than one plane near a corner
+  /// are conservatively reported as intersecting.
+  ///
+  /// @param frustum Frustum to test.
+  /// @return false if the box is entirely outside the frustum.
+  inline bool Intersects(const Frustum<T>& frustum) const {
+    const Matrix<T, 3> local_from_world = axes.Transpose();
+    for (int i = 0; i < 6; ++i) {
+      const Vector<T, 4>& plane = frustum.planes[i];
+      const Vector<T, 3> normal = plane.xyz();
+      const T radius = Vector<T, 3>::DotProduct(
+          extents, AbsVector(local_from_world * normal));
+      if (Vector<T, 3>::DotProduct(normal, center) + plane[3] < -radius) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Center of the box.
+  Vector<T, 3> center;
+  /// Rotation Matrix whose columns are the axes of the box.
+  Matrix<T, 3> axes;
+  /// Half the size of the box along each axis.
+  Vector<T, 3> extents;
+
+  MATHFU_DEFINE_CLASS_SIMD_AWARE_NEW_DELETE
+};
+/// @}
+
+}  // namespace mathfu
+
+#endif  // MATHFU_BOUNDS_H_
@@ -0,0 +1,241 @@
+/*
+* Copyright 2016 Google Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef MATHFU_HALF_H_
+#define MATHFU_HALF_H_
+
+#include "mathfu/utilities.h"
+#include "mathfu/vector.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(MATHFU_COMPILE_WITH_SIMD) && defined(__F16C__)
+#include <immintrin.h>
+/// @cond MATHFU_INTERNAL
+#define MATHFU_HALF_F16C
+/// @endcond
+#endif  // defined(MATHFU_COMPILE_WITH_SIMD) && defined(__F16C__)
+
+/// @file mathfu/half.h
+/// @brief Half precision (IEEE 754 binary16) storage and conversion.
+///
+/// Half precision values are stored as 16-bit unsigned integers.  Conversions
+/// use the F16C instructions when they are enabled by the compiler options,
+/// otherwise a scalar implementation which produces identical results
+/// (including infinities, NaNs and denormals) is used.  Conversion to half
+/// precision rounds to the nearest representable value, ties to even.
+
+namespace mathfu {
+
+/// @addtogroup mathfu_vector
+/// @{
+
+/// @brief Convert a float to half precision.
+///
+/// @param value Value to convert.  Values too large for half precision are
+/// converted to infinity.
+/// @return Half precision representation of value.
+inline uint16_t FloatToHalf(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  const uint32_t sign = (bits >> 16) & 0x8000U;
+  bits &= 0x7FFFFFFFU;
+  uint32_t half;
+  if (bits >= 0x47800000U) {
+    // Infinity, NaN (keeping the upper bits of the payload and setting the
+    // quiet bit) or a value which overflows to infinity.
+    half = bits > 0x7F800000U ? 0x7E00U | ((bits >> 13) & 0x3FFU) : 0x7C00U;
+  } else if (bits < 0x38800000U) {
+    // Denormal or zero.  Adding 0.5 aligns the mantissa so the float unit
+    // rounds it to nearest even.
+    float magnitude;
+    memcpy(&magnitude, &bits, sizeof(magnitude));
+    magnitude += 0.5f;
+    memcpy(&half, &magnitude, sizeof(half));
+    half -= 0x3F000000U;
+  } else {
+    // Normal, rebias the exponent and round to nearest even.
+    const uint32_t odd = (bits >> 13) & 1U;
+    half = (bits + 0xC8000FFFU + odd) >> 13;
+  }
+  return static_cast<uint16_t>(half | sign);
+}
+
+/// @brief Convert a half precision value to a float.
+///
+/// @param half Half precision value to convert.
+/// @return Float with the same value, which is exact for every input except
+/// signaling NaNs which are converted to quiet NaNs.
+inline float HalfToFloat(uint16_t half) {
+  const uint32_t exponent = half & 0x7C00U;
+  uint32_t bits = static_cast<uint32_t>(half & 0x7FFFU) << 13;
+  float value;
+  if (exponent == 0x7C00U) {
+    // Infinity or NaN.
+    bits |= 0x7F800000U;
+    if (bits != 0x7F800000U) bits |= 0x400000U;
+  } else if (exponent == 0) {
+    // Denormal or zero, scale the mantissa by 2^-24 using the float unit.
+    bits += 0x38800000U;
+    memcpy(&value, &bits, sizeof(value));
+    value -= 6.103515625e-05f;  // 2^-14
+    memcpy(&bits, &value, sizeof(bits));
+  } else {
+    bits += 0x38000000U;
+  }
+  bits |= static_cast<uint32_t>(half & 0x8000U) << 16;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/// @brief Convert an array of floats to half precision.
+///
+/// @param values Array of count values to convert.
+/// @param count Number of values.
+/// @param halfs Array of count elements which receives the result.
+inline void FloatToHalf(const float* values, size_t count, uint16_t* halfs) {
+  size_t i = 0;
+#ifdef MATHFU_HALF_F16C
+  for (; i + 8 <= count; i += 8) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&halfs[i]),
+                     _mm256_cvtps_ph(_mm256_loadu_ps(&values[i]),
+                                     _MM_FROUND_TO_NEAREST_INT));
+  }
+#endif  // MATHFU_HALF_F16C
+  for (; i < count; ++i) halfs[i] = FloatToHalf(values[i]);
+}
+
+/// @brief Convert an array of half precision values to floats.
+///
+/// @param halfs Array of count values to convert.
+/// @param count Number of values.
+/// @param values Array of count elements which receives the result.
+inline void HalfToFloat(const uint16_t* halfs, size_t count, float* values) {
+  size_t i = 0;
+#ifdef MATHFU_HALF_F16C
+  for (; i + 8 <= count; i += 8) {
+    _mm256_storeu_ps(&values[i],
+                     _mm256_cvtph_ps(_mm_loadu_si128(
+                         reinterpret_cast<const __m128i*>(&halfs[i]))));
+  }
+#endif  // MATHFU_HALF_F16C
+  for (; i < count; ++i) values[i] = HalfToFloat(halfs[i]);
+}
+
+/// @class VectorPackedHalf "mathfu/half.h"
+/// @brief Packed N-dimensional vector of half precision values.
+///
+/// Like VectorPacked this can be used to store data in flat arrays, for
+/// example vertex buffers, using half the memory of 32-bit floats.
+///
+/// @tparam Dims dimensions (number of elements) in the structure.
+template <int Dims>
+struct VectorPackedHalf {
+  /// Create an uninitialized VectorPackedHalf.
+  VectorPackedHalf() {}
+
+  /// Create a VectorPackedHalf from a Vector.
+  ///
+  /// @param vector Vector to convert to half precision.
+  explicit VectorPackedHalf(const Vector<float, Dims>& vector) {
+    for (int i = 0; i < Dims; ++i) data_[i] = FloatToHalf(vector[i]);
+  }
+
+  /// Copy a Vector to a VectorPackedHalf.
+  ///
+  /// @param vector Vector to convert to half precision.
+  /// @returns A reference to this VectorPackedHalf.
+  VectorPackedHalf& operator=(const Vector<float, Dims>& vector) {
+    *this = VectorPackedHalf(vector);
+    return *this;
+  }
+
+  /// Convert this object to a Vector.
+  ///
+  /// @return Vector containing the values of this object.
+  Vector<float, Dims> Unpack() const {
+    Vector<float, Dims> vector;
+    for (int i = 0; i < Dims; ++i) vector[i] = HalfToFloat(data_[i]);
+    return vector;
+  }
+
+  /// Elements of the packed vector one per dimension.
+  uint16_t data_[Dims];
+};
+
+/// @brief Convert an array of Vectors to half precision.
+///
+/// @param vectors Array of count vectors to convert.
+/// @param count Number of vectors.
+/// @param packed Array of count elements which receives the result.
+template <int Dims>
+inline void PackHalf(const Vector<float, Dims>* vectors, size_t count,
+                     VectorPackedHalf<Dims>* packed) {
+  size_t i = 0;
+#ifdef MATHFU_HALF_F16C
+  if (Dims <= 4) {
+    // Convert two vectors per instruction.
+    for (; i + 2 <= count; i += 2) {
+      float floats[8] = {0};
+      for (int j = 0; j < Dims; ++j) {
+        floats[j] = vectors[i][j];
+        floats[j + 4] = vectors[i + 1][j];
+      }
+      uint16_t halfs[8];
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(halfs),
+                       _mm256_cvtps_ph(_mm256_loadu_ps(floats),
+                                       _MM_FROUND_TO_NEAREST_INT));
+      memcpy(packed[i].data_, halfs, sizeof(packed[i].data_));
+      memcpy(packed[i + 1].data_, &halfs[4], sizeof(packed[i].data_));
+    }
+  }
+#endif  // MATHFU_HALF_F16C
+  for (; i < count; ++i) packed[i] = VectorPackedHalf<Dims>(vectors[i]);
+}
+
+/// @brief Convert an array of half precision vectors to Vectors.
+///
+/// @param packed Array of count vectors to convert.
+/// @param count Number of vectors.
+/// @param vectors Array of count elements which receives the result.
+template <int Dims>
+inline void UnpackHalf(const VectorPackedHalf<Dims>* packed, size_t count,
+                       Vector<float, Dims>* vectors) {
+  size_t i = 0;
+#ifdef MATHFU_HALF_F16C
+  if (Dims <= 4) {
+    for (; i + 2 <= count; i += 2) {
+      uint16_t halfs[8] = {0};
+      memcpy(halfs, packed[i].data_, sizeof(packed[i].data_));
+      memcpy(&halfs[4], packed[i + 1].data_, sizeof(packed[i].data_));
+      float floats[8];
+      _mm256_storeu_ps(floats, _mm256_cvtph_ps(_mm_loadu_si128(
+                                   reinterpret_cast<const __m128i*>(halfs))));
+      for (int j = 0; j < Dims; ++j) {
+        vectors[i][j] = floats[j];
+        vectors[i + 1][j] = floats[j + 4];
+      }
+    }
+  }
+#endif  // MATHFU_HALF_F16C
+  for (; i < count; ++i) vectors[i] = packed[i].Unpack();
+}
+/// @}
+
+}  // namespace mathfu
+
+#endif  // MATHFU_HALF_H_
@@ -16,6 +16,7 @@
 #ifndef MATHFU_HLSL_MAPPINGS_H_
 #define MATHFU_HLSL_MAPPINGS_H_
 
+#include "mathfu/half.h"
 #include "mathfu/matrix.h"
 #include "mathfu/quaternion.h"
 #include "mathfu/vector.h"
@@ -41,6 +42,13 @@ typedef unsigned int   uint;
 typedef unsigned int   dword;
 typedef unsigned short half;
 
+/// 2-dimensional packed <code>half</code> vector.
+typedef VectorPackedHalf<2> half2;
+/// 3-dimensional packed <code>half</code> vector.
+typedef VectorPackedHalf<3> half3;
+/// 4-dimensional packed <code>half</code> vector.
+typedef VectorPackedHalf<4> half4;
+
 /// 2-dimensional <code>float</code> Vector.
 typedef Vector<float, 2> float2;
 /// 3-dimensional <code>float</code> Vector.
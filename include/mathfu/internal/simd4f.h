@@ -0,0 +1,153 @@
+/*
+* Copyright 2016 Google Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef MATHFU_INTERNAL_SIMD4F_H_
+#define MATHFU_INTERNAL_SIMD4F_H_
+
+#include "mathfu/utilities.h"
+
+/// @file mathfu/internal/simd4f.h SIMD backend.
+/// @brief Selects the implementation of the 4 element float SIMD type
+/// <code>simd4f</code> and the <code>simd4f_*</code> functions used by the
+/// SIMD specializations of mathfu::Vector.
+///
+/// By default these are provided by [vectorial][].  When
+/// @ref MATHFU_COMPILE_WITH_VECTOR_EXTENSIONS is defined they are
+/// implemented here using GCC / Clang vector extensions, which removes the
+/// dependency on vectorial and allows the compiler to select instructions,
+/// such as FMA, for the target.
+///
+/// Only the float Vector operations, and functions built on them such as the
+/// float array functions of mathfu/array_ops.h, use this layer.  The other
+/// SIMD code paths use SSE2 intrinsics directly (see
+/// MATHFU_COMPILE_WITH_SSE2) so they are only vectorized on x86, whichever
+/// backend is selected.
+///
+///   [vectorial]: http://github.com/scoopr/vectorial
+
+#ifdef MATHFU_COMPILE_WITH_SIMD
+#ifdef MATHFU_COMPILE_WITH_VECTOR_EXTENSIONS
+
+#include <math.h>
+#include <string.h>
+
+/// @cond MATHFU_INTERNAL
+// The names and semantics of the types and functions match the subset of
+// vectorial's API used by MathFu.  On x86 simd4f converts implicitly to and
+// from __m128.
+typedef float simd4f __attribute__((vector_size(16)));
+typedef int simd4f_mask __attribute__((vector_size(16)));
+
+static inline simd4f simd4f_create(float x, float y, float z, float w) {
+  const simd4f v = {x, y, z, w};
+  return v;
+}
+
+static inline simd4f simd4f_zero() { return simd4f_create(0, 0, 0, 0); }
+
+static inline simd4f simd4f_splat(float s) {
+  return simd4f_create(s, s, s, s);
+}
+
+static inline simd4f simd4f_uload4(const float* p) {
+  simd4f v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline simd4f simd4f_uload3(const float* p) {
+  return simd4f_create(p[0], p[1], p[2], 0);
+}
+
+static inline void simd4f_ustore4(const simd4f v, float* p) {
+  memcpy(p, &v, sizeof(v));
+}
+
+static inline void simd4f_ustore3(const simd4f v, float* p) {
+  memcpy(p, &v, sizeof(float) * 3);
+}
+
+static inline float simd4f_get_x(const simd4f v) { return v[0]; }
+
+static inline simd4f simd4f_add(const simd4f a, const simd4f b) {
+  return a + b;
+}
+
+static inline simd4f simd4f_sub(const simd4f a, const simd4f b) {
+  return a - b;
+}
+
+static inline simd4f simd4f_mul(const simd4f a, const simd4f b) {
+  return a * b;
+}
+
+static inline simd4f simd4f_div(const simd4f a, const simd4f b) {
+  return a / b;
+}
+
+// Select elements of a where mask is set and b otherwise.
+static inline simd4f simd4f_select(const simd4f_mask mask, const simd4f a,
+                                   const simd4f b) {
+  return reinterpret_cast<simd4f>(
+      (reinterpret_cast<simd4f_mask>(a) & mask) |
+      (reinterpret_cast<simd4f_mask>(b) & ~mask));
+}
+
+static inline simd4f simd4f_min(const simd4f a, const simd4f b) {
+  return simd4f_select(a < b, a, b);
+}
+
+static inline simd4f simd4f_max(const simd4f a, const simd4f b) {
+  return simd4f_select(a > b, a, b);
+}
+
+static inline float simd4f_dot3_scalar(const simd4f a, const simd4f b) {
+  const simd4f p = a * b;
+  return p[0] + p[1] + p[2];
+}
+
+static inline simd4f simd4f_dot4(const simd4f a, const simd4f b) {
+  const simd4f p = a * b;
+  return simd4f_splat((p[0] + p[1]) + (p[2] + p[3]));
+}
+
+static inline simd4f simd4f_length3(const simd4f v) {
+  return simd4f_splat(sqrtf(simd4f_dot3_scalar(v, v)));
+}
+
+static inline simd4f simd4f_length4(const simd4f v) {
+  return simd4f_splat(sqrtf(simd4f_get_x(simd4f_dot4(v, v))));
+}
+
+static inline simd4f simd4f_normalize3(const simd4f v) {
+  return v * simd4f_splat(1.0f / sqrtf(simd4f_dot3_scalar(v, v)));
+}
+
+static inline simd4f simd4f_normalize4(const simd4f v) {
+  return v * simd4f_splat(1.0f / sqrtf(simd4f_get_x(simd4f_dot4(v, v))));
+}
+
+static inline simd4f simd4f_cross3(const simd4f a, const simd4f b) {
+  return simd4f_create(a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2],
+                       a[0] * b[1] - a[1] * b[0], 0);
+}
+/// @endcond
+
+#else
+#include "vectorial/simd4f.h"
+#endif  // MATHFU_COMPILE_WITH_VECTOR_EXTENSIONS
+#endif  // MATHFU_COMPILE_WITH_SIMD
+
+#endif  // MATHFU_INTERNAL_SIMD4F_H_
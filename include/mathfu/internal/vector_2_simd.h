@@ -26,13 +26,15 @@
 /// builds.
 /// @see mathfu::Vector
 
-#if !defined(MATHFU_COMPILE_WITHOUT_SIMD_SUPPORT) && defined(__ARM_NEON__)
+#if !defined(MATHFU_COMPILE_WITHOUT_SIMD_SUPPORT) && defined(__ARM_NEON__) && \
+    !defined(MATHFU_COMPILE_WITH_VECTOR_EXTENSIONS)
 #include <vectorial/simd2f.h>
 #endif
 
 namespace mathfu {
 
-#if !defined(MATHFU_COMPILE_WITHOUT_SIMD_SUPPORT) && defined(__ARM_NEON__)
+#if !defined(MATHFU_COMPILE_WITHOUT_SIMD_SUPPORT) && defined(__ARM_NEON__) && \
+    !defined(MATHFU_COMPILE_WITH_VECTOR_EXTENSIONS)
 /// @cond MATHFU_INTERNAL
 template <>
 class Vector<float, 2> {
@@ -177,6 +179,22 @@ class Vector<float, 2> {
     return Vector<float, 2>(simd2f_normalize2(simd2));
   }
 
+  inline float LengthFast() const { return LengthFastHelper(*this); }
+
+  inline float NormalizeFast() { return NormalizeFastHelper(*this); }
+
+  inline Vector<float, 2> NormalizedFast() const {
+    return NormalizedFastHelper(*this);
+  }
+
+  inline float Sum() const { return SumHelper(*this); }
+
+  inline float Product() const { return ProductHelper(*this); }
+
+  inline float MinComponent() const { return MinComponentHelper(*this); }
+
+  inline float MaxComponent() const { return MaxComponentHelper(*this); }
+
   template <typename CompatibleT>
   static inline Vector<float, 2> FromType(const CompatibleT& compatible) {
     return FromTypeHelper<float, 2, CompatibleT>(compatible);
@@ -261,7 +279,8 @@ class Vector<float, 2> {
 };
 /// @endcond
 #endif  // !defined(MATHFU_COMPILE_WITHOUT_SIMD_SUPPORT) &&
-        // defined(__ARM_NEON__)
+        // defined(__ARM_NEON__) &&
+        // !defined(MATHFU_COMPILE_WITH_VECTOR_EXTENSIONS)
 
 }  // namespace mathfu
 
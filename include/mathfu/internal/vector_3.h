@@ -82,6 +82,22 @@ class Vector<T, 3> {
 
   inline Vector<T, 3> Normalized() const { return NormalizedHelper(*this); }
 
+  inline T LengthFast() const { return LengthFastHelper(*this); }
+
+  inline T NormalizeFast() { return NormalizeFastHelper(*this); }
+
+  inline Vector<T, 3> NormalizedFast() const {
+    return NormalizedFastHelper(*this);
+  }
+
+  inline T Sum() const { return SumHelper(*this); }
+
+  inline T Product() const { return ProductHelper(*this); }
+
+  inline T MinComponent() const { return MinComponentHelper(*this); }
+
+  inline T MaxComponent() const { return MaxComponentHelper(*this); }
+
   template <typename CompatibleT>
   static inline Vector<T, 3> FromType(const CompatibleT& compatible) {
     return FromTypeHelper<T, Dims, CompatibleT>(compatible);
@@ -16,15 +16,12 @@
 #ifndef MATHFU_VECTOR_3_SIMD_H_
 #define MATHFU_VECTOR_3_SIMD_H_
 
+#include "mathfu/internal/simd4f.h"
 #include "mathfu/internal/vector_3.h"
 #include "mathfu/utilities.h"
 
 #include <math.h>
 
-#ifdef MATHFU_COMPILE_WITH_SIMD
-#include "vectorial/simd4f.h"
-#endif
-
 /// @file mathfu/internal/vector_3_simd.h MathFu Vector<T, 3> Specialization
 /// @brief 3-dimensional specialization of mathfu::Vector for SIMD optimized
 /// builds.
@@ -78,8 +75,12 @@ class Vector<float, 3> {
   }
 
   explicit inline Vector(const Vector<int, 3>& v) {
+#ifdef MATHFU_COMPILE_WITH_SSE2
+    MATHFU_VECTOR3_STORE3(_mm_cvtepi32_ps(LoadIntVector(v)), *this)
+#else
     MATHFU_VECTOR3_INIT3(*this, static_cast<float>(v[0]),
                          static_cast<float>(v[1]), static_cast<float>(v[2]))
+#endif  // MATHFU_COMPILE_WITH_SSE2
   }
 
   inline Vector(const simd4f& v) { MATHFU_VECTOR3_STORE3(v, *this) }
@@ -268,6 +269,22 @@ class Vector<float, 3> {
     return Vector<float, 3>(simd4f_normalize3(MATHFU_VECTOR3_LOAD3(*this)));
   }
 
+  inline float LengthFast() const { return LengthFastHelper(*this); }
+
+  inline float NormalizeFast() { return NormalizeFastHelper(*this); }
+
+  inline Vector<float, 3> NormalizedFast() const {
+    return NormalizedFastHelper(*this);
+  }
+
+  inline float Sum() const { return SumHelper(*this); }
+
+  inline float Product() const { return ProductHelper(*this); }
+
+  inline float MinComponent() const { return MinComponentHelper(*this); }
+
+  inline float MaxComponent() const { return MaxComponentHelper(*this); }
+
   template <typename CompatibleT>
   static inline Vector<float, 3> FromType(const CompatibleT& compatible) {
     return FromTypeHelper<float, 3, CompatibleT>(compatible);
@@ -373,6 +390,15 @@ class Vector<float, 3> {
   };
 #include "mathfu/internal/disable_warnings_end.h"
 };
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+// Convert to integers, truncating towards zero like static_cast<int>().
+template <>
+template <>
+inline Vector<int, 3>::Vector(const Vector<float, 3>& v) {
+  StoreIntVector(_mm_cvttps_epi32(MATHFU_VECTOR3_LOAD3(v)), this);
+}
+#endif  // MATHFU_COMPILE_WITH_SSE2
 /// @endcond
 #endif  // MATHFU_COMPILE_WITH_SIMD
 
@@ -92,6 +92,22 @@ class Vector<T, 4> {
 
   inline Vector<T, 4> Normalized() const { return NormalizedHelper(*this); }
 
+  inline T LengthFast() const { return LengthFastHelper(*this); }
+
+  inline T NormalizeFast() { return NormalizeFastHelper(*this); }
+
+  inline Vector<T, 4> NormalizedFast() const {
+    return NormalizedFastHelper(*this);
+  }
+
+  inline T Sum() const { return SumHelper(*this); }
+
+  inline T Product() const { return ProductHelper(*this); }
+
+  inline T MinComponent() const { return MinComponentHelper(*this); }
+
+  inline T MaxComponent() const { return MaxComponentHelper(*this); }
+
   template <typename CompatibleT>
   static inline Vector<T, 4> FromType(const CompatibleT& compatible) {
     return FromTypeHelper<T, Dims, CompatibleT>(compatible);
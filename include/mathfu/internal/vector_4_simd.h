@@ -16,14 +16,15 @@
 #ifndef MATHFU_VECTOR_4_SIMD_H_
 #define MATHFU_VECTOR_4_SIMD_H_
 
+#include "mathfu/internal/simd4f.h"
 #include "mathfu/internal/vector_4.h"
 #include "mathfu/utilities.h"
 
 #include <math.h>
 
-#ifdef MATHFU_COMPILE_WITH_SIMD
-#include "vectorial/simd4f.h"
-#endif
+#if defined(MATHFU_COMPILE_WITH_SSE2) && defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif  // defined(MATHFU_COMPILE_WITH_SSE2) && defined(__SSE4_1__)
 
 /// @file mathfu/internal/vector_4_simd.h MathFu Vector<T, 4> Specialization
 /// @brief 4-dimensional specialization of mathfu::Vector for SIMD optimized
@@ -34,6 +35,17 @@ namespace mathfu {
 
 #ifdef MATHFU_COMPILE_WITH_SIMD
 
+#ifdef MATHFU_COMPILE_WITH_SSE2
+/// @cond MATHFU_INTERNAL
+// Reduce the elements of simd4 to a scalar by applying an operation to the
+// upper and lower halves of the register then the remaining two elements.
+#define MATHFU_VECTOR4_SIMD_REDUCE(OP_PS, OP_SS)                          \
+  const __m128 pairs = OP_PS(simd4, _mm_movehl_ps(simd4, simd4));         \
+  return _mm_cvtss_f32(                                                   \
+      OP_SS(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+/// @endcond
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
 template <>
 class Vector<float, 4> {
  public:
@@ -44,10 +56,14 @@ class Vector<float, 4> {
   inline Vector(const Vector<float, 4>& v) { simd4 = v.simd4; }
 
   explicit inline Vector(const Vector<int, 4>& v) {
+#ifdef MATHFU_COMPILE_WITH_SSE2
+    simd4 = _mm_cvtepi32_ps(LoadIntVector(v));
+#else
     data_[0] = static_cast<float>(v[0]);
     data_[1] = static_cast<float>(v[1]);
     data_[2] = static_cast<float>(v[2]);
     data_[3] = static_cast<float>(v[3]);
+#endif  // MATHFU_COMPILE_WITH_SSE2
   }
 
   explicit inline Vector(const simd4f& v) { simd4 = v; }
@@ -206,6 +222,40 @@ class Vector<float, 4> {
     return Vector<float, 4>(simd4f_normalize4(simd4));
   }
 
+  inline float LengthFast() const { return LengthFastHelper(*this); }
+
+  inline float NormalizeFast() { return NormalizeFastHelper(*this); }
+
+  inline Vector<float, 4> NormalizedFast() const {
+    return NormalizedFastHelper(*this);
+  }
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+  inline float Sum() const {
+    MATHFU_VECTOR4_SIMD_REDUCE(_mm_add_ps, _mm_add_ss)
+  }
+
+  inline float Product() const {
+    MATHFU_VECTOR4_SIMD_REDUCE(_mm_mul_ps, _mm_mul_ss)
+  }
+
+  inline float MinComponent() const {
+    MATHFU_VECTOR4_SIMD_REDUCE(_mm_min_ps, _mm_min_ss)
+  }
+
+  inline float MaxComponent() const {
+    MATHFU_VECTOR4_SIMD_REDUCE(_mm_max_ps, _mm_max_ss)
+  }
+#else
+  inline float Sum() const { return SumHelper(*this); }
+
+  inline float Product() const { return ProductHelper(*this); }
+
+  inline float MinComponent() const { return MinComponentHelper(*this); }
+
+  inline float MaxComponent() const { return MaxComponentHelper(*this); }
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
   template <typename CompatibleT>
   static inline Vector<float, 4> FromType(const CompatibleT& compatible) {
     return FromTypeHelper<float, 4, CompatibleT>(compatible);
@@ -290,6 +340,52 @@ class Vector<float, 4> {
   };
 #include "mathfu/internal/disable_warnings_end.h"
 };
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+#undef MATHFU_VECTOR4_SIMD_REDUCE
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+// Convert to integers, truncating towards zero like static_cast<int>().
+template <>
+template <>
+inline Vector<int, 4>::Vector(const Vector<float, 4>& v) {
+  StoreIntVector(_mm_cvttps_epi32(v.simd4), this);
+}
+
+// Lane-wise comparisons which store the result of an SSE compare instruction
+// in the mask.  Non-template overloads are preferred to the generic templates
+// in vector.h.
+#define MATHFU_VECTOR4_SIMD_COMPARE(NAME, OP)                   \
+  inline VectorMask<4> NAME(const Vector<float, 4>& lhs,        \
+                            const Vector<float, 4>& rhs) {      \
+    VectorMask<4> mask;                                         \
+    _mm_storeu_ps(reinterpret_cast<float*>(mask.data_),         \
+                  OP(lhs.simd4, rhs.simd4));                    \
+    return mask;                                                \
+  }
+
+MATHFU_VECTOR4_SIMD_COMPARE(operator<, _mm_cmplt_ps)
+MATHFU_VECTOR4_SIMD_COMPARE(operator<=, _mm_cmple_ps)
+MATHFU_VECTOR4_SIMD_COMPARE(operator>, _mm_cmpgt_ps)
+MATHFU_VECTOR4_SIMD_COMPARE(operator>=, _mm_cmpge_ps)
+MATHFU_VECTOR4_SIMD_COMPARE(Equal, _mm_cmpeq_ps)
+MATHFU_VECTOR4_SIMD_COMPARE(NotEqual, _mm_cmpneq_ps)
+
+#undef MATHFU_VECTOR4_SIMD_COMPARE
+
+inline Vector<float, 4> Select(const VectorMask<4>& mask,
+                               const Vector<float, 4>& v1,
+                               const Vector<float, 4>& v2) {
+  const __m128 m = _mm_loadu_ps(reinterpret_cast<const float*>(mask.data_));
+#ifdef __SSE4_1__
+  return Vector<float, 4>(_mm_blendv_ps(v2.simd4, v1.simd4, m));
+#else
+  return Vector<float, 4>(
+      _mm_or_ps(_mm_and_ps(m, v1.simd4), _mm_andnot_ps(m, v2.simd4)));
+#endif  // __SSE4_1__
+}
+#endif  // MATHFU_COMPILE_WITH_SSE2
 /// @endcond
 #endif  // MATHFU_COMPILE_WITH_SIMD
 
@@ -0,0 +1,69 @@
+/*
+* Copyright 2016 Google Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef MATHFU_INTERNAL_VECTOR_INT_SIMD_H_
+#define MATHFU_INTERNAL_VECTOR_INT_SIMD_H_
+
+#include "mathfu/internal/vector_3.h"
+#include "mathfu/internal/vector_4.h"
+#include "mathfu/utilities.h"
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+#include <emmintrin.h>
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
+/// @file mathfu/internal/vector_int_simd.h MathFu Vector<int, Dims> SIMD
+/// operations.
+/// @brief Loads and stores of 3 and 4-dimensional integer Vectors used by
+/// the SSE2 conversions to and from floating point Vectors.
+///
+/// Unlike the floating point specializations, integer Vectors keep their
+/// layout so vec3i remains 3 elements in size.  Compilers vectorize the
+/// generic element-wise operations of integer Vectors in loops, moving each
+/// result through an SSE register is slower so the operations are not
+/// specialized (see benchmarks/vector_benchmark).
+/// @see mathfu::Vector
+
+namespace mathfu {
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+/// @cond MATHFU_INTERNAL
+// Load the elements of an integer Vector into the low lanes of a register,
+// setting the remaining lanes to zero.
+inline __m128i LoadIntVector(const Vector<int, 3>& v) {
+  return _mm_unpacklo_epi64(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(v.data_)),
+      _mm_cvtsi32_si128(v.data_[2]));
+}
+
+inline __m128i LoadIntVector(const Vector<int, 4>& v) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(v.data_));
+}
+
+// Store the low lanes of a register to an integer Vector.
+inline void StoreIntVector(const __m128i& s, Vector<int, 3>* v) {
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(v->data_), s);
+  v->data_[2] = _mm_cvtsi128_si32(_mm_srli_si128(s, 8));
+}
+
+inline void StoreIntVector(const __m128i& s, Vector<int, 4>* v) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(v->data_), s);
+}
+/// @endcond
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
+}  // namespace mathfu
+
+#endif  // MATHFU_INTERNAL_VECTOR_INT_SIMD_H_
@@ -0,0 +1,289 @@
+/*
+* Copyright 2016 Google Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef MATHFU_INTERNAL_VECTOR_WIDE_SIMD_H_
+#define MATHFU_INTERNAL_VECTOR_WIDE_SIMD_H_
+
+#include "mathfu/vector.h"
+#include "mathfu/utilities.h"
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+#include <emmintrin.h>
+#ifdef __AVX__
+#include <immintrin.h>
+#endif  // __AVX__
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
+/// @file mathfu/internal/vector_wide_simd.h MathFu Vector<float, 8> and
+/// Vector<float, 16> SIMD operations.
+/// @brief Overloads of the arithmetic, dot product, interpolation, minimum
+/// and maximum operations for 8 and 16-dimensional float Vectors.
+///
+/// Each Vector is processed using the widest registers the target supports:
+/// a single AVX-512 register for 16 elements, AVX registers for 8 elements
+/// and pairs of AVX registers for 16, or SSE registers otherwise.  The
+/// Vectors keep the generic layout so they can be stored in arrays without
+/// padding.
+/// @see mathfu::Vector
+
+namespace mathfu {
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+/// @cond MATHFU_INTERNAL
+// Register used to process Vector<float, Dims>.
+template <int Dims>
+struct WideFloatRegister {
+  typedef __m128 Type;
+};
+
+#ifdef __AVX__
+template <>
+struct WideFloatRegister<8> {
+  typedef __m256 Type;
+};
+
+template <>
+struct WideFloatRegister<16> {
+#ifdef __AVX512F__
+  typedef __m512 Type;
+#else
+  typedef __m256 Type;
+#endif  // __AVX512F__
+};
+#endif  // __AVX__
+
+// Operations on each register type, where PREFIX is the prefix of the
+// intrinsics for the register.  The unused pointer argument of WideLoad()
+// and WideSplat() selects the register type.
+#define MATHFU_WIDE_FLOAT_OPERATIONS(R, PREFIX)                                \
+  inline R WideLoad(const float* p, const R*) { return PREFIX##_loadu_ps(p); } \
+  inline R WideSplat(float s, const R*) { return PREFIX##_set1_ps(s); }        \
+  inline void WideStore(const R& r, float* p) { PREFIX##_storeu_ps(p, r); }    \
+  inline R WideAdd(const R& a, const R& b) { return PREFIX##_add_ps(a, b); }   \
+  inline R WideSub(const R& a, const R& b) { return PREFIX##_sub_ps(a, b); }   \
+  inline R WideMul(const R& a, const R& b) { return PREFIX##_mul_ps(a, b); }   \
+  inline R WideDiv(const R& a, const R& b) { return PREFIX##_div_ps(a, b); }
+
+#define MATHFU_WIDE_FLOAT_MIN_MAX(R, PREFIX)                                 \
+  inline R WideMin(const R& a, const R& b) { return PREFIX##_min_ps(a, b); } \
+  inline R WideMax(const R& a, const R& b) { return PREFIX##_max_ps(a, b); }
+
+MATHFU_WIDE_FLOAT_OPERATIONS(__m128, _mm)
+MATHFU_WIDE_FLOAT_MIN_MAX(__m128, _mm)
+#ifdef __AVX__
+MATHFU_WIDE_FLOAT_OPERATIONS(__m256, _mm256)
+MATHFU_WIDE_FLOAT_MIN_MAX(__m256, _mm256)
+#endif  // __AVX__
+#ifdef __AVX512F__
+MATHFU_WIDE_FLOAT_OPERATIONS(__m512, _mm512)
+// GCC implements _mm512_min_ps() and _mm512_max_ps() by merging into an
+// undefined register, which -Wuninitialized reports once inlined.  The
+// masked forms with every lane selected merge into a instead.
+inline __m512 WideMin(const __m512& a, const __m512& b) {
+  return _mm512_mask_min_ps(a, static_cast<__mmask16>(0xFFFF), a, b);
+}
+inline __m512 WideMax(const __m512& a, const __m512& b) {
+  return _mm512_mask_max_ps(a, static_cast<__mmask16>(0xFFFF), a, b);
+}
+#endif  // __AVX512F__
+#undef MATHFU_WIDE_FLOAT_MIN_MAX
+#undef MATHFU_WIDE_FLOAT_OPERATIONS
+
+// Sum the lanes of a register.
+inline float WideSum(const __m128& r) {
+  const __m128 pairs = _mm_add_ps(r, _mm_movehl_ps(r, r));
+  return _mm_cvtss_f32(
+      _mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+}
+
+#ifdef __AVX__
+inline float WideSum(const __m256& r) {
+  return WideSum(
+      _mm_add_ps(_mm256_castps256_ps128(r), _mm256_extractf128_ps(r, 1)));
+}
+#endif  // __AVX__
+
+#ifdef __AVX512F__
+// Add the upper half to the lower half.  Zero masked extracts avoid the
+// undefined registers used by _mm512_reduce_add_ps() and
+// _mm512_castps512_ps256() for the same reason as WideMin().
+inline float WideSum(const __m512& r) {
+  const __m512d halves = _mm512_castps_pd(r);
+  const __mmask8 mask = static_cast<__mmask8>(0xF);
+  const __m256 lower =
+      _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(mask, halves, 0));
+  const __m256 upper =
+      _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(mask, halves, 1));
+  return WideSum(_mm256_add_ps(lower, upper));
+}
+#endif  // __AVX512F__
+
+// Iterate over the registers of Vector<float, Dims>, where kWidth is the
+// number of elements in each register.
+#define MATHFU_WIDE_FLOAT_LOOP(Dims, OPERATION)                \
+  {                                                            \
+    typedef WideFloatRegister<Dims>::Type R;                   \
+    static const int kWidth = static_cast<int>(sizeof(R) / 4); \
+    const R* const tag = 0;                                    \
+    (void)tag;                                                 \
+    for (int i = 0; i < Dims; i += kWidth) {                   \
+      OPERATION;                                               \
+    }                                                          \
+  }
+
+// Apply an operation to the registers loaded from lhs and rhs and return the
+// result in a new Vector.
+#define MATHFU_WIDE_FLOAT_BINARY(Dims, lhs, rhs, OP)        \
+  {                                                         \
+    Vector<float, Dims> result;                             \
+    MATHFU_WIDE_FLOAT_LOOP(                                 \
+        Dims, WideStore(OP(WideLoad(&(lhs).data_[i], tag),  \
+                           WideLoad(&(rhs).data_[i], tag)), \
+                        &result.data_[i]))                  \
+    return result;                                          \
+  }
+
+// Apply an operation to the registers loaded from v and a scalar s splat
+// across a register and return the result in a new Vector.
+#define MATHFU_WIDE_FLOAT_SCALAR(Dims, v, s, OP)                             \
+  {                                                                          \
+    Vector<float, Dims> result;                                              \
+    MATHFU_WIDE_FLOAT_LOOP(                                                  \
+        Dims, WideStore(OP(WideLoad(&(v).data_[i], tag), WideSplat(s, tag)), \
+                        &result.data_[i]))                                   \
+    return result;                                                           \
+  }
+
+// Apply an operation in place to the registers loaded from lhs and rhs.
+#define MATHFU_WIDE_FLOAT_ASSIGN(Dims, lhs, rhs, OP)        \
+  {                                                         \
+    MATHFU_WIDE_FLOAT_LOOP(                                 \
+        Dims, WideStore(OP(WideLoad(&(lhs).data_[i], tag),  \
+                           WideLoad(&(rhs).data_[i], tag)), \
+                        &(lhs).data_[i]))                   \
+    return lhs;                                             \
+  }
+
+// The operators are explicit specializations of the generic templates in
+// vector.h so the scalar operands must match exactly, as they do without
+// SIMD.  The non-template DotProductHelper(), HadamardProductHelper(),
+// LerpHelper(), MinHelper(), MaxHelper() and SumHelper() overloads are used
+// by the Vector members and operator*().
+#define MATHFU_WIDE_FLOAT_VECTOR_OPERATIONS(Dims)                             \
+  template <>                                                                 \
+  inline Vector<float, Dims> operator+(const Vector<float, Dims>& lhs,        \
+                                       const Vector<float, Dims>& rhs)        \
+      MATHFU_WIDE_FLOAT_BINARY(Dims, lhs, rhs, WideAdd)                       \
+  template <>                                                                 \
+  inline Vector<float, Dims> operator-(const Vector<float, Dims>& lhs,        \
+                                       const Vector<float, Dims>& rhs)        \
+      MATHFU_WIDE_FLOAT_BINARY(Dims, lhs, rhs, WideSub)                       \
+  template <>                                                                 \
+  inline Vector<float, Dims> operator/(const Vector<float, Dims>& lhs,        \
+                                       const Vector<float, Dims>& rhs)        \
+      MATHFU_WIDE_FLOAT_BINARY(Dims, lhs, rhs, WideDiv)                       \
+  template <>                                                                 \
+  inline Vector<float, Dims> operator-(const Vector<float, Dims>& v)          \
+      MATHFU_WIDE_FLOAT_SCALAR(Dims, v, -1.0f, WideMul)                       \
+  template <>                                                                 \
+  inline Vector<float, Dims> operator*(const Vector<float, Dims>& v, float s) \
+      MATHFU_WIDE_FLOAT_SCALAR(Dims, v, s, WideMul)                           \
+  template <>                                                                 \
+  inline Vector<float, Dims> operator*(float s, const Vector<float, Dims>& v) \
+      MATHFU_WIDE_FLOAT_SCALAR(Dims, v, s, WideMul)                           \
+  template <>                                                                 \
+  inline Vector<float, Dims> operator/(const Vector<float, Dims>& v, float s) \
+      MATHFU_WIDE_FLOAT_SCALAR(Dims, v, s, WideDiv)                           \
+  template <>                                                                 \
+  inline Vector<float, Dims> operator+(const Vector<float, Dims>& v, float s) \
+      MATHFU_WIDE_FLOAT_SCALAR(Dims, v, s, WideAdd)                           \
+  template <>                                                                 \
+  inline Vector<float, Dims> operator-(const Vector<float, Dims>& v, float s) \
+      MATHFU_WIDE_FLOAT_SCALAR(Dims, v, s, WideSub)                           \
+  template <>                                                                 \
+  inline Vector<float, Dims>& operator+=(Vector<float, Dims>& lhs,            \
+                                         const Vector<float, Dims>& rhs)      \
+      MATHFU_WIDE_FLOAT_ASSIGN(Dims, lhs, rhs, WideAdd)                       \
+  template <>                                                                 \
+  inline Vector<float, Dims>& operator-=(Vector<float, Dims>& lhs,            \
+                                         const Vector<float, Dims>& rhs)      \
+      MATHFU_WIDE_FLOAT_ASSIGN(Dims, lhs, rhs, WideSub)                       \
+  template <>                                                                 \
+  inline Vector<float, Dims>& operator*=(Vector<float, Dims>& lhs,            \
+                                         const Vector<float, Dims>& rhs)      \
+      MATHFU_WIDE_FLOAT_ASSIGN(Dims, lhs, rhs, WideMul)                       \
+  template <>                                                                 \
+  inline Vector<float, Dims>& operator/=(Vector<float, Dims>& lhs,            \
+                                         const Vector<float, Dims>& rhs)      \
+      MATHFU_WIDE_FLOAT_ASSIGN(Dims, lhs, rhs, WideDiv)                       \
+  template <>                                                                 \
+  inline Vector<float, Dims>& operator*=(Vector<float, Dims>& v, float s) {   \
+    MATHFU_WIDE_FLOAT_LOOP(Dims,                                              \
+                           WideStore(WideMul(WideLoad(&v.data_[i], tag),      \
+                                             WideSplat(s, tag)),              \
+                                     &v.data_[i]))                            \
+    return v;                                                                 \
+  }                                                                           \
+  inline Vector<float, Dims> HadamardProductHelper(                           \
+      const Vector<float, Dims>& v1, const Vector<float, Dims>& v2)           \
+      MATHFU_WIDE_FLOAT_BINARY(Dims, v1, v2, WideMul)                         \
+  inline Vector<float, Dims> MinHelper(const Vector<float, Dims>& v1,         \
+                                       const Vector<float, Dims>& v2)         \
+      MATHFU_WIDE_FLOAT_BINARY(Dims, v1, v2, WideMin)                         \
+  inline Vector<float, Dims> MaxHelper(const Vector<float, Dims>& v1,         \
+                                       const Vector<float, Dims>& v2)         \
+      MATHFU_WIDE_FLOAT_BINARY(Dims, v1, v2, WideMax)                         \
+  inline float DotProductHelper(const Vector<float, Dims>& v1,                \
+                                const Vector<float, Dims>& v2) {              \
+    typedef WideFloatRegister<Dims>::Type R;                                  \
+    static const int kWidth = static_cast<int>(sizeof(R) / 4);                \
+    const R* const tag = 0;                                                   \
+    R sum = WideMul(WideLoad(v1.data_, tag), WideLoad(v2.data_, tag));        \
+    for (int i = kWidth; i < Dims; i += kWidth) {                             \
+      sum = WideAdd(sum, WideMul(WideLoad(&v1.data_[i], tag),                 \
+                                 WideLoad(&v2.data_[i], tag)));               \
+    }                                                                         \
+    return WideSum(sum);                                                      \
+  }                                                                           \
+  inline Vector<float, Dims> LerpHelper(const Vector<float, Dims>& v1,        \
+                                        const Vector<float, Dims>& v2,        \
+                                        const float percent) {                \
+    return v1 * (1.0f - percent) + v2 * percent;                              \
+  }                                                                           \
+  inline float SumHelper(const Vector<float, Dims>& v) {                      \
+    typedef WideFloatRegister<Dims>::Type R;                                  \
+    static const int kWidth = static_cast<int>(sizeof(R) / 4);                \
+    const R* const tag = 0;                                                   \
+    R sum = WideLoad(v.data_, tag);                                           \
+    for (int i = kWidth; i < Dims; i += kWidth) {                             \
+      sum = WideAdd(sum, WideLoad(&v.data_[i], tag));                         \
+    }                                                                         \
+    return WideSum(sum);                                                      \
+  }
+
+MATHFU_WIDE_FLOAT_VECTOR_OPERATIONS(8)
+MATHFU_WIDE_FLOAT_VECTOR_OPERATIONS(16)
+
+#undef MATHFU_WIDE_FLOAT_VECTOR_OPERATIONS
+#undef MATHFU_WIDE_FLOAT_ASSIGN
+#undef MATHFU_WIDE_FLOAT_SCALAR
+#undef MATHFU_WIDE_FLOAT_BINARY
+#undef MATHFU_WIDE_FLOAT_LOOP
+/// @endcond
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
+}  // namespace mathfu
+
+#endif  // MATHFU_INTERNAL_VECTOR_WIDE_SIMD_H_
@@ -16,12 +16,35 @@
 #ifndef MATHFU_IO_H_
 #define MATHFU_IO_H_
 
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits>
 #include <ostream>
+#include <system_error>
 
 #include "mathfu/matrix.h"
 #include "mathfu/quaternion.h"
 #include "mathfu/vector.h"
 
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <charconv>
+#endif
+
+/// @cond MATHFU_INTERNAL
+// ToChars() and FromChars() use the floating point overloads of
+// std::to_chars() and std::from_chars() when the standard library implements
+// them, otherwise elements are converted with snprintf() and strtof() /
+// strtod() / strtol().
+#if defined(__cpp_lib_to_chars)
+#define MATHFU_COMPILE_WITH_CHARCONV
+#endif
+/// @endcond
+
 namespace mathfu {
 
 /// @brief Print the vector contents to the output stream.
@@ -52,6 +75,443 @@ inline std::ostream& operator<<(std::ostream& os, const Quaternion<T>& q) {
             << ")";
 }
 
+#ifdef MATHFU_COMPILE_WITH_CHARCONV
+/// @brief Result of ToChars(), the same type as std::to_chars_result.
+typedef std::to_chars_result ToCharsResult;
+
+/// @brief Result of FromChars(), the same type as std::from_chars_result.
+typedef std::from_chars_result FromCharsResult;
+#else
+/// @brief Result of ToChars(), with the members of std::to_chars_result.
+struct ToCharsResult {
+  /// Pointer past the last character written.
+  char* ptr;
+  /// Error of the conversion, std::errc() on success.
+  std::errc ec;
+};
+
+/// @brief Result of FromChars(), with the members of std::from_chars_result.
+struct FromCharsResult {
+  /// Pointer past the last character parsed.
+  const char* ptr;
+  /// Error of the conversion, std::errc() on success.
+  std::errc ec;
+};
+#endif  // MATHFU_COMPILE_WITH_CHARCONV
+
+/// @cond MATHFU_INTERNAL
+#ifdef MATHFU_COMPILE_WITH_CHARCONV
+// Format or parse a single element.
+template <typename T>
+inline ToCharsResult ScalarToChars(char* first, char* last, T value) {
+  return std::to_chars(first, last, value);
+}
+
+template <typename T>
+inline FromCharsResult ScalarFromChars(const char* first, const char* last,
+                                       T* value) {
+  return std::from_chars(first, last, *value);
+}
+#else
+// Longest number formatted or parsed by the C library fallback.
+static const int kMaxNumberLength = 64;
+
+// Parse a null terminated number with the C library.  value is only written
+// and true returned if the number is in range.
+inline bool ParseScalar(const char* text, char** end, float* value) {
+  errno = 0;
+  const float parsed = strtof(text, end);
+  if (errno == ERANGE) return false;
+  *value = parsed;
+  return true;
+}
+
+inline bool ParseScalar(const char* text, char** end, double* value) {
+  errno = 0;
+  const double parsed = strtod(text, end);
+  if (errno == ERANGE) return false;
+  *value = parsed;
+  return true;
+}
+
+inline bool ParseScalar(const char* text, char** end, int* value) {
+  errno = 0;
+  const long parsed = strtol(text, end, 10);
+  if (errno == ERANGE || parsed < INT_MIN || parsed > INT_MAX) return false;
+  *value = static_cast<int>(parsed);
+  return true;
+}
+
+// Copy length characters of a formatted number to [first, last).
+inline ToCharsResult CopyChars(char* first, char* last, const char* text,
+                               int length) {
+  if (length < 0 || length > last - first) {
+    return {last, std::errc::value_too_large};
+  }
+  memcpy(first, text, static_cast<size_t>(length));
+  return {first + length, std::errc()};
+}
+
+// Write the fewest significant digits which parse back to the same value,
+// matching the shortest representation of std::to_chars().
+template <typename T>
+inline ToCharsResult FloatToChars(char* first, char* last, T value) {
+  char text[kMaxNumberLength];
+  int length = 0;
+  for (int precision = std::numeric_limits<T>::digits10;
+       precision <= std::numeric_limits<T>::max_digits10; ++precision) {
+    length = snprintf(text, sizeof(text), "%.*g", precision,
+                      static_cast<double>(value));
+    char* end;
+    T parsed;
+    if (ParseScalar(text, &end, &parsed) && parsed == value) break;
+  }
+  return CopyChars(first, last, text, length);
+}
+
+inline ToCharsResult ScalarToChars(char* first, char* last, float value) {
+  return FloatToChars(first, last, value);
+}
+
+inline ToCharsResult ScalarToChars(char* first, char* last, double value) {
+  return FloatToChars(first, last, value);
+}
+
+inline ToCharsResult ScalarToChars(char* first, char* last, int value) {
+  char text[kMaxNumberLength];
+  return CopyChars(first, last, text,
+                   snprintf(text, sizeof(text), "%d", value));
+}
+
+// The C library requires null terminated text, so at most kMaxNumberLength
+// characters are copied and parsed.  Like std::from_chars() leading
+// whitespace and plus signs are rejected.
+template <typename T>
+inline FromCharsResult ScalarFromChars(const char* first, const char* last,
+                                       T* value) {
+  char text[kMaxNumberLength + 1];
+  const size_t length = last - first < kMaxNumberLength
+                            ? static_cast<size_t>(last - first)
+                            : static_cast<size_t>(kMaxNumberLength);
+  memcpy(text, first, length);
+  text[length] = '\0';
+  FromCharsResult result = {first, std::errc::invalid_argument};
+  if (text[0] == '+' || isspace(static_cast<unsigned char>(text[0]))) {
+    return result;
+  }
+  char* end;
+  const bool in_range = ParseScalar(text, &end, value);
+  if (end == text) return result;
+  result.ptr = first + (end - text);
+  result.ec = in_range ? std::errc() : std::errc::result_out_of_range;
+  return result;
+}
+#endif  // MATHFU_COMPILE_WITH_CHARCONV
+
+// Write count elements separated by separator.
+template <typename T>
+inline ToCharsResult ElementsToChars(char* first, char* last,
+                                     const T* elements, int count,
+                                     char separator) {
+  ToCharsResult result = {first, std::errc()};
+  for (int i = 0; i < count; ++i) {
+    if (i) {
+      if (result.ptr == last) return {last, std::errc::value_too_large};
+      *result.ptr++ = separator;
+    }
+    result = ScalarToChars(result.ptr, last, elements[i]);
+    if (result.ec != std::errc()) return result;
+  }
+  return result;
+}
+
+// Skip whitespace and at most one separator.
+inline const char* SkipSeparator(const char* first, const char* last,
+                                 char separator) {
+  bool skipped_separator = false;
+  for (; first != last; ++first) {
+    const char c = *first;
+    if (c == separator && !skipped_separator) {
+      skipped_separator = true;
+    } else if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+      break;
+    }
+  }
+  return first;
+}
+
+// Parse count elements separated by separator.
+template <typename T>
+inline FromCharsResult ElementsFromChars(const char* first, const char* last,
+                                         T* elements, int count,
+                                         char separator) {
+  FromCharsResult result = {first, std::errc()};
+  for (int i = 0; i < count; ++i) {
+    // Whitespace is always skipped before the first element.
+    const char* const start =
+        SkipSeparator(result.ptr, last, i ? separator : ' ');
+    result = ScalarFromChars(start, last, &elements[i]);
+    if (result.ec != std::errc()) return result;
+  }
+  return result;
+}
+
+// Elements of a Vector, Matrix or Quaternion in the order they are
+// formatted.
+template <typename T, int d>
+inline void GetElements(const Vector<T, d>& v, T* elements) {
+  for (int i = 0; i < d; ++i) elements[i] = v[i];
+}
+
+template <typename T, int d>
+inline void SetElements(const T* elements, Vector<T, d>* v) {
+  for (int i = 0; i < d; ++i) (*v)[i] = elements[i];
+}
+
+template <typename T, int rows, int columns>
+inline void GetElements(const Matrix<T, rows, columns>& m, T* elements) {
+  for (int i = 0; i < rows * columns; ++i) elements[i] = m[i];
+}
+
+template <typename T, int rows, int columns>
+inline void SetElements(const T* elements, Matrix<T, rows, columns>* m) {
+  for (int i = 0; i < rows * columns; ++i) (*m)[i] = elements[i];
+}
+
+template <typename T>
+inline void GetElements(const Quaternion<T>& q, T* elements) {
+  for (int i = 0; i < 4; ++i) elements[i] = q[i];
+}
+
+template <typename T>
+inline void SetElements(const T* elements, Quaternion<T>* q) {
+  *q = Quaternion<T>(elements[0], elements[1], elements[2], elements[3]);
+}
+
+// Number of elements in a Vector, Matrix or Quaternion.
+template <typename T>
+struct ElementCount;
+
+template <typename T, int d>
+struct ElementCount<Vector<T, d> > {
+  typedef T Scalar;
+  static const int kCount = d;
+};
+
+template <typename T, int rows, int columns>
+struct ElementCount<Matrix<T, rows, columns> > {
+  typedef T Scalar;
+  static const int kCount = rows * columns;
+};
+
+template <typename T>
+struct ElementCount<Quaternion<T> > {
+  typedef T Scalar;
+  static const int kCount = 4;
+};
+
+template <typename Type>
+inline ToCharsResult ObjectToChars(char* first, char* last, const Type& value,
+                                   char separator) {
+  typedef ElementCount<Type> Count;
+  typename Count::Scalar elements[Count::kCount];
+  GetElements(value, elements);
+  return ElementsToChars(first, last, elements, Count::kCount, separator);
+}
+
+template <typename Type>
+inline FromCharsResult ObjectFromChars(const char* first, const char* last,
+                                       Type* value, char separator) {
+  typedef ElementCount<Type> Count;
+  typename Count::Scalar elements[Count::kCount];
+  const FromCharsResult result = ElementsFromChars(
+      first, last, elements, Count::kCount, separator);
+  if (result.ec == std::errc()) SetElements(elements, value);
+  return result;
+}
+/// @endcond
+
+/// @brief Format a Vector as text.
+/// @anchor mathfu_ToChars
+///
+/// Elements are written using std::to_chars() with the shortest
+/// representation which parses back to the same value, separated by
+/// separator.  Nothing is allocated and the output is not null terminated.
+///
+/// When the standard library does not implement the floating point overloads
+/// of std::to_chars() (C++17) elements are formatted with snprintf() instead,
+/// using the fewest significant digits which parse back to the same value.
+/// This fallback supports float, double and int elements and uses the
+/// decimal point of the current C locale.
+///
+/// @param first Start of the output buffer.
+/// @param last End of the output buffer.
+/// @param v Vector to format.
+/// @param separator Character written between elements.
+/// @return Result with ptr pointing past the last character written, or
+/// ptr set to last and ec set to std::errc::value_too_large if the buffer is
+/// too small.
+template <typename T, int d>
+inline ToCharsResult ToChars(char* first, char* last, const Vector<T, d>& v,
+                             char separator = ' ') {
+  return ObjectToChars(first, last, v, separator);
+}
+
+/// @brief Format a Matrix as text.
+///
+/// Elements are written in column major order, see ToChars(char*, char*,
+/// const Vector<T, d>&, char).
+///
+/// @param first Start of the output buffer.
+/// @param last End of the output buffer.
+/// @param m Matrix to format.
+/// @param separator Character written between elements.
+/// @return Result with ptr pointing past the last character written, or
+/// ptr set to last and ec set to std::errc::value_too_large if the buffer is
+/// too small.
+template <typename T, int rows, int columns>
+inline ToCharsResult ToChars(char* first, char* last,
+                             const Matrix<T, rows, columns>& m,
+                             char separator = ' ') {
+  return ObjectToChars(first, last, m, separator);
+}
+
+/// @brief Format a Quaternion as text.
+///
+/// Elements are written in the order scalar, x, y, z, see ToChars(char*,
+/// char*, const Vector<T, d>&, char).
+///
+/// @param first Start of the output buffer.
+/// @param last End of the output buffer.
+/// @param q Quaternion to format.
+/// @param separator Character written between elements.
+/// @return Result with ptr pointing past the last character written, or
+/// ptr set to last and ec set to std::errc::value_too_large if the buffer is
+/// too small.
+template <typename T>
+inline ToCharsResult ToChars(char* first, char* last, const Quaternion<T>& q,
+                             char separator = ' ') {
+  return ObjectToChars(first, last, q, separator);
+}
+
+/// @brief Format an array of objects as lines of text.
+/// @anchor mathfu_ToCharsArray
+///
+/// Each Vector, Matrix or Quaternion is formatted with ToChars() and followed
+/// by line_separator.
+///
+/// @param first Start of the output buffer.
+/// @param last End of the output buffer.
+/// @param values Array of count objects to format.
+/// @param count Number of objects.
+/// @param separator Character written between elements.
+/// @param line_separator Character written after each object.
+/// @return Result with ptr pointing past the last character written, or
+/// ptr set to last and ec set to std::errc::value_too_large if the buffer is
+/// too small.
+template <typename Type>
+inline ToCharsResult ToCharsArray(char* first, char* last, const Type* values,
+                                  size_t count, char separator = ' ',
+                                  char line_separator = '\n') {
+  ToCharsResult result = {first, std::errc()};
+  for (size_t i = 0; i < count; ++i) {
+    result = ToChars(result.ptr, last, values[i], separator);
+    if (result.ec != std::errc()) return result;
+    if (result.ptr == last) return {last, std::errc::value_too_large};
+    *result.ptr++ = line_separator;
+  }
+  return result;
+}
+
+/// @brief Parse a Vector from text.
+/// @anchor mathfu_FromChars
+///
+/// Elements are parsed using std::from_chars() in the order written by
+/// ToChars().  Whitespace (including line breaks) is skipped before each
+/// element and a single separator is skipped between elements.
+///
+/// When the standard library does not implement the floating point overloads
+/// of std::from_chars() (C++17) elements are parsed with strtof(), strtod()
+/// or strtol() instead.  This fallback supports float, double and int
+/// elements of at most 64 characters and uses the decimal point of the
+/// current C locale.
+///
+/// @param first Start of the text.
+/// @param last End of the text.
+/// @param v Vector which receives the parsed elements.  It is unchanged if
+/// parsing fails.
+/// @param separator Character between elements.
+/// @return Result with ptr pointing past the last parsed character, or
+/// ec set to the error of the first element which failed to parse.
+template <typename T, int d>
+inline FromCharsResult FromChars(const char* first, const char* last,
+                                 Vector<T, d>* v, char separator = ' ') {
+  return ObjectFromChars(first, last, v, separator);
+}
+
+/// @brief Parse a Matrix from text.
+///
+/// Elements are parsed in column major order, see FromChars(const char*,
+/// const char*, Vector<T, d>*, char).
+///
+/// @param first Start of the text.
+/// @param last End of the text.
+/// @param m Matrix which receives the parsed elements.  It is unchanged if
+/// parsing fails.
+/// @param separator Character between elements.
+/// @return Result with ptr pointing past the last parsed character, or
+/// ec set to the error of the first element which failed to parse.
+template <typename T, int rows, int columns>
+inline FromCharsResult FromChars(const char* first, const char* last,
+                                 Matrix<T, rows, columns>* m,
+                                 char separator = ' ') {
+  return ObjectFromChars(first, last, m, separator);
+}
+
+/// @brief Parse a Quaternion from text.
+///
+/// Elements are parsed in the order scalar, x, y, z, see FromChars(const
+/// char*, const char*, Vector<T, d>*, char).
+///
+/// @param first Start of the text.
+/// @param last End of the text.
+/// @param q Quaternion which receives the parsed elements.  It is unchanged
+/// if parsing fails.
+/// @param separator Character between elements.
+/// @return Result with ptr pointing past the last parsed character, or
+/// ec set to the error of the first element which failed to parse.
+template <typename T>
+inline FromCharsResult FromChars(const char* first, const char* last,
+                                 Quaternion<T>* q, char separator = ' ') {
+  return ObjectFromChars(first, last, q, separator);
+}
+
+/// @brief Parse an array of objects from text.
+/// @anchor mathfu_FromCharsArray
+///
+/// Objects are parsed with FromChars() and separated by whitespace, so
+/// text written by ToCharsArray() with any line separator which is
+/// whitespace can be parsed.
+///
+/// @param first Start of the text.
+/// @param last End of the text.
+/// @param values Array of count objects which receives the parsed objects.
+/// @param count Number of objects to parse.
+/// @param separator Character between elements.
+/// @return Result with ptr pointing past the last parsed character, or
+/// ec set to the error of the first element which failed to parse.
+template <typename Type>
+inline FromCharsResult FromCharsArray(const char* first, const char* last,
+                                      Type* values, size_t count,
+                                      char separator = ' ') {
+  FromCharsResult result = {first, std::errc()};
+  for (size_t i = 0; i < count; ++i) {
+    result = FromChars(result.ptr, last, &values[i], separator);
+    if (result.ec != std::errc()) return result;
+  }
+  return result;
+}
+
 }  // namespace mathfu
 
 #endif  // MATHFU_IO_H_
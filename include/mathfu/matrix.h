@@ -23,6 +23,10 @@
 
 #include <assert.h>
 
+#ifdef MATHFU_COMPILE_WITH_SSE2
+#include <emmintrin.h>
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
 /// @file mathfu/matrix.h
 /// @brief Matrix class and functions.
 /// @addtogroup mathfu_matrix
@@ -102,11 +106,27 @@ template <bool check_invertible, class T, int Rows, int Cols>
 inline bool InverseHelper(
     const Matrix<T, Rows, Cols>& m, Matrix<T, Rows, Cols>* const inverse,
     T det_thresh);
+template <class T, int N>
+inline bool FactorizeLUHelper(const Matrix<T, N, N>& m,
+                              Matrix<T, N, N>* const lu,
+                              Vector<int, N>* const pivots, T pivot_thresh);
+template <class T, int N>
+inline Vector<T, N> SolveLUHelper(const Matrix<T, N, N>& lu,
+                                  const Vector<int, N>& pivots,
+                                  const Vector<T, N>& b);
+template <class T, int N>
+inline bool FactorizeCholeskyHelper(const Matrix<T, N, N>& m,
+                                    Matrix<T, N, N>* const l, T pivot_thresh);
+template <class T, int N>
+inline Vector<T, N> SolveCholeskyHelper(const Matrix<T, N, N>& l,
+                                        const Vector<T, N>& b);
 template <class T, int size1, int size2, int size3>
 inline void TimesHelper(const Matrix<T, size1, size2>& m1,
                         const Matrix<T, size2, size3>& m2,
                         Matrix<T, size1, size3>* out_m);
 template <class T, int Rows, int Cols>
+inline Matrix<T, Cols, Rows> TransposeHelper(const Matrix<T, Rows, Cols>& m);
+template <class T, int Rows, int Cols>
 static inline Matrix<T, Rows, Cols> OuterProductHelper(
     const Vector<T, Rows>& v1, const Vector<T, Cols>& v2);
 template <class T>
@@ -560,7 +580,8 @@ class Matrix {
   /// values that can't be accurately represented by the floating point
   /// datatype T.  More extensive checks (relative to the input values) are
   /// possible but <b>far</b> more expensive, complicated and difficult to
-  /// test.
+  /// test.  Matrices larger than 4x4 are inverted using FactorizeLU(), which
+  /// compares each pivot with the threshold instead of the determinant.
   /// @return Whether the matrix is invertible.
   inline bool InverseWithDeterminantCheck(
       Matrix<T, Rows, Cols>* const inverse,
@@ -568,15 +589,90 @@ class Matrix {
     return InverseHelper<true>(*this, inverse, det_thresh);
   }
 
+  /// @brief Factorize this Matrix into lower and upper triangular matrices.
+  ///
+  /// This calculates the LU factorization with partial pivoting
+  /// <code>P * m = L * U</code> of a square Matrix, which solves linear
+  /// systems with SolveLU() in O(Rows^2) operations each.  Each elimination
+  /// step updates whole columns using Vector operations.
+  ///
+  /// @param lu Receives U on and above the diagonal and L, whose diagonal
+  /// elements are 1, below the diagonal.
+  /// @param pivots Receives the index of the row swapped with row i in
+  /// element i.
+  /// @param pivot_thresh Factorization fails if the absolute value of a pivot
+  /// is less than this value.
+  /// @return Whether the matrix is invertible.
+  inline bool FactorizeLU(
+      Matrix<T, Rows, Cols>* const lu, Vector<int, Rows>* const pivots,
+      T pivot_thresh = Constants<T>::GetDeterminantThreshold()) const {
+    return FactorizeLUHelper(*this, lu, pivots, pivot_thresh);
+  }
+
+  /// @brief Solve a linear system using an LU factorization.
+  ///
+  /// @param lu Factorization of the Matrix m calculated by FactorizeLU().
+  /// @param pivots Pivots calculated by FactorizeLU().
+  /// @param b Right hand side of the system.
+  /// @return Vector x such that <code>m * x = b</code>.
+  static inline Vector<T, Rows> SolveLU(const Matrix<T, Rows, Cols>& lu,
+                                        const Vector<int, Rows>& pivots,
+                                        const Vector<T, Rows>& b) {
+    return SolveLUHelper(lu, pivots, b);
+  }
+
+  /// @brief Factorize this symmetric positive definite Matrix.
+  ///
+  /// This calculates the Cholesky factorization <code>m = L * L^T</code>,
+  /// which is about twice as fast as FactorizeLU() and does not require
+  /// pivoting.  Only the lower triangle of this Matrix is read.
+  ///
+  /// @param l Receives the lower triangular Matrix L.  Elements above the
+  /// diagonal are set to zero.
+  /// @param pivot_thresh Factorization fails if the square of a diagonal
+  /// element of L is not positive or is less than this value.
+  /// @return Whether the matrix is positive definite.
+  inline bool FactorizeCholesky(
+      Matrix<T, Rows, Cols>* const l,
+      T pivot_thresh = Constants<T>::GetDeterminantThreshold()) const {
+    return FactorizeCholeskyHelper(*this, l, pivot_thresh);
+  }
+
+  /// @brief Solve a linear system using a Cholesky factorization.
+  ///
+  /// @param l Factorization of the Matrix m calculated by
+  /// FactorizeCholesky().
+  /// @param b Right hand side of the system.
+  /// @return Vector x such that <code>m * x = b</code>.
+  static inline Vector<T, Rows> SolveCholesky(const Matrix<T, Rows, Cols>& l,
+                                              const Vector<T, Rows>& b) {
+    return SolveCholeskyHelper(l, b);
+  }
+
+  /// @brief Solve the linear system <code>m * x = b</code>.
+  ///
+  /// To solve multiple systems with the same Matrix use FactorizeLU() and
+  /// SolveLU() instead.
+  ///
+  /// @param b Right hand side of the system.
+  /// @param x Receives the solution.
+  /// @param pivot_thresh See FactorizeLU().
+  /// @return Whether the matrix is invertible.
+  inline bool Solve(
+      const Vector<T, Rows>& b, Vector<T, Rows>* const x,
+      T pivot_thresh = Constants<T>::GetDeterminantThreshold()) const {
+    Matrix<T, Rows, Cols> lu;
+    Vector<int, Rows> pivots;
+    if (!FactorizeLU(&lu, &pivots, pivot_thresh)) return false;
+    *x = SolveLU(lu, pivots, b);
+    return true;
+  }
+
   /// @brief Calculate the transpose of this Matrix.
   ///
   /// @return The transpose of the specified Matrix.
   inline Matrix<T, Cols, Rows> Transpose() const {
-    Matrix<T, Cols, Rows> transpose;
-    MATHFU_UNROLLED_LOOP(
-        i, Cols, MATHFU_UNROLLED_LOOP(
-                        j, Rows, transpose.GetColumn(j)[i] = GetColumn(i)[j]))
-    return transpose;
+    return TransposeHelper(*this);
   }
 
   /// @brief Get the 2-dimensional translation of a 2-dimensional affine
@@ -733,6 +829,43 @@ class Matrix {
                         m[10]);
   }
 
+  /// @brief Correct the drift of a 3x3 rotation Matrix.
+  ///
+  /// Rotation matrices accumulate scale and shear when they are repeatedly
+  /// multiplied.  This orthonormalizes the columns using Gram-Schmidt: the
+  /// direction of the first column is preserved, the second column is made
+  /// perpendicular to it and the third column is their cross product, so the
+  /// result is always a rotation.
+  ///
+  /// @param m 3x3 Matrix whose first two columns are linearly independent.
+  /// @return Rotation Matrix containing the result.
+  static inline Matrix<T, 3> Orthonormalize(const Matrix<T, 3>& m) {
+    const Vector<T, 3> x = m.GetColumn(0).Normalized();
+    const Vector<T, 3> y =
+        (m.GetColumn(1) - x * Vector<T, 3>::DotProduct(x, m.GetColumn(1)))
+            .Normalized();
+    Matrix<T, 3> result;
+    result.GetColumn(0) = x;
+    result.GetColumn(1) = y;
+    result.GetColumn(2) = Vector<T, 3>::CrossProduct(x, y);
+    return result;
+  }
+
+  /// @brief Correct the drift of the rotation in a 4x4 Matrix.
+  ///
+  /// The upper-left 3x3 sub-matrix is replaced by
+  /// Orthonormalize(const Matrix<T, 3>&), which also removes any scale, and
+  /// the translation is preserved.
+  ///
+  /// @param m 4x4 rotation and translation Matrix.
+  /// @return Matrix containing the result.
+  static inline Matrix<T, 4> Orthonormalize(const Matrix<T, 4>& m) {
+    Matrix<T, 4> result =
+        FromRotationMatrix(Orthonormalize(ToRotationMatrix(m)));
+    result.GetColumn(3) = m.GetColumn(3);
+    return result;
+  }
+
   /// @brief Constructs a Matrix<float, 4> from an AffineTransform.
   ///
   /// @param affine An AffineTransform reference to be used to construct
@@ -1015,6 +1148,11 @@ inline Vector<T, 3> operator*(const Matrix<T, 3, 3>& m, const Vector<T, 3>& v) {
 template <>
 inline Vector<float, 3> operator*(const Matrix<float, 3, 3>& m,
                                   const Vector<float, 3>& v) {
+#ifdef MATHFU_COMPILE_WITH_SIMD
+  // Sum the columns scaled by each element of the vector, which adds the
+  // products in the same order as the dot products below.
+  return m.data_[0] * v[0] + m.data_[1] * v[1] + m.data_[2] * v[2];
+#else
   return Vector<float, 3>(
       MATHFU_MATRIX_3X3_DOT(&m.data_[0].data_[0], v, 0,
                             MATHFU_VECTOR_STRIDE_FLOATS(v)),
@@ -1022,6 +1160,7 @@ inline Vector<float, 3> operator*(const Matrix<float, 3, 3>& m,
                             MATHFU_VECTOR_STRIDE_FLOATS(v)),
       MATHFU_MATRIX_3X3_DOT(&m.data_[0].data_[0], v, 2,
                             MATHFU_VECTOR_STRIDE_FLOATS(v)));
+#endif  // MATHFU_COMPILE_WITH_SIMD
 }
 /// @endcond
 
@@ -1035,6 +1174,36 @@ inline Vector<T, 4> operator*(const Matrix<T, 4, 4>& m, const Vector<T, 4>& v) {
 }
 /// @endcond
 
+#ifdef MATHFU_COMPILE_WITH_SIMD
+/// @cond MATHFU_INTERNAL
+// Sum the columns scaled by each element of the vector, which adds the
+// products in the same order as the dot products above.  With SSE2 each
+// element is broadcast from the register holding the vector rather than
+// reloaded from memory.
+template <>
+inline Vector<float, 4> operator*(const Matrix<float, 4, 4>& m,
+                                  const Vector<float, 4>& v) {
+#ifdef MATHFU_COMPILE_WITH_SSE2
+  const __m128 s = v.simd4;
+  const __m128 result = _mm_add_ps(
+      _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(m.data_[0].simd4,
+                                _mm_shuffle_ps(s, s, _MM_SHUFFLE(0, 0, 0, 0))),
+                     _mm_mul_ps(m.data_[1].simd4,
+                                _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 1, 1, 1)))),
+          _mm_mul_ps(m.data_[2].simd4,
+                     _mm_shuffle_ps(s, s, _MM_SHUFFLE(2, 2, 2, 2)))),
+      _mm_mul_ps(m.data_[3].simd4,
+                 _mm_shuffle_ps(s, s, _MM_SHUFFLE(3, 3, 3, 3))));
+  return Vector<float, 4>(result);
+#else
+  return m.data_[0] * v[0] + m.data_[1] * v[1] + m.data_[2] * v[2] +
+         m.data_[3] * v[3];
+#endif  // MATHFU_COMPILE_WITH_SSE2
+}
+/// @endcond
+#endif  // MATHFU_COMPILE_WITH_SIMD
+
 /// @brief Multiply a 4x4 Matrix by a 3-dimensional Vector.
 ///
 /// This is provided as a convenience and assumes the vector has a fourth
@@ -1121,6 +1290,68 @@ inline void TimesHelper(const Matrix<T, 3, 3>& m1, const Matrix<T, 3, 3>& m2,
 }
 /// @endcond
 
+#ifdef MATHFU_COMPILE_WITH_SIMD
+/// @cond MATHFU_INTERNAL
+// Each column of the result is m1 multiplied by a column of m2, calculated
+// with Vector operations on the columns of m1 rather than row dot products.
+inline void TimesHelper(const Matrix<float, 3, 3>& m1,
+                        const Matrix<float, 3, 3>& m2,
+                        Matrix<float, 3, 3>* out_m) {
+  for (int i = 0; i < 3; ++i) {
+    out_m->data_[i] = m1 * m2.data_[i];
+  }
+}
+/// @endcond
+#endif  // MATHFU_COMPILE_WITH_SIMD
+
+/// @cond MATHFU_INTERNAL
+template <class T, int Rows, int Cols>
+inline Matrix<T, Cols, Rows> TransposeHelper(const Matrix<T, Rows, Cols>& m) {
+  Matrix<T, Cols, Rows> transpose;
+  MATHFU_UNROLLED_LOOP(
+      i, Cols, MATHFU_UNROLLED_LOOP(
+                   j, Rows, transpose.GetColumn(j)[i] = m.GetColumn(i)[j]))
+  return transpose;
+}
+/// @endcond
+
+#if defined(MATHFU_COMPILE_WITH_SSE2) && defined(MATHFU_COMPILE_WITH_PADDING)
+/// @cond MATHFU_INTERNAL
+// Transpose the padded columns as a 4x4 matrix whose last column is zero, so
+// the padding element of each column of the result is also zero.
+inline Matrix<float, 3, 3> TransposeHelper(const Matrix<float, 3, 3>& m) {
+  __m128 c0 = m.data_[0].simd3;
+  __m128 c1 = m.data_[1].simd3;
+  __m128 c2 = m.data_[2].simd3;
+  __m128 c3 = _mm_setzero_ps();
+  _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+  Matrix<float, 3, 3> transpose;
+  transpose.data_[0].simd3 = c0;
+  transpose.data_[1].simd3 = c1;
+  transpose.data_[2].simd3 = c2;
+  return transpose;
+}
+/// @endcond
+#endif  // MATHFU_COMPILE_WITH_SSE2 && MATHFU_COMPILE_WITH_PADDING
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+/// @cond MATHFU_INTERNAL
+inline Matrix<float, 4, 4> TransposeHelper(const Matrix<float, 4, 4>& m) {
+  __m128 c0 = m.data_[0].simd4;
+  __m128 c1 = m.data_[1].simd4;
+  __m128 c2 = m.data_[2].simd4;
+  __m128 c3 = m.data_[3].simd4;
+  _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+  Matrix<float, 4, 4> transpose;
+  transpose.data_[0].simd4 = c0;
+  transpose.data_[1].simd4 = c1;
+  transpose.data_[2].simd4 = c2;
+  transpose.data_[3].simd4 = c3;
+  return transpose;
+}
+/// @endcond
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
 /// @cond MATHFU_INTERNAL
 template <class T>
 inline void TimesHelper(const Matrix<T, 4, 4>& m1, const Matrix<T, 4, 4>& m2,
@@ -1157,6 +1388,20 @@ inline void TimesHelper(const Matrix<T, 4, 4>& m1, const Matrix<T, 4, 4>& m2,
 }
 /// @endcond
 
+#ifdef MATHFU_COMPILE_WITH_SIMD
+/// @cond MATHFU_INTERNAL
+// Each column of the result is m1 multiplied by a column of m2, which avoids
+// gathering the rows of m1 from memory.
+inline void TimesHelper(const Matrix<float, 4, 4>& m1,
+                        const Matrix<float, 4, 4>& m2,
+                        Matrix<float, 4, 4>* out_m) {
+  for (int i = 0; i < 4; ++i) {
+    out_m->data_[i] = m1 * m2.data_[i];
+  }
+}
+/// @endcond
+#endif  // MATHFU_COMPILE_WITH_SIMD
+
 /// @cond MATHFU_INTERNAL
 /// @brief Compute the identity matrix.
 ///
@@ -1252,19 +1497,137 @@ static inline Matrix<T, 4, 4> OuterProductHelper(const Vector<T, 4>& v1,
 /// @brief Compute the inverse of a matrix.
 ///
 /// There is template specialization  for 2x2, 3x3, and 4x4 matrices to
-/// increase performance. Inverse is not implemented for dense matrices that
-/// are not of size 2x2, 3x3, and 4x4.  If check_invertible is true the
-/// determinate of the matrix is compared with
+/// increase performance.  Other sizes are inverted using an LU factorization.
+/// If check_invertible is true the determinate of the matrix is compared with
 /// Constants<T>::GetDeterminantThreshold() to roughly determine whether the
-/// Matrix is invertible.
+/// Matrix is invertible, matrices inverted by LU factorization compare each
+/// pivot instead.
 template <bool check_invertible, class T, int Rows, int Cols>
 inline bool InverseHelper(const Matrix<T, Rows, Cols>& m,
                           Matrix<T, Rows, Cols>* const inverse,
                           T det_thresh) {
-  assert(false);
-  (void)m;
-  *inverse = T::Identity();
-  return false;
+  MATHFU_STATIC_ASSERT(Rows == Cols);
+  Matrix<T, Rows, Cols> lu;
+  Vector<int, Rows> pivots;
+  if (!FactorizeLUHelper(m, &lu, &pivots,
+                         check_invertible ? det_thresh : static_cast<T>(0))) {
+    return false;
+  }
+  Vector<T, Rows> column(static_cast<T>(0));
+  for (int j = 0; j < Cols; ++j) {
+    column[j] = static_cast<T>(1);
+    inverse->GetColumn(j) = SolveLUHelper(lu, pivots, column);
+    column[j] = static_cast<T>(0);
+  }
+  return true;
+}
+
+// Right-looking LU factorization with partial pivoting.  Each step
+// subtracts a multiple of the pivot row from the remaining columns, so
+// elimination is performed with column Vector operations.
+template <class T, int N>
+inline bool FactorizeLUHelper(const Matrix<T, N, N>& m,
+                              Matrix<T, N, N>* const lu,
+                              Vector<int, N>* const pivots, T pivot_thresh) {
+  Matrix<T, N, N>& a = *lu;
+  a = m;
+  for (int k = 0; k < N; ++k) {
+    int pivot = k;
+    T largest = fabs(a(k, k));
+    for (int i = k + 1; i < N; ++i) {
+      const T value = fabs(a(i, k));
+      if (value > largest) {
+        largest = value;
+        pivot = i;
+      }
+    }
+    (*pivots)[k] = pivot;
+    if (largest < pivot_thresh) return false;
+    if (pivot != k) {
+      for (int j = 0; j < N; ++j) {
+        const T temp = a(k, j);
+        a(k, j) = a(pivot, j);
+        a(pivot, j) = temp;
+      }
+    }
+    const T inverse_pivot = 1 / a(k, k);
+    Vector<T, N> multipliers(static_cast<T>(0));
+    for (int i = k + 1; i < N; ++i) {
+      multipliers[i] = a(i, k) * inverse_pivot;
+      a(i, k) = multipliers[i];
+    }
+    for (int j = k + 1; j < N; ++j) {
+      a.GetColumn(j) -= multipliers * a(k, j);
+    }
+  }
+  return true;
+}
+
+template <class T, int N>
+inline Vector<T, N> SolveLUHelper(const Matrix<T, N, N>& lu,
+                                  const Vector<int, N>& pivots,
+                                  const Vector<T, N>& b) {
+  Vector<T, N> x = b;
+  for (int k = 0; k < N; ++k) {
+    const int pivot = pivots[k];
+    if (pivot != k) {
+      const T temp = x[k];
+      x[k] = x[pivot];
+      x[pivot] = temp;
+    }
+  }
+  // Forward substitution with L, whose diagonal is 1.
+  for (int k = 0; k < N; ++k) {
+    const T xk = x[k];
+    for (int i = k + 1; i < N; ++i) x[i] -= lu(i, k) * xk;
+  }
+  // Back substitution with U.
+  for (int k = N - 1; k >= 0; --k) {
+    x[k] /= lu(k, k);
+    const T xk = x[k];
+    for (int i = 0; i < k; ++i) x[i] -= lu(i, k) * xk;
+  }
+  return x;
+}
+
+// Right-looking Cholesky factorization, which updates the remaining columns
+// with column Vector operations like FactorizeLUHelper().
+template <class T, int N>
+inline bool FactorizeCholeskyHelper(const Matrix<T, N, N>& m,
+                                    Matrix<T, N, N>* const l,
+                                    T pivot_thresh) {
+  Matrix<T, N, N>& a = *l;
+  a = m;
+  for (int k = 0; k < N; ++k) {
+    const T diagonal = a(k, k);
+    if (!(diagonal > static_cast<T>(0)) || diagonal < pivot_thresh) {
+      return false;
+    }
+    Vector<T, N>& column = a.GetColumn(k);
+    for (int i = 0; i < k; ++i) column[i] = static_cast<T>(0);
+    column *= 1 / sqrt(diagonal);
+    for (int j = k + 1; j < N; ++j) a.GetColumn(j) -= column * column[j];
+  }
+  return true;
+}
+
+template <class T, int N>
+inline Vector<T, N> SolveCholeskyHelper(const Matrix<T, N, N>& l,
+                                        const Vector<T, N>& b) {
+  Vector<T, N> x = b;
+  // Forward substitution with L.
+  for (int k = 0; k < N; ++k) {
+    x[k] /= l(k, k);
+    const T xk = x[k];
+    for (int i = k + 1; i < N; ++i) x[i] -= l(i, k) * xk;
+  }
+  // Back substitution with the transpose of L.
+  for (int k = N - 1; k >= 0; --k) {
+    T sum = x[k];
+    for (int i = k + 1; i < N; ++i) sum -= l(i, k) * x[i];
+    x[k] = sum / l(k, k);
+  }
+  return x;
 }
 /// @endcond
 
@@ -1306,6 +1669,34 @@ inline bool InverseHelper(const Matrix<T, 3, 3>& m,
 }
 /// @endcond
 
+#ifdef MATHFU_COMPILE_WITH_SIMD
+/// @cond MATHFU_INTERNAL
+// Each row of the inverse is the cross product of two columns of m divided
+// by the determinant, so the inverse is calculated with Vector cross
+// products and a transpose.
+template <bool check_invertible>
+inline bool InverseHelper(const Matrix<float, 3, 3>& m,
+                          Matrix<float, 3, 3>* const inverse,
+                          float det_thresh) {
+  const Vector<float, 3> row0 =
+      Vector<float, 3>::CrossProduct(m.data_[1], m.data_[2]);
+  const float determinant = Vector<float, 3>::DotProduct(m.data_[0], row0);
+  if (check_invertible && fabs(determinant) < det_thresh) {
+    return false;
+  }
+  const float inverse_determinant = 1 / determinant;
+  Matrix<float, 3, 3> rows;
+  rows.data_[0] = row0 * inverse_determinant;
+  rows.data_[1] = Vector<float, 3>::CrossProduct(m.data_[2], m.data_[0]) *
+                  inverse_determinant;
+  rows.data_[2] = Vector<float, 3>::CrossProduct(m.data_[0], m.data_[1]) *
+                  inverse_determinant;
+  *inverse = rows.Transpose();
+  return true;
+}
+/// @endcond
+#endif  // MATHFU_COMPILE_WITH_SIMD
+
 /// @cond MATHFU_INTERNAL
 template <class T>
 inline int FindLargestPivotElem(const Matrix<T, 4, 4>& m) {
@@ -1413,6 +1804,117 @@ bool InverseHelper(const Matrix<T, 4, 4>& m, Matrix<T, 4, 4>* const inverse,
 }
 /// @endcond
 
+#ifdef MATHFU_COMPILE_WITH_SSE2
+/// @cond MATHFU_INTERNAL
+// Shuffle the elements of a register holding a 2x2 matrix.
+#define MATHFU_SWIZZLE_PS(v, x, y, z, w) \
+  _mm_shuffle_ps((v), (v), _MM_SHUFFLE((w), (z), (y), (x)))
+
+// Products of 2x2 matrices stored in registers as (m00, m01, m10, m11),
+// where adjugate() is the adjugate of a matrix.
+inline __m128 Matrix2x2Multiply(const __m128& a, const __m128& b) {
+  return _mm_add_ps(
+      _mm_mul_ps(a, MATHFU_SWIZZLE_PS(b, 0, 3, 0, 3)),
+      _mm_mul_ps(MATHFU_SWIZZLE_PS(a, 1, 0, 3, 2),
+                 MATHFU_SWIZZLE_PS(b, 2, 1, 2, 1)));
+}
+
+// adjugate(a) * b
+inline __m128 Matrix2x2AdjugateMultiply(const __m128& a, const __m128& b) {
+  return _mm_sub_ps(_mm_mul_ps(MATHFU_SWIZZLE_PS(a, 3, 3, 0, 0), b),
+                    _mm_mul_ps(MATHFU_SWIZZLE_PS(a, 1, 1, 2, 2),
+                               MATHFU_SWIZZLE_PS(b, 2, 3, 0, 1)));
+}
+
+// a * adjugate(b)
+inline __m128 Matrix2x2MultiplyAdjugate(const __m128& a, const __m128& b) {
+  return _mm_sub_ps(
+      _mm_mul_ps(a, MATHFU_SWIZZLE_PS(b, 3, 0, 3, 0)),
+      _mm_mul_ps(MATHFU_SWIZZLE_PS(a, 1, 0, 3, 2),
+                 MATHFU_SWIZZLE_PS(b, 2, 1, 2, 1)));
+}
+
+// Invert a 4x4 matrix by splitting it into 2x2 blocks, which are combined
+// using the adjugates of the blocks while held in registers.  The columns
+// of the matrix are treated as rows, which inverts the transpose of the
+// matrix so each resulting row is a column of the inverse.
+template <bool check_invertible>
+inline bool InverseHelper(const Matrix<float, 4, 4>& m,
+                          Matrix<float, 4, 4>* const inverse,
+                          float det_thresh) {
+  const __m128 c0 = m.data_[0].simd4;
+  const __m128 c1 = m.data_[1].simd4;
+  const __m128 c2 = m.data_[2].simd4;
+  const __m128 c3 = m.data_[3].simd4;
+  const __m128 a = _mm_movelh_ps(c0, c1);
+  const __m128 b = _mm_movehl_ps(c1, c0);
+  const __m128 c = _mm_movelh_ps(c2, c3);
+  const __m128 d = _mm_movehl_ps(c3, c2);
+  // Determinants of the blocks (|a|, |b|, |c|, |d|).
+  const __m128 block_determinants = _mm_sub_ps(
+      _mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(2, 0, 2, 0)),
+                 _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(3, 1, 3, 1))),
+      _mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(3, 1, 3, 1)),
+                 _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(2, 0, 2, 0))));
+  const __m128 det_a = MATHFU_SWIZZLE_PS(block_determinants, 0, 0, 0, 0);
+  const __m128 det_b = MATHFU_SWIZZLE_PS(block_determinants, 1, 1, 1, 1);
+  const __m128 det_c = MATHFU_SWIZZLE_PS(block_determinants, 2, 2, 2, 2);
+  const __m128 det_d = MATHFU_SWIZZLE_PS(block_determinants, 3, 3, 3, 3);
+  const __m128 adj_d_c = Matrix2x2AdjugateMultiply(d, c);
+  const __m128 adj_a_b = Matrix2x2AdjugateMultiply(a, b);
+  // Adjugates of the blocks of the inverse scaled by the determinant.
+  const __m128 x = _mm_sub_ps(_mm_mul_ps(det_d, a),
+                              Matrix2x2Multiply(b, adj_d_c));
+  const __m128 w = _mm_sub_ps(_mm_mul_ps(det_a, d),
+                              Matrix2x2Multiply(c, adj_a_b));
+  const __m128 y = _mm_sub_ps(_mm_mul_ps(det_b, c),
+                              Matrix2x2MultiplyAdjugate(d, adj_a_b));
+  const __m128 z = _mm_sub_ps(_mm_mul_ps(det_c, b),
+                              Matrix2x2MultiplyAdjugate(a, adj_d_c));
+  // |m| = |a||d| + |b||c| - trace(adjugate(a) b adjugate(d) c)
+  __m128 trace =
+      _mm_mul_ps(adj_a_b, MATHFU_SWIZZLE_PS(adj_d_c, 0, 2, 1, 3));
+  trace = _mm_add_ps(trace, _mm_movehl_ps(trace, trace));
+  trace = _mm_add_ss(trace, MATHFU_SWIZZLE_PS(trace, 1, 1, 1, 1));
+  const __m128 determinant = _mm_sub_ps(
+      _mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c)),
+      MATHFU_SWIZZLE_PS(trace, 0, 0, 0, 0));
+  if (check_invertible) {
+    // Match the generic implementation, which rejects a small pivot, the
+    // largest element of the first column, and compares the determinant of
+    // the 3x3 matrix remaining after pivoting, i.e. the determinant divided
+    // by the pivot.
+    const __m128 abs_c0 = _mm_andnot_ps(_mm_set1_ps(-0.0f), c0);
+    __m128 pivot = _mm_max_ps(abs_c0, _mm_movehl_ps(abs_c0, abs_c0));
+    pivot = _mm_max_ss(pivot, MATHFU_SWIZZLE_PS(pivot, 1, 1, 1, 1));
+    const float pivot_magnitude = _mm_cvtss_f32(pivot);
+    if (pivot_magnitude < Constants<float>::GetDeterminantThreshold() ||
+        fabs(_mm_cvtss_f32(determinant)) < det_thresh * pivot_magnitude) {
+      return false;
+    }
+  }
+  const __m128 scale =
+      _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), determinant);
+  const __m128 x_scaled = _mm_mul_ps(x, scale);
+  const __m128 y_scaled = _mm_mul_ps(y, scale);
+  const __m128 z_scaled = _mm_mul_ps(z, scale);
+  const __m128 w_scaled = _mm_mul_ps(w, scale);
+  // Swap the diagonals of each block to complete the adjugates while
+  // gathering the columns of the inverse.
+  inverse->data_[0].simd4 =
+      _mm_shuffle_ps(x_scaled, y_scaled, _MM_SHUFFLE(1, 3, 1, 3));
+  inverse->data_[1].simd4 =
+      _mm_shuffle_ps(x_scaled, y_scaled, _MM_SHUFFLE(0, 2, 0, 2));
+  inverse->data_[2].simd4 =
+      _mm_shuffle_ps(z_scaled, w_scaled, _MM_SHUFFLE(1, 3, 1, 3));
+  inverse->data_[3].simd4 =
+      _mm_shuffle_ps(z_scaled, w_scaled, _MM_SHUFFLE(0, 2, 0, 2));
+  return true;
+}
+#undef MATHFU_SWIZZLE_PS
+/// @endcond
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
 /// @cond MATHFU_INTERNAL
 /// Create a 4x4 perpective matrix.
 template <class T>
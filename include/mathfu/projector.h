@@ -0,0 +1,214 @@
+/*
+* Copyright 2016 Google Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef MATHFU_PROJECTOR_H_
+#define MATHFU_PROJECTOR_H_
+
+#include "mathfu/matrix.h"
+#include "mathfu/vector.h"
+
+#include <stddef.h>
+
+namespace mathfu {
+
+/// @addtogroup mathfu_matrix
+/// @{
+/// @class Projector "mathfu/projector.h"
+/// @brief Maps points between object space and window coordinates.
+///
+/// Matrix::UnProject() multiplies and inverts the model view and projection
+/// matrices on every call.  Projector performs that work once on construction
+/// so mapping a point afterwards is a viewport scale, a single 4x4 transform
+/// and the perspective divide.  The array versions of UnProject() and
+/// Project() are intended for mouse picking or screen space reconstruction
+/// over many samples.
+///
+/// Window coordinates use the same conventions as Matrix::UnProject(): x and
+/// y are in pixels and z is the depth in the range [0, 1] where 0 is the near
+/// plane and 1 is the far plane.
+///
+/// @tparam T type of each element in the matrices and vectors.
+template <class T>
+class Projector {
+ public:
+  /// @brief Create a Projector that maps a 1x1 window with identity model
+  /// view and projection matrices.
+  inline Projector()
+      : view_projection_(Matrix<T, 4, 4>::Identity()),
+        inverse_view_projection_(Matrix<T, 4, 4>::Identity()),
+        half_window_size_(static_cast<T>(0.5), static_cast<T>(0.5),
+                          static_cast<T>(0.5)),
+        inverse_half_window_size_(static_cast<T>(2)) {}
+
+  /// @brief Create a Projector from camera matrices and a window size.
+  ///
+  /// @param model_view The Model View matrix.
+  /// @param projection The projection matrix.
+  /// @param window_width Width of the window.
+  /// @param window_height Height of the window.
+  inline Projector(const Matrix<T, 4, 4>& model_view,
+                   const Matrix<T, 4, 4>& projection, T window_width,
+                   T window_height) {
+    Set(model_view, projection, window_width, window_height);
+  }
+
+  /// @brief Recalculate the cached matrices, for example when the camera
+  /// moves or the window is resized.
+  ///
+  /// @param model_view The Model View matrix.
+  /// @param projection The projection matrix.
+  /// @param window_width Width of the window.
+  /// @param window_height Height of the window.
+  inline void Set(const Matrix<T, 4, 4>& model_view,
+                  const Matrix<T, 4, 4>& projection, T window_width,
+                  T window_height) {
+    view_projection_ = projection * model_view;
+    inverse_view_projection_ = view_projection_.Inverse();
+    half_window_size_ =
+        Vector<T, 3>(window_width, window_height, static_cast<T>(1)) *
+        static_cast<T>(0.5);
+    inverse_half_window_size_ = Vector<T, 3>(static_cast<T>(2) / window_width,
+                                             static_cast<T>(2) / window_height,
+                                             static_cast<T>(2));
+  }
+
+  /// @brief Get the 3D position in object space from a window coordinate.
+  ///
+  /// @param window_coord The window coordinate.  The z value is the depth
+  /// and must be within [0, 1].
+  /// @param result Receives the position in object space.
+  /// @return true if the coordinate could be mapped, false if the depth is
+  /// out of range or the point maps to infinity.  result is not modified
+  /// when false is returned.
+  inline bool UnProject(const Vector<T, 3>& window_coord,
+                        Vector<T, 3>* const result) const {
+    if (window_coord.z < static_cast<T>(0) ||
+        window_coord.z > static_cast<T>(1)) {
+      return false;
+    }
+    // Map to normalized device coordinates in [-1, 1].
+    const Vector<T, 3> normalized =
+        window_coord * inverse_half_window_size_ - Vector<T, 3>(static_cast<T>(1));
+    return TransformAndDivide(inverse_view_projection_, normalized, result);
+  }
+
+  /// @brief Get the 3D positions in object space from an array of window
+  /// coordinates.
+  ///
+  /// @param window_coords Array of count window coordinates.
+  /// @param count Number of coordinates to map.
+  /// @param results Array of count positions which receives the result.
+  /// Entries which can't be mapped (see UnProject()) are set to zero.
+  /// results may alias window_coords.
+  /// @return Number of coordinates that were successfully mapped.
+  inline size_t UnProject(const Vector<T, 3>* window_coords, size_t count,
+                          Vector<T, 3>* results) const {
+    size_t mapped = 0;
+    for (size_t i = 0; i < count; ++i) {
+      const Vector<T, 3> window_coord = window_coords[i];
+      if (UnProject(window_coord, &results[i])) {
+        mapped++;
+      } else {
+        results[i] = Vector<T, 3>(static_cast<T>(0));
+      }
+    }
+    return mapped;
+  }
+
+  /// @brief Get the window coordinate of a 3D position in object space.
+  ///
+  /// @param position The position in object space.
+  /// @param window_coord Receives the window coordinate.  The z value is the
+  /// depth, 0 on the near plane and 1 on the far plane.
+  /// @return true if the position could be mapped, false if it maps to
+  /// infinity.  window_coord is not modified when false is returned.
+  inline bool Project(const Vector<T, 3>& position,
+                      Vector<T, 3>* const window_coord) const {
+    Vector<T, 3> normalized;
+    if (!TransformAndDivide(view_projection_, position, &normalized)) {
+      return false;
+    }
+    *window_coord = (normalized + Vector<T, 3>(static_cast<T>(1))) * half_window_size_;
+    return true;
+  }
+
+  /// @brief Get the window coordinates of an array of 3D positions.
+  ///
+  /// @param positions Array of count positions in object space.
+  /// @param count Number of positions to map.
+  /// @param window_coords Array of count window coordinates which receives
+  /// the result.  Entries which can't be mapped are set to zero.
+  /// window_coords may alias positions.
+  /// @return Number of positions that were successfully mapped.
+  inline size_t Project(const Vector<T, 3>* positions, size_t count,
+                        Vector<T, 3>* window_coords) const {
+    size_t mapped = 0;
+    for (size_t i = 0; i < count; ++i) {
+      const Vector<T, 3> position = positions[i];
+      if (Project(position, &window_coords[i])) {
+        mapped++;
+      } else {
+        window_coords[i] = Vector<T, 3>(static_cast<T>(0));
+      }
+    }
+    return mapped;
+  }
+
+  /// @brief Get the cached view projection matrix.
+  ///
+  /// @return projection * model_view.
+  inline const Matrix<T, 4, 4>& view_projection() const {
+    return view_projection_;
+  }
+
+  /// @brief Get the cached inverse view projection matrix.
+  ///
+  /// @return (projection * model_view).Inverse().
+  inline const Matrix<T, 4, 4>& inverse_view_projection() const {
+    return inverse_view_projection_;
+  }
+
+  MATHFU_DEFINE_CLASS_SIMD_AWARE_NEW_DELETE
+
+ private:
+  /// @cond MATHFU_INTERNAL
+  // Transform a point by a linear combination of the matrix columns, which
+  // maps directly onto SIMD multiply-add operations for Vector<float, 4>,
+  // then apply the perspective divide.
+  static inline bool TransformAndDivide(const Matrix<T, 4, 4>& m,
+                                        const Vector<T, 3>& point,
+                                        Vector<T, 3>* const result) {
+    const Vector<T, 4> transformed =
+        m.GetColumn(0) * point.x + m.GetColumn(1) * point.y +
+        m.GetColumn(2) * point.z + m.GetColumn(3);
+    if (transformed.w == static_cast<T>(0)) {
+      return false;
+    }
+    *result = transformed.xyz() * (static_cast<T>(1) / transformed.w);
+    return true;
+  }
+
+  /// @endcond
+
+  Matrix<T, 4, 4> view_projection_;
+  Matrix<T, 4, 4> inverse_view_projection_;
+  Vector<T, 3> half_window_size_;
+  Vector<T, 3> inverse_half_window_size_;
+};
+/// @}
+
+}  // namespace mathfu
+
+#endif  // MATHFU_PROJECTOR_H_
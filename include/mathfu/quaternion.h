@@ -26,6 +26,11 @@
 #include "mathfu/vector.h"
 
 #include <math.h>
+#include <stddef.h>
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+#include <emmintrin.h>
+#endif  // MATHFU_COMPILE_WITH_SSE2
 
 /// @file mathfu/quaternion.h
 /// @brief Quaternion class and functions.
@@ -413,6 +418,107 @@ class Quaternion {
     return q1 * ((q1.Inverse() * q2) * s1);
   }
 
+  /// @brief Calculate an approximation of the shortest-path spherical linear
+  /// interpolation between two orientations.
+  ///
+  /// The Slerp() weights sin((1 - s1) * angle) / sin(angle) and
+  /// sin(s1 * angle) / sin(angle) are evaluated with a polynomial in
+  /// cos(angle) (see David Eberly, "A Fast and Accurate Algorithm for
+  /// Computing SLERP"), so no trigonometric functions, square roots or
+  /// divisions are required.  For unit quaternions each weight is within
+  /// 3.7e-6 of the exact value which bounds the error of each component of
+  /// the result to 7.5e-6 plus rounding.
+  ///
+  /// @param q1 Start Quaternion.
+  /// @param q2 End Quaternion.
+  /// @param s1 The scalar value determining how far from q1 and q2 the
+  /// resulting quaternion should be.  A value of 0 corresponds to q1 and a
+  /// value of 1 corresponds to q2.
+  /// @result Quaternion containing the result.
+  static inline Quaternion<T> SlerpFast(const Quaternion<T>& q1,
+                                        const Quaternion<T>& q2, T s1) {
+    T cos_angle = DotProduct(q1, q2);
+    T sign = static_cast<T>(1);
+    if (cos_angle < static_cast<T>(0)) {
+      cos_angle = -cos_angle;
+      sign = static_cast<T>(-1);
+    }
+    return SlerpFastWeighted(q1, q2, s1, cos_angle, sign);
+  }
+
+  /// @brief Calculate an approximation of the spherical linear interpolation
+  /// between two quaternions which does not take the shortest path.
+  ///
+  /// Unlike SlerpFast(), q2 is never negated so the result is continuous in
+  /// q1 and q2, as required by Squad().  When the dot product of q1 and q2
+  /// is negative the arc is split at its midpoint and each half is
+  /// approximated like SlerpFast(), which requires one square root.  The
+  /// error bound of SlerpFast() applies, q1 and q2 must not be opposite.
+  ///
+  /// @param q1 Start Quaternion.
+  /// @param q2 End Quaternion.
+  /// @param s1 The scalar value determining how far from q1 and q2 the
+  /// resulting quaternion should be.  A value of 0 corresponds to q1 and a
+  /// value of 1 corresponds to q2.
+  /// @result Quaternion containing the result.
+  static inline Quaternion<T> SlerpFastNoFlip(const Quaternion<T>& q1,
+                                              const Quaternion<T>& q2, T s1) {
+    const T cos_angle = DotProduct(q1, q2);
+    if (cos_angle >= static_cast<T>(0)) {
+      return SlerpFastWeighted(q1, q2, s1, cos_angle, static_cast<T>(1));
+    }
+    const Quaternion<T> middle =
+        Quaternion<T>(q1.s_ + q2.s_, q1.v_ + q2.v_).Normalized();
+    const T cos_half_angle = DotProduct(q1, middle);
+    const T s = s1 * static_cast<T>(2);
+    return s < static_cast<T>(1)
+               ? SlerpFastWeighted(q1, middle, s, cos_half_angle,
+                                   static_cast<T>(1))
+               : SlerpFastWeighted(middle, q2, s - static_cast<T>(1),
+                                   cos_half_angle, static_cast<T>(1));
+  }
+
+  /// @brief Calculate a normalized linear interpolation between two
+  /// orientations which approximates Slerp().
+  ///
+  /// A plain normalized lerp follows the same path as Slerp() at a
+  /// non-constant speed, which results in a component error of up to 0.068.
+  /// This corrects s1 with a polynomial fitted to the angle between the
+  /// quaternions (see Arseny Kapoulkine, "Approximating slerp") so the result
+  /// is within 3.4e-4 of Slerp() per component for unit quaternions.  This
+  /// is cheaper than SlerpFast() but requires one square root to normalize
+  /// the result.
+  ///
+  /// @param q1 Start Quaternion.
+  /// @param q2 End Quaternion.
+  /// @param s1 The scalar value determining how far from q1 and q2 the
+  /// resulting quaternion should be.  A value of 0 corresponds to q1 and a
+  /// value of 1 corresponds to q2.
+  /// @result Quaternion containing the result.
+  static inline Quaternion<T> Nlerp(const Quaternion<T>& q1,
+                                    const Quaternion<T>& q2, T s1) {
+    T cos_angle = DotProduct(q1, q2);
+    T sign = static_cast<T>(1);
+    if (cos_angle < static_cast<T>(0)) {
+      cos_angle = -cos_angle;
+      sign = static_cast<T>(-1);
+    }
+    const T a = static_cast<T>(1.0904) +
+                cos_angle * (static_cast<T>(-3.2452) +
+                             cos_angle * (static_cast<T>(3.55645) -
+                                          cos_angle * static_cast<T>(1.43519)));
+    const T b = static_cast<T>(0.848013) +
+                cos_angle * (static_cast<T>(-1.06021) +
+                             cos_angle * static_cast<T>(0.215638));
+    const T centered = s1 - static_cast<T>(0.5);
+    const T k = a * centered * centered + b;
+    const T s = s1 + s1 * centered * (s1 - static_cast<T>(1)) * k;
+    const T w1 = static_cast<T>(1) - s;
+    const T w2 = s * sign;
+    return Quaternion<T>(q1.s_ * w1 + q2.s_ * w2, q1.v_ * w1 + q2.v_ * w2)
+        .Normalized();
+  }
+
   /// @brief Access an element of the quaternion.
   ///
   /// @param i Index of the element to access.
@@ -598,6 +704,47 @@ class Quaternion {
   MATHFU_DEFINE_CLASS_SIMD_AWARE_NEW_DELETE
 
  private:
+  /// @cond MATHFU_INTERNAL
+  // Evaluates sin(s * angle) / sin(angle) given cos(angle) - 1 using the
+  // first terms of its power series in cos(angle) - 1.  The last term is
+  // scaled to compensate for the truncated terms when cos(angle) is small.
+  static inline T SlerpFastWeight(T s, T cos_angle_minus_one) {
+    // u[i] = 1 / ((i + 1) * (2 * i + 3)), v[i] = (i + 1) / (2 * i + 3)
+    static const T kCorrection = static_cast<T>(1.8768);
+    static const T u[] = {
+        static_cast<T>(1.0 / 3.0),   static_cast<T>(1.0 / 10.0),
+        static_cast<T>(1.0 / 21.0),  static_cast<T>(1.0 / 36.0),
+        static_cast<T>(1.0 / 55.0),  static_cast<T>(1.0 / 78.0),
+        static_cast<T>(1.0 / 105.0), static_cast<T>(1.0 / 136.0),
+        static_cast<T>(1.0 / 171.0), kCorrection / static_cast<T>(210)};
+    static const T v[] = {
+        static_cast<T>(1.0 / 3.0),  static_cast<T>(2.0 / 5.0),
+        static_cast<T>(3.0 / 7.0),  static_cast<T>(4.0 / 9.0),
+        static_cast<T>(5.0 / 11.0), static_cast<T>(6.0 / 13.0),
+        static_cast<T>(7.0 / 15.0), static_cast<T>(8.0 / 17.0),
+        static_cast<T>(9.0 / 19.0), kCorrection * static_cast<T>(10.0 / 21.0)};
+    const T s_squared = s * s;
+    T weight = static_cast<T>(1);
+    for (int i = static_cast<int>(sizeof(u) / sizeof(u[0])) - 1; i >= 0;
+         --i) {
+      weight = static_cast<T>(1) +
+               (u[i] * s_squared - v[i]) * cos_angle_minus_one * weight;
+    }
+    return s * weight;
+  }
+
+  // Interpolates between q1 and sign * q2 with the SlerpFast() weights given
+  // the non-negative cosine of the angle between them.
+  static inline Quaternion<T> SlerpFastWeighted(const Quaternion<T>& q1,
+                                                const Quaternion<T>& q2, T s1,
+                                                T cos_angle, T sign) {
+    const T cos_angle_minus_one = cos_angle - static_cast<T>(1);
+    const T w1 = SlerpFastWeight(static_cast<T>(1) - s1, cos_angle_minus_one);
+    const T w2 = SlerpFastWeight(s1, cos_angle_minus_one) * sign;
+    return Quaternion<T>(q1.s_ * w1 + q2.s_ * w2, q1.v_ * w1 + q2.v_ * w2);
+  }
+  /// @endcond
+
   Vector<T, 3> v_;
   T s_;
 };
@@ -622,6 +769,76 @@ template <class T>
 inline Quaternion<T> operator*(T s, const Quaternion<T>& q) {
   return q * s;
 }
+
+/// @brief Normalize an array of quaternions (in-place).
+///
+/// This corrects the drift accumulated by repeatedly multiplying rotations.
+///
+/// @param quaternions Array of count quaternions to normalize, which must
+/// not have zero length.
+/// @param count Number of quaternions.
+template <class T>
+inline void NormalizeQuaternions(Quaternion<T>* quaternions, size_t count) {
+  for (size_t i = 0; i < count; ++i) quaternions[i].Normalize();
+}
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+/// @brief Normalize an array of float quaternions (in-place).
+///
+/// Quaternions are normalized 4 at a time using a reciprocal square root
+/// estimate refined by one Newton-Raphson step, which is much cheaper than
+/// the square root and division of Quaternion::Normalize().  The length of
+/// each result differs from 1 by less than 5e-7.
+///
+/// @param quaternions Array of count quaternions to normalize, which must
+/// not have zero length.
+/// @param count Number of quaternions.
+inline void NormalizeQuaternions(Quaternion<float>* quaternions,
+                                 size_t count) {
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 three = _mm_set1_ps(3.0f);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    Quaternion<float>* const q = &quaternions[i];
+    __m128 e[4];
+    if (sizeof(Quaternion<float>) == 4 * sizeof(float)) {
+      // The elements of each quaternion are contiguous (in the order x, y,
+      // z, s) so load them directly and transpose.
+      for (int j = 0; j < 4; ++j) {
+        e[j] = _mm_loadu_ps(reinterpret_cast<const float*>(&q[j]));
+      }
+    } else {
+      for (int j = 0; j < 4; ++j) {
+        e[j] = _mm_setr_ps(q[j][0], q[j][1], q[j][2], q[j][3]);
+      }
+    }
+    _MM_TRANSPOSE4_PS(e[0], e[1], e[2], e[3]);
+    const __m128 length_squared = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(e[0], e[0]), _mm_mul_ps(e[1], e[1])),
+        _mm_add_ps(_mm_mul_ps(e[2], e[2]), _mm_mul_ps(e[3], e[3])));
+    // y = y * (3 - x * y * y) / 2
+    const __m128 estimate = _mm_rsqrt_ps(length_squared);
+    const __m128 scale = _mm_mul_ps(
+        _mm_mul_ps(half, estimate),
+        _mm_sub_ps(three,
+                   _mm_mul_ps(_mm_mul_ps(length_squared, estimate), estimate)));
+    for (int j = 0; j < 4; ++j) e[j] = _mm_mul_ps(e[j], scale);
+    _MM_TRANSPOSE4_PS(e[0], e[1], e[2], e[3]);
+    if (sizeof(Quaternion<float>) == 4 * sizeof(float)) {
+      for (int j = 0; j < 4; ++j) {
+        _mm_storeu_ps(reinterpret_cast<float*>(&q[j]), e[j]);
+      }
+    } else {
+      for (int j = 0; j < 4; ++j) {
+        float f[4];
+        _mm_storeu_ps(f, e[j]);
+        q[j] = Quaternion<float>(f[0], f[1], f[2], f[3]);
+      }
+    }
+  }
+  for (; i < count; ++i) quaternions[i].Normalize();
+}
+#endif  // MATHFU_COMPILE_WITH_SSE2
 /// @}
 
 }  // namespace mathfu
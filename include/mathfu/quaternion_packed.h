@@ -0,0 +1,518 @@
+/*
+* Copyright 2016 Google Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef MATHFU_QUATERNION_PACKED_H_
+#define MATHFU_QUATERNION_PACKED_H_
+
+#include "mathfu/quaternion.h"
+#include "mathfu/utilities.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+#include <emmintrin.h>
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
+/// @file mathfu/quaternion_packed.h
+/// @brief Compressed storage formats for rotation quaternions.
+///
+/// The smallest-three formats drop the component with the largest magnitude,
+/// which is recovered from the unit length constraint, and store the
+/// remaining components, which are within [-1/sqrt(2), 1/sqrt(2)], as
+/// fixed point values.  The sign of the quaternion is chosen so that the
+/// dropped component is positive, so unpacking may return the negated
+/// quaternion which represents the same orientation.
+///
+/// Packed quaternions should be unit length.
+
+namespace mathfu {
+
+/// @cond MATHFU_INTERNAL
+// Fixed point encoding of the smallest three components of a quaternion
+// using kBits bits per component.
+template <int kBits>
+class QuaternionSmallestThree {
+ public:
+  static const uint32_t kMask = (1U << kBits) - 1U;
+
+  // Components of q in the order s, x, y, z.
+  static inline void Pack(const Quaternion<float>& q, uint32_t* index,
+                          uint32_t* a, uint32_t* b, uint32_t* c) {
+    const float components[] = {q[0], q[1], q[2], q[3]};
+    uint32_t largest = 0;
+    float largest_abs = fabsf(components[0]);
+    for (uint32_t i = 1; i < 4; ++i) {
+      const float component_abs = fabsf(components[i]);
+      if (component_abs > largest_abs) {
+        largest = i;
+        largest_abs = component_abs;
+      }
+    }
+    const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+    uint32_t* const outputs[] = {a, b, c};
+    for (uint32_t i = 0, j = 0; i < 4; ++i) {
+      if (i != largest) *outputs[j++] = Quantize(components[i] * sign);
+    }
+    *index = largest;
+  }
+
+  static inline Quaternion<float> Unpack(uint32_t index, uint32_t a,
+                                         uint32_t b, uint32_t c) {
+    const float fa = Dequantize(a);
+    const float fb = Dequantize(b);
+    const float fc = Dequantize(c);
+    const float fd =
+        sqrtf(std::max(0.0f, 1.0f - (fa * fa + fb * fb + fc * fc)));
+    switch (index) {
+      case 0:
+        return Quaternion<float>(fd, fa, fb, fc);
+      case 1:
+        return Quaternion<float>(fa, fd, fb, fc);
+      case 2:
+        return Quaternion<float>(fa, fb, fd, fc);
+      default:
+        return Quaternion<float>(fa, fb, fc, fd);
+    }
+  }
+
+  static inline float Scale() {
+    return 1.41421356f / static_cast<float>(kMask);
+  }
+  static inline float InverseScale() {
+    return static_cast<float>(kMask) / 1.41421356f;
+  }
+  static inline float Offset() { return -0.707106781f; }
+
+ private:
+  static inline uint32_t Quantize(float value) {
+    const float quantized = floorf((value - Offset()) * InverseScale() + 0.5f);
+    return static_cast<uint32_t>(
+        Clamp(quantized, 0.0f, static_cast<float>(kMask)));
+  }
+
+  static inline float Dequantize(uint32_t value) {
+    return static_cast<float>(value) * Scale() + Offset();
+  }
+};
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+// Selects components from a where mask is set and from b elsewhere.
+inline __m128 QuaternionPackedSelect(__m128i mask, __m128 a, __m128 b) {
+  const __m128 m = _mm_castsi128_ps(mask);
+  return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+}
+
+// Unpack 4 smallest-three encoded quaternions from SoA registers.
+template <int kBits>
+inline void QuaternionSmallestThreeUnpack4(__m128i index, __m128i a,
+                                           __m128i b, __m128i c,
+                                           Quaternion<float>* output) {
+  typedef QuaternionSmallestThree<kBits> Encoding;
+  const __m128 scale = _mm_set1_ps(Encoding::Scale());
+  const __m128 offset = _mm_set1_ps(Encoding::Offset());
+  const __m128 fa = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(a), scale), offset);
+  const __m128 fb = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(b), scale), offset);
+  const __m128 fc = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(c), scale), offset);
+  const __m128 sum = _mm_add_ps(
+      _mm_add_ps(_mm_mul_ps(fa, fa), _mm_mul_ps(fb, fb)), _mm_mul_ps(fc, fc));
+  const __m128 fd = _mm_sqrt_ps(
+      _mm_max_ps(_mm_setzero_ps(), _mm_sub_ps(_mm_set1_ps(1.0f), sum)));
+  const __m128i is0 = _mm_cmpeq_epi32(index, _mm_setzero_si128());
+  const __m128i is1 = _mm_cmpeq_epi32(index, _mm_set1_epi32(1));
+  const __m128i is2 = _mm_cmpeq_epi32(index, _mm_set1_epi32(2));
+  const __m128i is3 = _mm_cmpeq_epi32(index, _mm_set1_epi32(3));
+  // Insert the largest component at index, shifting the others up.
+  union {
+    __m128 simd[4];
+    float lanes[4][4];
+  } components;
+  components.simd[0] = QuaternionPackedSelect(is0, fd, fa);
+  components.simd[1] = QuaternionPackedSelect(
+      is0, fa, QuaternionPackedSelect(is1, fd, fb));
+  components.simd[2] = QuaternionPackedSelect(
+      is3, fc, QuaternionPackedSelect(is2, fd, fb));
+  components.simd[3] = QuaternionPackedSelect(is3, fd, fc);
+  for (int i = 0; i < 4; ++i) {
+    output[i] = Quaternion<float>(components.lanes[0][i],
+                                  components.lanes[1][i],
+                                  components.lanes[2][i],
+                                  components.lanes[3][i]);
+  }
+}
+
+// Quantize 4 components, rounding like QuaternionSmallestThree::Pack().
+template <int kBits>
+inline __m128i QuaternionSmallestThreeQuantize4(__m128 value) {
+  typedef QuaternionSmallestThree<kBits> Encoding;
+  const __m128 biased = _mm_add_ps(
+      _mm_mul_ps(_mm_sub_ps(value, _mm_set1_ps(Encoding::Offset())),
+                 _mm_set1_ps(Encoding::InverseScale())),
+      _mm_set1_ps(0.5f));
+  // Values are clamped to be positive so truncation is the same as floor.
+  return _mm_cvttps_epi32(
+      _mm_min_ps(_mm_set1_ps(static_cast<float>(Encoding::kMask)),
+                 _mm_max_ps(_mm_setzero_ps(), biased)));
+}
+
+// Pack 4 quaternions into smallest-three SoA registers.
+template <int kBits>
+inline void QuaternionSmallestThreePack4(const Quaternion<float>* input,
+                                         __m128i* index, __m128i* a,
+                                         __m128i* b, __m128i* c) {
+  const __m128 s = _mm_setr_ps(input[0][0], input[1][0], input[2][0],
+                               input[3][0]);
+  const __m128 x = _mm_setr_ps(input[0][1], input[1][1], input[2][1],
+                               input[3][1]);
+  const __m128 y = _mm_setr_ps(input[0][2], input[1][2], input[2][2],
+                               input[3][2]);
+  const __m128 z = _mm_setr_ps(input[0][3], input[1][3], input[2][3],
+                               input[3][3]);
+  const __m128 sign_mask = _mm_set1_ps(-0.0f);
+  const __m128 abs_s = _mm_andnot_ps(sign_mask, s);
+  const __m128 abs_x = _mm_andnot_ps(sign_mask, x);
+  const __m128 abs_y = _mm_andnot_ps(sign_mask, y);
+  const __m128 abs_z = _mm_andnot_ps(sign_mask, z);
+  const __m128 largest =
+      _mm_max_ps(_mm_max_ps(abs_s, abs_x), _mm_max_ps(abs_y, abs_z));
+  // Pick the first component with the largest magnitude to match the scalar
+  // implementation.
+  const __m128i is0 = _mm_castps_si128(_mm_cmpeq_ps(abs_s, largest));
+  const __m128i is1 = _mm_andnot_si128(
+      is0, _mm_castps_si128(_mm_cmpeq_ps(abs_x, largest)));
+  const __m128i is2 = _mm_andnot_si128(
+      _mm_or_si128(is0, is1), _mm_castps_si128(_mm_cmpeq_ps(abs_y, largest)));
+  const __m128i is3 = _mm_andnot_si128(
+      _mm_or_si128(_mm_or_si128(is0, is1), is2), _mm_set1_epi32(-1));
+  const __m128 largest_value = _mm_or_ps(
+      _mm_or_ps(_mm_and_ps(_mm_castsi128_ps(is0), s),
+                _mm_and_ps(_mm_castsi128_ps(is1), x)),
+      _mm_or_ps(_mm_and_ps(_mm_castsi128_ps(is2), y),
+                _mm_and_ps(_mm_castsi128_ps(is3), z)));
+  // Flip the sign of all components if the largest component is negative.
+  const __m128 flip = _mm_and_ps(sign_mask, largest_value);
+  const __m128 fa = _mm_xor_ps(flip, QuaternionPackedSelect(is0, x, s));
+  const __m128 fb = _mm_xor_ps(
+      flip, QuaternionPackedSelect(_mm_or_si128(is0, is1), y, x));
+  const __m128 fc = _mm_xor_ps(flip, QuaternionPackedSelect(is3, y, z));
+  *a = QuaternionSmallestThreeQuantize4<kBits>(fa);
+  *b = QuaternionSmallestThreeQuantize4<kBits>(fb);
+  *c = QuaternionSmallestThreeQuantize4<kBits>(fc);
+  *index = _mm_or_si128(
+      _mm_and_si128(is1, _mm_set1_epi32(1)),
+      _mm_or_si128(_mm_and_si128(is2, _mm_set1_epi32(2)),
+                   _mm_and_si128(is3, _mm_set1_epi32(3))));
+}
+#endif  // MATHFU_COMPILE_WITH_SSE2
+/// @endcond
+
+/// @addtogroup mathfu_quaternion
+/// @{
+
+/// @class QuaternionPacked32 "mathfu/quaternion_packed.h"
+/// @brief Rotation quaternion packed into 32 bits.
+///
+/// Uses the smallest-three encoding with 10 bits per component.  The error
+/// of each unpacked component is less than 1.5e-3.
+struct QuaternionPacked32 {
+  /// @brief Create an uninitialized QuaternionPacked32.
+  QuaternionPacked32() {}
+
+  /// @brief Create a QuaternionPacked32 from a unit Quaternion.
+  ///
+  /// @param q Quaternion to pack.
+  explicit QuaternionPacked32(const Quaternion<float>& q) {
+    uint32_t index, a, b, c;
+    QuaternionSmallestThree<10>::Pack(q, &index, &a, &b, &c);
+    data_ = (index << 30) | (a << 20) | (b << 10) | c;
+  }
+
+  /// @brief Unpack this object to a Quaternion.
+  ///
+  /// @return Unit Quaternion which represents the packed orientation.
+  Quaternion<float> Unpack() const {
+    return QuaternionSmallestThree<10>::Unpack(data_ >> 30,
+                                               (data_ >> 20) & 0x3FF,
+                                               (data_ >> 10) & 0x3FF,
+                                               data_ & 0x3FF);
+  }
+
+  /// Bits 30-31 contain the index of the largest component and bits 0-29 the
+  /// other three components.
+  uint32_t data_;
+};
+
+/// @class QuaternionPacked48 "mathfu/quaternion_packed.h"
+/// @brief Rotation quaternion packed into 48 bits.
+///
+/// Uses the smallest-three encoding with 15 bits per component.  The error
+/// of each unpacked component is less than 5e-5.
+struct QuaternionPacked48 {
+  /// @brief Create an uninitialized QuaternionPacked48.
+  QuaternionPacked48() {}
+
+  /// @brief Create a QuaternionPacked48 from a unit Quaternion.
+  ///
+  /// @param q Quaternion to pack.
+  explicit QuaternionPacked48(const Quaternion<float>& q) {
+    uint32_t index, a, b, c;
+    QuaternionSmallestThree<15>::Pack(q, &index, &a, &b, &c);
+    data_[0] = static_cast<uint16_t>(((index & 2) << 14) | a);
+    data_[1] = static_cast<uint16_t>(((index & 1) << 15) | b);
+    data_[2] = static_cast<uint16_t>(c);
+  }
+
+  /// @brief Unpack this object to a Quaternion.
+  ///
+  /// @return Unit Quaternion which represents the packed orientation.
+  Quaternion<float> Unpack() const {
+    return QuaternionSmallestThree<15>::Unpack(
+        ((data_[0] >> 14) & 2) | (data_[1] >> 15), data_[0] & 0x7FFFU,
+        data_[1] & 0x7FFFU, data_[2] & 0x7FFFU);
+  }
+
+  /// Bit 15 of the first two elements contains the index of the largest
+  /// component, bits 0-14 contain the other three components.
+  uint16_t data_[3];
+};
+
+/// @class QuaternionPackedSnorm16 "mathfu/quaternion_packed.h"
+/// @brief Quaternion stored as four 16-bit signed normalized integers.
+///
+/// Components are stored in the order s, x, y, z.  The error of each
+/// unpacked component is less than 1.6e-5.  Unpacked quaternions are not
+/// renormalized.
+struct QuaternionPackedSnorm16 {
+  /// @brief Create an uninitialized QuaternionPackedSnorm16.
+  QuaternionPackedSnorm16() {}
+
+  /// @brief Create a QuaternionPackedSnorm16 from a Quaternion.
+  ///
+  /// @param q Quaternion to pack.  Components are clamped to [-1, 1].
+  explicit QuaternionPackedSnorm16(const Quaternion<float>& q) {
+    for (int i = 0; i < 4; ++i) {
+      data_[i] = static_cast<int16_t>(
+          floorf(Clamp(q[i], -1.0f, 1.0f) * 32767.0f + 0.5f));
+    }
+  }
+
+  /// @brief Unpack this object to a Quaternion.
+  ///
+  /// @return Quaternion containing the unpacked components.
+  Quaternion<float> Unpack() const {
+    const float scale = 1.0f / 32767.0f;
+    return Quaternion<float>(
+        std::max(-1.0f, data_[0] * scale), std::max(-1.0f, data_[1] * scale),
+        std::max(-1.0f, data_[2] * scale), std::max(-1.0f, data_[3] * scale));
+  }
+
+  /// Components in the order s, x, y, z.
+  int16_t data_[4];
+};
+
+/// @brief Pack an array of quaternions.
+///
+/// @param quaternions Array of count unit quaternions to pack.
+/// @param count Number of quaternions.
+/// @param packed Array of count elements which receives the result.
+inline void PackQuaternions(const Quaternion<float>* quaternions, size_t count,
+                            QuaternionPacked32* packed) {
+  size_t i = 0;
+#ifdef MATHFU_COMPILE_WITH_SSE2
+  for (; i + 4 <= count; i += 4) {
+    __m128i index, a, b, c;
+    QuaternionSmallestThreePack4<10>(&quaternions[i], &index, &a, &b, &c);
+    const __m128i data = _mm_or_si128(
+        _mm_or_si128(_mm_slli_epi32(index, 30), _mm_slli_epi32(a, 20)),
+        _mm_or_si128(_mm_slli_epi32(b, 10), c));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&packed[i].data_), data);
+  }
+#endif  // MATHFU_COMPILE_WITH_SSE2
+  for (; i < count; ++i) packed[i] = QuaternionPacked32(quaternions[i]);
+}
+
+/// @brief Unpack an array of quaternions.
+///
+/// The results match Unpack() to within rounding, they may differ by one ULP
+/// where the compiler contracts the scalar conversion into fused
+/// multiply-adds.
+///
+/// @param packed Array of count packed quaternions.
+/// @param count Number of quaternions.
+/// @param quaternions Array of count elements which receives the result.
+inline void UnpackQuaternions(const QuaternionPacked32* packed, size_t count,
+                              Quaternion<float>* quaternions) {
+  size_t i = 0;
+#ifdef MATHFU_COMPILE_WITH_SSE2
+  const __m128i mask = _mm_set1_epi32(0x3FF);
+  for (; i + 4 <= count; i += 4) {
+    const __m128i data =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&packed[i].data_));
+    QuaternionSmallestThreeUnpack4<10>(
+        _mm_srli_epi32(data, 30), _mm_and_si128(_mm_srli_epi32(data, 20), mask),
+        _mm_and_si128(_mm_srli_epi32(data, 10), mask),
+        _mm_and_si128(data, mask), &quaternions[i]);
+  }
+#endif  // MATHFU_COMPILE_WITH_SSE2
+  for (; i < count; ++i) quaternions[i] = packed[i].Unpack();
+}
+
+/// @brief Pack an array of quaternions.
+///
+/// @param quaternions Array of count unit quaternions to pack.
+/// @param count Number of quaternions.
+/// @param packed Array of count elements which receives the result.
+inline void PackQuaternions(const Quaternion<float>* quaternions, size_t count,
+                            QuaternionPacked48* packed) {
+  size_t i = 0;
+#ifdef MATHFU_COMPILE_WITH_SSE2
+  for (; i + 4 <= count; i += 4) {
+    __m128i index, a, b, c;
+    QuaternionSmallestThreePack4<15>(&quaternions[i], &index, &a, &b, &c);
+    union {
+      __m128i simd[3];
+      uint32_t lanes[3][4];
+    } words;
+    words.simd[0] =
+        _mm_or_si128(_mm_slli_epi32(_mm_srli_epi32(index, 1), 15), a);
+    words.simd[1] = _mm_or_si128(
+        _mm_slli_epi32(_mm_and_si128(index, _mm_set1_epi32(1)), 15), b);
+    words.simd[2] = c;
+    for (int j = 0; j < 4; ++j) {
+      for (int k = 0; k < 3; ++k) {
+        packed[i + j].data_[k] = static_cast<uint16_t>(words.lanes[k][j]);
+      }
+    }
+  }
+#endif  // MATHFU_COMPILE_WITH_SSE2
+  for (; i < count; ++i) packed[i] = QuaternionPacked48(quaternions[i]);
+}
+
+/// @brief Unpack an array of quaternions.
+///
+/// The results match Unpack() to within rounding, they may differ by one ULP
+/// where the compiler contracts the scalar conversion into fused
+/// multiply-adds.
+///
+/// @param packed Array of count packed quaternions.
+/// @param count Number of quaternions.
+/// @param quaternions Array of count elements which receives the result.
+inline void UnpackQuaternions(const QuaternionPacked48* packed, size_t count,
+                              Quaternion<float>* quaternions) {
+  size_t i = 0;
+#ifdef MATHFU_COMPILE_WITH_SSE2
+  const __m128i mask = _mm_set1_epi32(0x7FFF);
+  for (; i + 4 <= count; i += 4) {
+    const QuaternionPacked48* const p = &packed[i];
+    const __m128i w0 = _mm_setr_epi32(p[0].data_[0], p[1].data_[0],
+                                      p[2].data_[0], p[3].data_[0]);
+    const __m128i w1 = _mm_setr_epi32(p[0].data_[1], p[1].data_[1],
+                                      p[2].data_[1], p[3].data_[1]);
+    const __m128i w2 = _mm_setr_epi32(p[0].data_[2], p[1].data_[2],
+                                      p[2].data_[2], p[3].data_[2]);
+    const __m128i index =
+        _mm_or_si128(_mm_slli_epi32(_mm_srli_epi32(w0, 15), 1),
+                     _mm_srli_epi32(w1, 15));
+    QuaternionSmallestThreeUnpack4<15>(index, _mm_and_si128(w0, mask),
+                                       _mm_and_si128(w1, mask),
+                                       _mm_and_si128(w2, mask),
+                                       &quaternions[i]);
+  }
+#endif  // MATHFU_COMPILE_WITH_SSE2
+  for (; i < count; ++i) quaternions[i] = packed[i].Unpack();
+}
+
+/// @brief Pack an array of quaternions.
+///
+/// @param quaternions Array of count quaternions to pack.
+/// @param count Number of quaternions.
+/// @param packed Array of count elements which receives the result.
+inline void PackQuaternions(const Quaternion<float>* quaternions, size_t count,
+                            QuaternionPackedSnorm16* packed) {
+  size_t i = 0;
+#ifdef MATHFU_COMPILE_WITH_SSE2
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 minus_one = _mm_set1_ps(-1.0f);
+  const __m128 scale = _mm_set1_ps(32767.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+  for (; i + 2 <= count; i += 2) {
+    __m128i converted[2];
+    for (int j = 0; j < 2; ++j) {
+      const Quaternion<float>& q = quaternions[i + j];
+      const __m128 clamped = _mm_min_ps(
+          one, _mm_max_ps(minus_one, _mm_setr_ps(q[0], q[1], q[2], q[3])));
+      // Round half up by flooring a biased value, like the scalar version.
+      const __m128 biased = _mm_add_ps(_mm_mul_ps(clamped, scale), half);
+      const __m128i truncated = _mm_cvttps_epi32(biased);
+      // Truncation rounds negative values up, subtract 1 to floor them.
+      const __m128 rounded_up =
+          _mm_cmplt_ps(biased, _mm_cvtepi32_ps(truncated));
+      converted[j] = _mm_add_epi32(truncated, _mm_castps_si128(rounded_up));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(packed[i].data_),
+                     _mm_packs_epi32(converted[0], converted[1]));
+  }
+#endif  // MATHFU_COMPILE_WITH_SSE2
+  for (; i < count; ++i) packed[i] = QuaternionPackedSnorm16(quaternions[i]);
+}
+
+/// @brief Unpack an array of quaternions.
+///
+/// The results match Unpack() to within rounding, they may differ by one ULP
+/// where the compiler contracts the scalar conversion into fused
+/// multiply-adds.
+///
+/// @param packed Array of count packed quaternions.
+/// @param count Number of quaternions.
+/// @param quaternions Array of count elements which receives the result.
+inline void UnpackQuaternions(const QuaternionPackedSnorm16* packed,
+                              size_t count, Quaternion<float>* quaternions) {
+  size_t i = 0;
+#ifdef MATHFU_COMPILE_WITH_SSE2
+  const __m128 scale = _mm_set1_ps(1.0f / 32767.0f);
+  const __m128 minus_one = _mm_set1_ps(-1.0f);
+  for (; i + 2 <= count; i += 2) {
+    const __m128i data =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(packed[i].data_));
+    union {
+      __m128 simd[2];
+      float lanes[2][4];
+    } components;
+    // Sign extend each 16-bit value to 32 bits.
+    components.simd[0] = _mm_max_ps(
+        minus_one,
+        _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(
+                       _mm_unpacklo_epi16(data, data), 16)),
+                   scale));
+    components.simd[1] = _mm_max_ps(
+        minus_one,
+        _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(
+                       _mm_unpackhi_epi16(data, data), 16)),
+                   scale));
+    for (int j = 0; j < 2; ++j) {
+      quaternions[i + j] = Quaternion<float>(
+          components.lanes[j][0], components.lanes[j][1],
+          components.lanes[j][2], components.lanes[j][3]);
+    }
+  }
+#endif  // MATHFU_COMPILE_WITH_SSE2
+  for (; i < count; ++i) quaternions[i] = packed[i].Unpack();
+}
+/// @}
+
+}  // namespace mathfu
+
+#endif  // MATHFU_QUATERNION_PACKED_H_
@@ -0,0 +1,349 @@
+/*
+* Copyright 2016 Google Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef MATHFU_RANDOM_H_
+#define MATHFU_RANDOM_H_
+
+#include "mathfu/quaternion.h"
+#include "mathfu/utilities.h"
+#include "mathfu/vector.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+#include <emmintrin.h>
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900)
+#include <atomic>
+/// @cond MATHFU_INTERNAL
+#define MATHFU_RANDOM_THREAD_LOCAL
+/// @endcond
+#endif  // __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900)
+
+/// @file mathfu/random.h
+/// @brief Seedable pseudo random number generator with batch generation of
+/// random Vectors and Quaternions.
+///
+/// Unlike Random(), which uses rand() from the C standard library, each
+/// RandomGenerator holds its own state so generators used by different
+/// threads do not contend with each other.
+
+namespace mathfu {
+
+/// @addtogroup mathfu_utilities
+/// @{
+
+/// @class RandomGenerator "mathfu/random.h"
+/// @brief Pseudo random number generator.
+///
+/// The generator runs four interleaved
+/// <a href="http://prng.di.unimi.it/">xoshiro128++</a> streams, which are
+/// stepped together using SSE2 when available.  Generators are not thread
+/// safe, use ThreadLocalRandomGenerator() or one generator per thread.
+class RandomGenerator {
+ public:
+  /// @brief Number of values generated by each step of the generator.
+  static const int kLanes = 4;
+
+  /// @brief Construct a generator with the default seed.
+  RandomGenerator() { Seed(0); }
+
+  /// @brief Construct a generator from a seed.
+  ///
+  /// @param seed Seed, generators constructed with the same seed produce
+  /// the same sequence of values.
+  explicit RandomGenerator(uint64_t seed) { Seed(seed); }
+
+  /// @brief Reset the state of the generator from a seed.
+  ///
+  /// @param seed Seed, generators seeded with the same value produce the same
+  /// sequence of values.
+  void Seed(uint64_t seed) {
+    // Expand the seed with SplitMix64, which never produces an all zero
+    // state for the xoshiro streams.
+    for (int lane = 0; lane < kLanes; ++lane) {
+      for (int word = 0; word < 4; word += 2) {
+        seed += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        state_[word][lane] = static_cast<uint32_t>(z);
+        state_[word + 1][lane] = static_cast<uint32_t>(z >> 32);
+      }
+    }
+    buffer_index_ = kLanes;
+  }
+
+  /// @brief Generate a random 32-bit unsigned integer.
+  ///
+  /// @return Random value, all bits of which are equally distributed.
+  uint32_t NextUInt32() {
+    if (buffer_index_ == kLanes) {
+      Generate(buffer_, 1);
+      buffer_index_ = 0;
+    }
+    return buffer_[buffer_index_++];
+  }
+
+  /// @brief Generate a random float greater than or equal to 0.0 and less
+  /// than 1.0.
+  ///
+  /// @return Random value with 24 bits of precision.
+  float NextFloat() { return UIntToFloat(NextUInt32()); }
+
+  /// @brief Generate a random double greater than or equal to 0.0 and less
+  /// than 1.0.
+  ///
+  /// @return Random value with 53 bits of precision.
+  double NextDouble() {
+    const uint32_t high = NextUInt32() >> 5;
+    const uint32_t low = NextUInt32() >> 6;
+    return (high * 67108864.0 + low) * (1.0 / 9007199254740992.0);
+  }
+
+  /// @brief Generate a random float between range_start and range_end.
+  ///
+  /// @param range_start Minimum value.
+  /// @param range_end Maximum value.
+  /// @return Random value in the range [range_start, range_end].
+  float NextFloatInRange(float range_start, float range_end) {
+    return Lerp(range_start, range_end, NextFloat());
+  }
+
+  /// @brief Fill an array with random floats greater than or equal to 0.0
+  /// and less than 1.0.
+  ///
+  /// @param values Array of count elements which receives the result.
+  /// @param count Number of values to generate.
+  void FillUniform(float* values, size_t count) {
+    const size_t blocks = count / kLanes;
+    GenerateFloats(values, blocks);
+    for (size_t i = blocks * kLanes; i < count; ++i) values[i] = NextFloat();
+  }
+
+  /// @brief Fill an array with random Vectors within a range.
+  ///
+  /// This is equivalent to calling Vector::RandomInRange() for each element
+  /// of the array.
+  ///
+  /// @param min Minimum value of each element of the Vectors.
+  /// @param max Maximum value of each element of the Vectors.
+  /// @param vectors Array of count elements which receives the result.
+  /// @param count Number of Vectors to generate.
+  template <int Dims>
+  void FillInRange(const Vector<float, Dims>& min,
+                   const Vector<float, Dims>& max,
+                   Vector<float, Dims>* vectors, size_t count) {
+    MATHFU_STATIC_ASSERT(Dims <= kChunkSize);
+    const Vector<float, Dims> range = max - min;
+    float uniform[kChunkSize];
+    int index = kChunkSize;
+    for (size_t i = 0; i < count; ++i) {
+      if (index + Dims > kChunkSize) {
+        GenerateFloats(uniform, kChunkSize / kLanes);
+        index = 0;
+      }
+      vectors[i] = min + Vector<float, Dims>::HadamardProduct(
+                             range, Vector<float, Dims>(&uniform[index]));
+      index += Dims;
+    }
+  }
+
+  /// @brief Fill an array with random unit length Vectors.
+  ///
+  /// Vectors are uniformly distributed over the surface of the unit sphere.
+  ///
+  /// @param vectors Array of count elements which receives the result.
+  /// @param count Number of Vectors to generate.
+  /// @tparam Dims Dimensions of the Vectors, between 2 and 4.
+  template <int Dims>
+  void FillUnitVectors(Vector<float, Dims>* vectors, size_t count) {
+    MATHFU_STATIC_ASSERT(Dims >= 2 && Dims <= 4);
+    // Select points within the unit ball by rejection sampling then project
+    // them onto the surface, which avoids evaluating trigonometric functions.
+    // Points very close to the origin are rejected as they lose precision
+    // when normalized.
+    const Vector<float, Dims> one(1.0f);
+    float uniform[kChunkSize];
+    int index = kChunkSize;
+    for (size_t i = 0; i < count;) {
+      if (index + Dims > kChunkSize) {
+        GenerateFloats(uniform, kChunkSize / kLanes);
+        index = 0;
+      }
+      const Vector<float, Dims> point =
+          Vector<float, Dims>(&uniform[index]) * 2.0f - one;
+      index += Dims;
+      const float length_squared = point.LengthSquared();
+      if (length_squared <= 1.0f && length_squared > 1e-4f) {
+        vectors[i++] = point * (1.0f / sqrtf(length_squared));
+      }
+    }
+  }
+
+  /// @brief Fill an array with random unit Quaternions.
+  ///
+  /// Quaternions are uniformly distributed so represent uniformly
+  /// distributed random rotations.
+  ///
+  /// @param quaternions Array of count elements which receives the result.
+  /// @param count Number of Quaternions to generate.
+  void FillQuaternions(Quaternion<float>* quaternions, size_t count) {
+    // Unit Quaternions are points on the surface of the 4-dimensional unit
+    // sphere.
+    Vector<float, 4> points[kChunkSize / 4];
+    while (count) {
+      const size_t chunk = count < kChunkSize / 4 ? count : kChunkSize / 4;
+      FillUnitVectors(points, chunk);
+      for (size_t i = 0; i < chunk; ++i) {
+        quaternions[i] =
+            Quaternion<float>(points[i][0], points[i][1], points[i][2],
+                              points[i][3]);
+      }
+      quaternions += chunk;
+      count -= chunk;
+    }
+  }
+
+ private:
+  /// Number of floats generated at once by the batch functions.
+  static const int kChunkSize = 64;
+
+  // Convert the upper 24 bits of a random value to a float in [0, 1).
+  static float UIntToFloat(uint32_t value) {
+    return static_cast<float>(value >> 8) * (1.0f / 16777216.0f);
+  }
+
+  // Advance a single stream returning the next value.
+  uint32_t StepLane(int lane) {
+    uint32_t& s0 = state_[0][lane];
+    uint32_t& s1 = state_[1][lane];
+    uint32_t& s2 = state_[2][lane];
+    uint32_t& s3 = state_[3][lane];
+    const uint32_t sum = s0 + s3;
+    const uint32_t result = ((sum << 7) | (sum >> 25)) + s0;
+    const uint32_t t = s1 << 9;
+    s2 ^= s0;
+    s3 ^= s1;
+    s1 ^= s2;
+    s0 ^= s3;
+    s2 ^= t;
+    s3 = (s3 << 11) | (s3 >> 21);
+    return result;
+  }
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+  static __m128i RotateLeft(const __m128i& v, int bits) {
+    return _mm_or_si128(_mm_slli_epi32(v, bits), _mm_srli_epi32(v, 32 - bits));
+  }
+
+  // Advance all streams held in s returning the next value of each.
+  static __m128i StepLanes(__m128i* s) {
+    const __m128i result =
+        _mm_add_epi32(RotateLeft(_mm_add_epi32(s[0], s[3]), 7), s[0]);
+    const __m128i t = _mm_slli_epi32(s[1], 9);
+    s[2] = _mm_xor_si128(s[2], s[0]);
+    s[3] = _mm_xor_si128(s[3], s[1]);
+    s[1] = _mm_xor_si128(s[1], s[2]);
+    s[0] = _mm_xor_si128(s[0], s[3]);
+    s[2] = _mm_xor_si128(s[2], t);
+    s[3] = RotateLeft(s[3], 11);
+    return result;
+  }
+
+  void LoadState(__m128i* s) const {
+    for (int word = 0; word < 4; ++word) {
+      s[word] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state_[word]));
+    }
+  }
+
+  void StoreState(const __m128i* s) {
+    for (int word = 0; word < 4; ++word) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(state_[word]), s[word]);
+    }
+  }
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
+  // Generate blocks * kLanes random values.
+  void Generate(uint32_t* values, size_t blocks) {
+#ifdef MATHFU_COMPILE_WITH_SSE2
+    __m128i s[4];
+    LoadState(s);
+    for (size_t i = 0; i < blocks; ++i) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(&values[i * kLanes]),
+                       StepLanes(s));
+    }
+    StoreState(s);
+#else
+    for (size_t i = 0; i < blocks; ++i) {
+      for (int lane = 0; lane < kLanes; ++lane) {
+        values[i * kLanes + lane] = StepLane(lane);
+      }
+    }
+#endif  // MATHFU_COMPILE_WITH_SSE2
+  }
+
+  // Generate blocks * kLanes random floats in [0, 1).
+  void GenerateFloats(float* values, size_t blocks) {
+#ifdef MATHFU_COMPILE_WITH_SSE2
+    const __m128 scale = _mm_set1_ps(1.0f / 16777216.0f);
+    __m128i s[4];
+    LoadState(s);
+    for (size_t i = 0; i < blocks; ++i) {
+      _mm_storeu_ps(&values[i * kLanes],
+                    _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(StepLanes(s), 8)),
+                               scale));
+    }
+    StoreState(s);
+#else
+    for (size_t i = 0; i < blocks; ++i) {
+      for (int lane = 0; lane < kLanes; ++lane) {
+        values[i * kLanes + lane] = UIntToFloat(StepLane(lane));
+      }
+    }
+#endif  // MATHFU_COMPILE_WITH_SSE2
+  }
+
+  // State of each stream, indexed by word then stream.
+  uint32_t state_[4][kLanes];
+  // Values generated for NextUInt32() which have not been returned.
+  uint32_t buffer_[kLanes];
+  int buffer_index_;
+};
+
+#ifdef MATHFU_RANDOM_THREAD_LOCAL
+/// @brief Get the RandomGenerator of the calling thread.
+///
+/// Each thread's generator is seeded with a different value the first time
+/// it is used, so threads produce independent sequences without locking.
+/// To reproduce a sequence call RandomGenerator::Seed() on the result.
+///
+/// @return Generator owned by the calling thread.
+inline RandomGenerator& ThreadLocalRandomGenerator() {
+  static std::atomic<uint64_t> next_seed(0);
+  static thread_local RandomGenerator generator(
+      next_seed.fetch_add(1) * 0xD1342543DE82EF95ULL + 1);
+  return generator;
+}
+#endif  // MATHFU_RANDOM_THREAD_LOCAL
+/// @}
+
+}  // namespace mathfu
+
+#endif  // MATHFU_RANDOM_H_
@@ -0,0 +1,467 @@
+/*
+* Copyright 2016 Google Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef MATHFU_SPLINE_H_
+#define MATHFU_SPLINE_H_
+
+#include "mathfu/quaternion.h"
+#include "mathfu/utilities.h"
+#include "mathfu/vector.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <cmath>
+#include <vector>
+
+/// @file mathfu/spline.h
+/// @brief Cubic Bezier, Hermite and Catmull-Rom splines of Vectors and
+/// spherical quadrangle (squad) interpolation of Quaternions.
+///
+/// Each cubic segment is converted to polynomial form when the spline is
+/// constructed, so evaluating a point only requires three multiply-adds of
+/// Vectors which use SIMD instructions when they're available.
+
+namespace mathfu {
+
+/// @addtogroup mathfu_animation
+/// @{
+
+/// @class CubicCurve "mathfu/spline.h"
+/// @brief Cubic polynomial curve of Vectors.
+///
+/// The curve is stored as the coefficients of
+/// <code>p(t) = c0 + c1 t + c2 t^2 + c3 t^3</code> where t is usually in the
+/// range 0...1.
+///
+/// @tparam T type of the elements of the curve.
+/// @tparam Dims dimensions of the curve.
+template <class T, int Dims>
+class CubicCurve {
+ public:
+  /// @brief Create a curve which is zero everywhere.
+  CubicCurve() {
+    for (int i = 0; i < 4; ++i) coefficients_[i] = Vector<T, Dims>(T(0));
+  }
+
+  /// @brief Create a curve from polynomial coefficients.
+  ///
+  /// @param c0 Constant coefficient.
+  /// @param c1 Coefficient of t.
+  /// @param c2 Coefficient of t^2.
+  /// @param c3 Coefficient of t^3.
+  CubicCurve(const Vector<T, Dims>& c0, const Vector<T, Dims>& c1,
+             const Vector<T, Dims>& c2, const Vector<T, Dims>& c3) {
+    coefficients_[0] = c0;
+    coefficients_[1] = c1;
+    coefficients_[2] = c2;
+    coefficients_[3] = c3;
+  }
+
+  /// @brief Create a cubic Bezier curve.
+  ///
+  /// @param p0 Start of the curve.
+  /// @param p1 First control point.
+  /// @param p2 Second control point.
+  /// @param p3 End of the curve.
+  /// @return Curve from p0 (t = 0) to p3 (t = 1).
+  static CubicCurve FromBezier(const Vector<T, Dims>& p0,
+                               const Vector<T, Dims>& p1,
+                               const Vector<T, Dims>& p2,
+                               const Vector<T, Dims>& p3) {
+    return CubicCurve(p0, (p1 - p0) * T(3), (p0 - p1 * T(2) + p2) * T(3),
+                      p3 - p0 + (p1 - p2) * T(3));
+  }
+
+  /// @brief Create a cubic Hermite curve.
+  ///
+  /// @param p0 Start of the curve.
+  /// @param m0 Tangent (derivative) at the start of the curve.
+  /// @param p1 End of the curve.
+  /// @param m1 Tangent (derivative) at the end of the curve.
+  /// @return Curve from p0 (t = 0) to p1 (t = 1).
+  static CubicCurve FromHermite(const Vector<T, Dims>& p0,
+                                const Vector<T, Dims>& m0,
+                                const Vector<T, Dims>& p1,
+                                const Vector<T, Dims>& m1) {
+    const Vector<T, Dims> delta = p1 - p0;
+    return CubicCurve(p0, m0, delta * T(3) - m0 * T(2) - m1,
+                      m0 + m1 - delta * T(2));
+  }
+
+  /// @brief Create a uniform Catmull-Rom curve.
+  ///
+  /// @param p0 Point before the start of the curve.
+  /// @param p1 Start of the curve.
+  /// @param p2 End of the curve.
+  /// @param p3 Point after the end of the curve.
+  /// @return Curve from p1 (t = 0) to p2 (t = 1).
+  static CubicCurve FromCatmullRom(const Vector<T, Dims>& p0,
+                                   const Vector<T, Dims>& p1,
+                                   const Vector<T, Dims>& p2,
+                                   const Vector<T, Dims>& p3) {
+    const T half = static_cast<T>(0.5);
+    return FromHermite(p1, (p2 - p0) * half, p2, (p3 - p1) * half);
+  }
+
+  /// @brief Evaluate the curve.
+  ///
+  /// @param t Curve parameter.
+  /// @return Point on the curve.
+  inline Vector<T, Dims> Evaluate(T t) const {
+    const Vector<T, Dims>* const c = coefficients_;
+    return ((c[3] * t + c[2]) * t + c[1]) * t + c[0];
+  }
+
+  /// @brief Evaluate the derivative (tangent) of the curve.
+  ///
+  /// @param t Curve parameter.
+  /// @return Derivative of the curve with respect to t.
+  inline Vector<T, Dims> Derivative(T t) const {
+    const Vector<T, Dims>* const c = coefficients_;
+    return (c[3] * (T(3) * t) + c[2] * T(2)) * t + c[1];
+  }
+
+  /// @brief Evaluate the curve at an array of parameters.
+  ///
+  /// @param t Array of count curve parameters.
+  /// @param count Number of parameters.
+  /// @param points Array of count elements which receives the result.
+  inline void Evaluate(const T* t, size_t count,
+                       Vector<T, Dims>* points) const {
+    const Vector<T, Dims> c0 = coefficients_[0], c1 = coefficients_[1],
+                          c2 = coefficients_[2], c3 = coefficients_[3];
+    for (size_t i = 0; i < count; ++i) {
+      points[i] = ((c3 * t[i] + c2) * t[i] + c1) * t[i] + c0;
+    }
+  }
+
+  /// @brief Get a coefficient of the polynomial.
+  ///
+  /// @param i Power of t of the coefficient, 0...3.
+  /// @return Coefficient of t^i.
+  inline const Vector<T, Dims>& coefficient(int i) const {
+    return coefficients_[i];
+  }
+
+  MATHFU_DEFINE_CLASS_SIMD_AWARE_NEW_DELETE
+
+ private:
+  Vector<T, Dims> coefficients_[4];
+};
+
+/// @brief Evaluate an array of curves at the same parameter.
+///
+/// @param curves Array of count curves.
+/// @param count Number of curves.
+/// @param t Curve parameter.
+/// @param points Array of count elements which receives the result.
+template <class T, int Dims>
+inline void EvaluateCurves(const CubicCurve<T, Dims>* curves, size_t count,
+                           T t, Vector<T, Dims>* points) {
+  for (size_t i = 0; i < count; ++i) points[i] = curves[i].Evaluate(t);
+}
+
+/// @cond MATHFU_INTERNAL
+// Split a spline parameter into a segment index and the parameter within
+// the segment, clamping the parameter to the range of the spline.
+template <class T>
+inline size_t SplineSegment(T t, size_t num_segments, T* segment_t) {
+  assert(num_segments > 0);
+  if (!(t > T(0))) {
+    *segment_t = T(0);
+    return 0;
+  }
+  if (t >= static_cast<T>(num_segments)) {
+    *segment_t = T(1);
+    return num_segments - 1;
+  }
+  const size_t segment = static_cast<size_t>(t);
+  *segment_t = t - static_cast<T>(segment);
+  return segment;
+}
+/// @endcond
+
+/// @class CubicSpline "mathfu/spline.h"
+/// @brief Sequence of cubic curves.
+///
+/// The spline is parameterized so segment i covers the range i...i + 1 and
+/// parameters outside the range 0...num_segments() are clamped.  A spline
+/// created from a single point has one constant segment.  Empty splines
+/// must not be evaluated.
+///
+/// @tparam T type of the elements of the spline.
+/// @tparam Dims dimensions of the spline.
+template <class T, int Dims>
+class CubicSpline {
+ public:
+  /// @brief Create an empty spline.
+  CubicSpline() {}
+
+  /// @brief Create a spline from a sequence of cubic Bezier curves.
+  ///
+  /// @param points Array of count points.  The first point starts the
+  /// spline and each group of 3 points that follows contains the 2 control
+  /// points and end point of a segment.
+  /// @param count Number of points, 3 * segments + 1.
+  /// @return Spline which passes through every third point.
+  static CubicSpline FromBezier(const Vector<T, Dims>* points, size_t count) {
+    assert(count == 0 || count % 3 == 1);
+    if (count == 1) return Constant(points[0]);
+    CubicSpline spline;
+    for (size_t i = 0; i + 3 < count; i += 3) {
+      spline.segments_.push_back(CubicCurve<T, Dims>::FromBezier(
+          points[i], points[i + 1], points[i + 2], points[i + 3]));
+    }
+    return spline;
+  }
+
+  /// @brief Create a spline which passes through a sequence of points with
+  /// the specified tangents.
+  ///
+  /// @param points Array of count points.
+  /// @param tangents Array of count tangents, one per point.
+  /// @param count Number of points.
+  /// @return Spline which passes through each point.
+  static CubicSpline FromHermite(const Vector<T, Dims>* points,
+                                 const Vector<T, Dims>* tangents,
+                                 size_t count) {
+    if (count == 1) return Constant(points[0]);
+    CubicSpline spline;
+    for (size_t i = 0; i + 1 < count; ++i) {
+      spline.segments_.push_back(CubicCurve<T, Dims>::FromHermite(
+          points[i], tangents[i], points[i + 1], tangents[i + 1]));
+    }
+    return spline;
+  }
+
+  /// @brief Create a uniform Catmull-Rom spline which passes through a
+  /// sequence of points.
+  ///
+  /// The first and last points are repeated to calculate the tangents at
+  /// the ends of the spline.
+  ///
+  /// @param points Array of count points.
+  /// @param count Number of points.
+  /// @return Spline which passes through each point.
+  static CubicSpline FromCatmullRom(const Vector<T, Dims>* points,
+                                    size_t count) {
+    if (count == 1) return Constant(points[0]);
+    CubicSpline spline;
+    for (size_t i = 0; i + 1 < count; ++i) {
+      spline.segments_.push_back(CubicCurve<T, Dims>::FromCatmullRom(
+          points[i == 0 ? 0 : i - 1], points[i], points[i + 1],
+          points[i + 2 < count ? i + 2 : i + 1]));
+    }
+    return spline;
+  }
+
+  /// @brief Get the number of segments in the spline.
+  ///
+  /// @return Number of cubic curves.
+  inline size_t num_segments() const { return segments_.size(); }
+
+  /// @brief Get a segment of the spline.
+  ///
+  /// @param i Index of the segment.
+  /// @return Curve of the segment.
+  inline const CubicCurve<T, Dims>& segment(size_t i) const {
+    return segments_[i];
+  }
+
+  /// @brief Evaluate the spline.
+  ///
+  /// @param t Spline parameter.
+  /// @return Point on the spline.
+  inline Vector<T, Dims> Evaluate(T t) const {
+    T segment_t;
+    const size_t segment = SplineSegment(t, segments_.size(), &segment_t);
+    return segments_[segment].Evaluate(segment_t);
+  }
+
+  /// @brief Evaluate the derivative (tangent) of the spline.
+  ///
+  /// @param t Spline parameter.
+  /// @return Derivative of the spline with respect to t.
+  inline Vector<T, Dims> Derivative(T t) const {
+    T segment_t;
+    const size_t segment = SplineSegment(t, segments_.size(), &segment_t);
+    return segments_[segment].Derivative(segment_t);
+  }
+
+  /// @brief Evaluate the spline at an array of parameters.
+  ///
+  /// @param t Array of count spline parameters.
+  /// @param count Number of parameters.
+  /// @param points Array of count elements which receives the result.
+  inline void Evaluate(const T* t, size_t count,
+                       Vector<T, Dims>* points) const {
+    const size_t num_segments = segments_.size();
+    for (size_t i = 0; i < count; ++i) {
+      T segment_t;
+      const size_t segment = SplineSegment(t[i], num_segments, &segment_t);
+      points[i] = segments_[segment].Evaluate(segment_t);
+    }
+  }
+
+ private:
+  // Create a spline with a single constant segment.
+  static CubicSpline Constant(const Vector<T, Dims>& point) {
+    const Vector<T, Dims> zero(static_cast<T>(0));
+    CubicSpline spline;
+    spline.segments_.push_back(CubicCurve<T, Dims>(point, zero, zero, zero));
+    return spline;
+  }
+
+  std::vector<CubicCurve<T, Dims>, simd_allocator<CubicCurve<T, Dims> > >
+      segments_;
+};
+
+/// @cond MATHFU_INTERNAL
+// Logarithm of a unit quaternion, the rotation axis scaled by half the
+// rotation angle.
+template <class T>
+inline Vector<T, 3> QuaternionLog(const Quaternion<T>& q) {
+  const T length = q.vector().Length();
+  if (length < static_cast<T>(1e-6)) return q.vector();
+  return q.vector() * (std::atan2(length, q.scalar()) / length);
+}
+
+// Exponential of a pure quaternion, the inverse of QuaternionLog().
+template <class T>
+inline Quaternion<T> QuaternionExp(const Vector<T, 3>& v) {
+  const T angle = v.Length();
+  if (angle < static_cast<T>(1e-6)) return Quaternion<T>(T(1), v);
+  return Quaternion<T>(std::cos(angle), v * (std::sin(angle) / angle));
+}
+/// @endcond
+
+/// @brief Calculate the spherical quadrangle (squad) control point of a
+/// key of a Quaternion spline.
+///
+/// @param previous Key before q.
+/// @param q Key to calculate the control point of.
+/// @param next Key after q.
+/// @return Control point used by Squad() for the segments adjacent to q.
+template <class T>
+inline Quaternion<T> SquadControlPoint(const Quaternion<T>& previous,
+                                       const Quaternion<T>& q,
+                                       const Quaternion<T>& next) {
+  const Quaternion<T> inverse = q.Inverse();
+  return q * QuaternionExp((QuaternionLog(inverse * next) +
+                            QuaternionLog(inverse * previous)) *
+                           static_cast<T>(-0.25));
+}
+
+/// @brief Interpolate between two orientations using spherical quadrangle
+/// interpolation, which has a continuous angular velocity at the keys.
+///
+/// The spherical linear interpolations are evaluated with
+/// Quaternion::SlerpFastNoFlip(), the shortest path interpolation of
+/// Quaternion::SlerpFast() would jump between the two representations of an
+/// orientation in the middle of a segment.
+///
+/// @param q1 Start Quaternion.
+/// @param s1 Control point of q1, see SquadControlPoint().
+/// @param s2 Control point of q2, see SquadControlPoint().
+/// @param q2 End Quaternion.
+/// @param t Interpolation parameter in the range 0...1.
+/// @return Interpolated Quaternion.
+template <class T>
+inline Quaternion<T> Squad(const Quaternion<T>& q1, const Quaternion<T>& s1,
+                           const Quaternion<T>& s2, const Quaternion<T>& q2,
+                           T t) {
+  return Quaternion<T>::SlerpFastNoFlip(
+      Quaternion<T>::SlerpFastNoFlip(q1, q2, t),
+      Quaternion<T>::SlerpFastNoFlip(s1, s2, t), T(2) * t * (T(1) - t));
+}
+
+/// @class QuaternionSpline "mathfu/spline.h"
+/// @brief Smooth interpolation of a sequence of orientations using Squad().
+///
+/// The control points of each key are calculated when the spline is
+/// constructed.  Like CubicSpline, segment i covers the range i...i + 1.
+///
+/// @tparam T type of the elements of the Quaternions.
+template <class T>
+class QuaternionSpline {
+ public:
+  /// @brief Create an empty spline.
+  QuaternionSpline() {}
+
+  /// @brief Create a spline which passes through a sequence of orientations.
+  ///
+  /// Keys are negated where required so each key is in the same hemisphere
+  /// as the previous key, which results in the shortest path between keys.
+  ///
+  /// @param keys Array of count unit Quaternions.
+  /// @param count Number of keys.
+  QuaternionSpline(const Quaternion<T>* keys, size_t count)
+      : keys_(keys, keys + count), controls_(count) {
+    for (size_t i = 1; i < count; ++i) {
+      if (Quaternion<T>::DotProduct(keys_[i - 1], keys_[i]) < T(0)) {
+        keys_[i] = Quaternion<T>(-keys_[i].scalar(), -keys_[i].vector());
+      }
+    }
+    // The control point of each end key is the key itself, which continues
+    // the angular velocity of the end segment.
+    for (size_t i = 0; i < count; ++i) {
+      controls_[i] = i == 0 || i + 1 == count
+                         ? keys_[i]
+                         : SquadControlPoint(keys_[i - 1], keys_[i],
+                                             keys_[i + 1]);
+    }
+  }
+
+  /// @brief Get the number of segments in the spline.
+  ///
+  /// @return Number of segments, one less than the number of keys.
+  inline size_t num_segments() const {
+    return keys_.empty() ? 0 : keys_.size() - 1;
+  }
+
+  /// @brief Evaluate the spline.
+  ///
+  /// A spline with a single key is constant, the spline must not be empty.
+  ///
+  /// @param t Spline parameter.
+  /// @return Interpolated orientation.
+  inline Quaternion<T> Evaluate(T t) const {
+    assert(!keys_.empty());
+    if (keys_.size() == 1) return keys_[0];
+    T segment_t;
+    const size_t i = SplineSegment(t, num_segments(), &segment_t);
+    return Squad(keys_[i], controls_[i], controls_[i + 1], keys_[i + 1],
+                 segment_t);
+  }
+
+  /// @brief Evaluate the spline at an array of parameters.
+  ///
+  /// @param t Array of count spline parameters.
+  /// @param count Number of parameters.
+  /// @param orientations Array of count elements which receives the result.
+  inline void Evaluate(const T* t, size_t count,
+                       Quaternion<T>* orientations) const {
+    for (size_t i = 0; i < count; ++i) orientations[i] = Evaluate(t[i]);
+  }
+
+ private:
+  std::vector<Quaternion<T>, simd_allocator<Quaternion<T> > > keys_;
+  std::vector<Quaternion<T>, simd_allocator<Quaternion<T> > > controls_;
+};
+/// @}
+
+}  // namespace mathfu
+
+#endif  // MATHFU_SPLINE_H_
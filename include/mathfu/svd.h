@@ -0,0 +1,509 @@
+/*
+* Copyright 2016 Google Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef MATHFU_SVD_H_
+#define MATHFU_SVD_H_
+
+#include "mathfu/matrix.h"
+#include "mathfu/utilities.h"
+#include "mathfu/vector.h"
+
+#include <stddef.h>
+#include <cmath>
+#include <limits>
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+#include <emmintrin.h>
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
+#if defined(MATHFU_COMPILE_WITH_SIMD) && defined(__AVX__)
+#include <immintrin.h>
+/// @cond MATHFU_INTERNAL
+#define MATHFU_SVD_AVX
+/// @endcond
+#endif  // defined(MATHFU_COMPILE_WITH_SIMD) && defined(__AVX__)
+
+/// @file mathfu/svd.h
+/// @brief Eigen decomposition and singular value decomposition of 3x3
+/// matrices.
+///
+/// Both decompositions use a fixed number of cyclic Jacobi sweeps without
+/// data dependent branches, so the batch functions solve 4 (SSE2) or 8 (AVX)
+/// float matrices at once, one per SIMD lane, with the same results as the
+/// functions which decompose a single Matrix.
+
+namespace mathfu {
+
+/// @cond MATHFU_INTERNAL
+// The kernels below are written once for "lanes" of type L, which is either
+// a scalar or one of the SIMD types SvdFloat4 and SvdFloat8.  Each lane type
+// provides arithmetic operators, SvdAbs(), SvdSqrt(), SvdLess() which
+// returns a SvdMask<L>::Type and SvdSelect().
+
+// Number of Jacobi sweeps, which converges to the precision of a double.
+static const int kSvdJacobiSweeps = 6;
+
+template <class L>
+struct SvdMask {
+  typedef bool Type;
+};
+
+template <class T>
+inline T SvdAbs(T a) {
+  return std::fabs(a);
+}
+
+template <class T>
+inline T SvdSqrt(T a) {
+  return std::sqrt(a);
+}
+
+template <class T>
+inline bool SvdLess(T a, T b) {
+  return a < b;
+}
+
+template <class T>
+inline T SvdSelect(bool mask, T a, T b) {
+  return mask ? a : b;
+}
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+struct SvdFloat4 {
+  enum { kWidth = 4 };
+  SvdFloat4() {}
+  explicit SvdFloat4(__m128 value) : v(value) {}
+  explicit SvdFloat4(float value) : v(_mm_set1_ps(value)) {}
+  static SvdFloat4 Load(const float* p) { return SvdFloat4(_mm_loadu_ps(p)); }
+  void Store(float* p) const { _mm_storeu_ps(p, v); }
+  __m128 v;
+};
+
+template <>
+struct SvdMask<SvdFloat4> {
+  typedef SvdFloat4 Type;
+};
+
+inline SvdFloat4 operator+(SvdFloat4 a, SvdFloat4 b) {
+  return SvdFloat4(_mm_add_ps(a.v, b.v));
+}
+inline SvdFloat4 operator-(SvdFloat4 a, SvdFloat4 b) {
+  return SvdFloat4(_mm_sub_ps(a.v, b.v));
+}
+inline SvdFloat4 operator*(SvdFloat4 a, SvdFloat4 b) {
+  return SvdFloat4(_mm_mul_ps(a.v, b.v));
+}
+inline SvdFloat4 operator/(SvdFloat4 a, SvdFloat4 b) {
+  return SvdFloat4(_mm_div_ps(a.v, b.v));
+}
+inline SvdFloat4 operator-(SvdFloat4 a) {
+  return SvdFloat4(_mm_xor_ps(a.v, _mm_set1_ps(-0.0f)));
+}
+inline SvdFloat4 SvdAbs(SvdFloat4 a) {
+  return SvdFloat4(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v));
+}
+inline SvdFloat4 SvdSqrt(SvdFloat4 a) { return SvdFloat4(_mm_sqrt_ps(a.v)); }
+inline SvdFloat4 SvdLess(SvdFloat4 a, SvdFloat4 b) {
+  return SvdFloat4(_mm_cmplt_ps(a.v, b.v));
+}
+inline SvdFloat4 SvdSelect(SvdFloat4 mask, SvdFloat4 a, SvdFloat4 b) {
+  return SvdFloat4(
+      _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)));
+}
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
+#ifdef MATHFU_SVD_AVX
+struct SvdFloat8 {
+  enum { kWidth = 8 };
+  SvdFloat8() {}
+  explicit SvdFloat8(__m256 value) : v(value) {}
+  explicit SvdFloat8(float value) : v(_mm256_set1_ps(value)) {}
+  static SvdFloat8 Load(const float* p) {
+    return SvdFloat8(_mm256_loadu_ps(p));
+  }
+  void Store(float* p) const { _mm256_storeu_ps(p, v); }
+  __m256 v;
+};
+
+template <>
+struct SvdMask<SvdFloat8> {
+  typedef SvdFloat8 Type;
+};
+
+inline SvdFloat8 operator+(SvdFloat8 a, SvdFloat8 b) {
+  return SvdFloat8(_mm256_add_ps(a.v, b.v));
+}
+inline SvdFloat8 operator-(SvdFloat8 a, SvdFloat8 b) {
+  return SvdFloat8(_mm256_sub_ps(a.v, b.v));
+}
+inline SvdFloat8 operator*(SvdFloat8 a, SvdFloat8 b) {
+  return SvdFloat8(_mm256_mul_ps(a.v, b.v));
+}
+inline SvdFloat8 operator/(SvdFloat8 a, SvdFloat8 b) {
+  return SvdFloat8(_mm256_div_ps(a.v, b.v));
+}
+inline SvdFloat8 operator-(SvdFloat8 a) {
+  return SvdFloat8(_mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)));
+}
+inline SvdFloat8 SvdAbs(SvdFloat8 a) {
+  return SvdFloat8(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v));
+}
+inline SvdFloat8 SvdSqrt(SvdFloat8 a) {
+  return SvdFloat8(_mm256_sqrt_ps(a.v));
+}
+inline SvdFloat8 SvdLess(SvdFloat8 a, SvdFloat8 b) {
+  return SvdFloat8(_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ));
+}
+inline SvdFloat8 SvdSelect(SvdFloat8 mask, SvdFloat8 a, SvdFloat8 b) {
+  return SvdFloat8(_mm256_blendv_ps(b.v, a.v, mask.v));
+}
+#endif  // MATHFU_SVD_AVX
+
+// Apply the Jacobi rotation which zeroes element (p, q) of a symmetric
+// matrix, where r is the remaining index, and accumulate it into columns p
+// and q of the eigenvectors.
+template <class L>
+inline void SvdJacobiRotate(L* app, L* aqq, L* apq, L* arp, L* arq, L* vp,
+                            L* vq) {
+  const L zero(0);
+  const L one(1);
+  // t = tan(angle) = 2 * apq * sign(tau) / (|tau| + sqrt(tau^2 + 4 * apq^2))
+  const L tau = *aqq - *app;
+  const L twice_apq = *apq + *apq;
+  const L denominator =
+      SvdAbs(tau) + SvdSqrt(tau * tau + twice_apq * twice_apq);
+  const L numerator = SvdSelect(SvdLess(tau, zero), -twice_apq, twice_apq);
+  const L t = SvdSelect(SvdLess(zero, denominator), numerator / denominator,
+                        zero);
+  const L c = one / SvdSqrt(one + t * t);
+  const L s = t * c;
+  *app = *app - t * *apq;
+  *aqq = *aqq + t * *apq;
+  *apq = zero;
+  const L rp = *arp;
+  const L rq = *arq;
+  *arp = c * rp - s * rq;
+  *arq = s * rp + c * rq;
+  for (int i = 0; i < 3; ++i) {
+    const L p = vp[i];
+    const L q = vq[i];
+    vp[i] = c * p - s * q;
+    vq[i] = s * p + c * q;
+  }
+}
+
+// Swap eigenvalues i and j, and their eigenvectors, if value i is smaller.
+// One eigenvector is negated so the eigenvectors remain a rotation.
+template <class L>
+inline void SvdSortPair(L* values, L* vectors, int i, int j) {
+  const typename SvdMask<L>::Type swap = SvdLess(values[i], values[j]);
+  const L value = values[i];
+  values[i] = SvdSelect(swap, values[j], value);
+  values[j] = SvdSelect(swap, value, values[j]);
+  for (int k = 0; k < 3; ++k) {
+    const L a = vectors[i * 3 + k];
+    const L b = vectors[j * 3 + k];
+    vectors[i * 3 + k] = SvdSelect(swap, b, a);
+    vectors[j * 3 + k] = SvdSelect(swap, -a, b);
+  }
+}
+
+// Eigen decomposition of the symmetric matrix with elements
+// (a00, a11, a22, a01, a02, a12).  The eigenvalues are sorted in descending
+// order and the eigenvectors are the columns of a column major rotation.
+template <class L>
+inline void SvdEigenKernel(const L* a, L* values, L* vectors) {
+  L a00 = a[0], a11 = a[1], a22 = a[2], a01 = a[3], a02 = a[4], a12 = a[5];
+  for (int i = 0; i < 9; ++i) vectors[i] = L(i % 4 == 0 ? 1 : 0);
+  for (int sweep = 0; sweep < kSvdJacobiSweeps; ++sweep) {
+    SvdJacobiRotate(&a00, &a11, &a01, &a02, &a12, &vectors[0], &vectors[3]);
+    SvdJacobiRotate(&a00, &a22, &a02, &a01, &a12, &vectors[0], &vectors[6]);
+    SvdJacobiRotate(&a11, &a22, &a12, &a01, &a02, &vectors[3], &vectors[6]);
+  }
+  values[0] = a00;
+  values[1] = a11;
+  values[2] = a22;
+  SvdSortPair(values, vectors, 0, 1);
+  SvdSortPair(values, vectors, 0, 2);
+  SvdSortPair(values, vectors, 1, 2);
+}
+
+template <class L>
+inline L SvdDot(const L* a, const L* b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// Singular value decomposition of the column major matrix m, see
+// SingularValueDecompose().  V is calculated from the eigenvectors of
+// m^T * m and U by orthonormalizing the columns of m * V.
+template <class L>
+inline void SvdKernel(const L* m, const L& epsilon, L* u, L* sigma, L* v) {
+  const L zero(0);
+  const L one(1);
+  const L s[6] = {SvdDot(&m[0], &m[0]), SvdDot(&m[3], &m[3]),
+                  SvdDot(&m[6], &m[6]), SvdDot(&m[0], &m[3]),
+                  SvdDot(&m[0], &m[6]), SvdDot(&m[3], &m[6])};
+  L values[3];
+  SvdEigenKernel(s, values, v);
+  L b[9];
+  for (int j = 0; j < 3; ++j) {
+    for (int i = 0; i < 3; ++i) {
+      b[j * 3 + i] = m[i] * v[j * 3] + m[3 + i] * v[j * 3 + 1] +
+                     m[6 + i] * v[j * 3 + 2];
+    }
+  }
+
+  // The first column of U is the x axis if m is zero.
+  const L length_squared = SvdDot(&b[0], &b[0]);
+  const typename SvdMask<L>::Type nonzero = SvdLess(zero, length_squared);
+  const L inverse_length = one / SvdSqrt(length_squared);
+  for (int i = 0; i < 3; ++i) {
+    u[i] = SvdSelect(nonzero, b[i] * inverse_length, i == 0 ? one : zero);
+  }
+
+  // The second column of U is an arbitrary perpendicular vector if m has
+  // rank 1.
+  const L projection = SvdDot(&u[0], &b[3]);
+  L w[3];
+  for (int i = 0; i < 3; ++i) w[i] = b[3 + i] - u[i] * projection;
+  const L w_length_squared = SvdDot(w, w);
+  const typename SvdMask<L>::Type independent =
+      SvdLess(epsilon * epsilon * length_squared, w_length_squared);
+  const typename SvdMask<L>::Type use_x = SvdLess(SvdAbs(u[0]), L(0.5f));
+  L p[3] = {SvdSelect(use_x, zero, -u[2]), SvdSelect(use_x, u[2], zero),
+            SvdSelect(use_x, -u[1], u[0])};
+  const L inverse_p_length = one / SvdSqrt(SvdDot(p, p));
+  const L inverse_w_length = one / SvdSqrt(w_length_squared);
+  for (int i = 0; i < 3; ++i) {
+    u[3 + i] = SvdSelect(independent, w[i] * inverse_w_length,
+                         p[i] * inverse_p_length);
+  }
+  u[6] = u[1] * u[5] - u[2] * u[4];
+  u[7] = u[2] * u[3] - u[0] * u[5];
+  u[8] = u[0] * u[4] - u[1] * u[3];
+  for (int j = 0; j < 3; ++j) sigma[j] = SvdDot(&u[j * 3], &b[j * 3]);
+}
+
+template <class T>
+inline T SvdEpsilon() {
+  return std::numeric_limits<T>::epsilon() * 16;
+}
+
+// Decompose arrays of float matrices using lanes of type L, returns the
+// number of matrices decomposed.
+template <class L>
+inline size_t EigenDecomposeLanes(const Matrix<float, 3>* matrices,
+                                  size_t count, Vector<float, 3>* eigenvalues,
+                                  Matrix<float, 3>* eigenvectors) {
+  const int kWidth = L::kWidth;
+  size_t i = 0;
+  for (; i + kWidth <= count; i += kWidth) {
+    float elements[6][kWidth];
+    for (int j = 0; j < kWidth; ++j) {
+      const Matrix<float, 3>& m = matrices[i + j];
+      elements[0][j] = m(0, 0);
+      elements[1][j] = m(1, 1);
+      elements[2][j] = m(2, 2);
+      elements[3][j] = m(0, 1);
+      elements[4][j] = m(0, 2);
+      elements[5][j] = m(1, 2);
+    }
+    L a[6], values[3], vectors[9];
+    for (int k = 0; k < 6; ++k) a[k] = L::Load(elements[k]);
+    SvdEigenKernel(a, values, vectors);
+    float value_lanes[3][kWidth], vector_lanes[9][kWidth];
+    for (int k = 0; k < 3; ++k) values[k].Store(value_lanes[k]);
+    for (int k = 0; k < 9; ++k) vectors[k].Store(vector_lanes[k]);
+    for (int j = 0; j < kWidth; ++j) {
+      eigenvalues[i + j] = Vector<float, 3>(
+          value_lanes[0][j], value_lanes[1][j], value_lanes[2][j]);
+      for (int k = 0; k < 9; ++k) eigenvectors[i + j][k] = vector_lanes[k][j];
+    }
+  }
+  return i;
+}
+
+template <class L>
+inline size_t SingularValueDecomposeLanes(const Matrix<float, 3>* matrices,
+                                          size_t count, Matrix<float, 3>* u,
+                                          Vector<float, 3>* sigma,
+                                          Matrix<float, 3>* v) {
+  const int kWidth = L::kWidth;
+  const L epsilon(SvdEpsilon<float>());
+  size_t i = 0;
+  for (; i + kWidth <= count; i += kWidth) {
+    float elements[9][kWidth];
+    for (int j = 0; j < kWidth; ++j) {
+      for (int k = 0; k < 9; ++k) elements[k][j] = matrices[i + j][k];
+    }
+    L m[9], u_lanes[9], sigma_lanes[3], v_lanes[9];
+    for (int k = 0; k < 9; ++k) m[k] = L::Load(elements[k]);
+    SvdKernel(m, epsilon, u_lanes, sigma_lanes, v_lanes);
+    float u_out[9][kWidth], sigma_out[3][kWidth], v_out[9][kWidth];
+    for (int k = 0; k < 9; ++k) {
+      u_lanes[k].Store(u_out[k]);
+      v_lanes[k].Store(v_out[k]);
+    }
+    for (int k = 0; k < 3; ++k) sigma_lanes[k].Store(sigma_out[k]);
+    for (int j = 0; j < kWidth; ++j) {
+      for (int k = 0; k < 9; ++k) {
+        u[i + j][k] = u_out[k][j];
+        v[i + j][k] = v_out[k][j];
+      }
+      sigma[i + j] =
+          Vector<float, 3>(sigma_out[0][j], sigma_out[1][j], sigma_out[2][j]);
+    }
+  }
+  return i;
+}
+/// @endcond
+
+/// @addtogroup mathfu_matrix
+/// @{
+
+/// @brief Calculate the eigenvalues and eigenvectors of a symmetric 3x3
+/// Matrix.
+///
+/// The decomposition <code>m = V * diag(eigenvalues) * V^T</code> is
+/// calculated with a fixed number of cyclic Jacobi sweeps.  This is the
+/// basis of principal component analysis, for example to fit oriented
+/// bounding boxes to the covariance of a set of points.
+///
+/// @param m Symmetric Matrix to decompose.  Only the upper triangle is read.
+/// @param eigenvalues Receives the eigenvalues in descending order.
+/// @param eigenvectors Receives the rotation Matrix V whose columns are the
+/// eigenvectors corresponding to each eigenvalue.
+template <class T>
+inline void EigenDecompose(const Matrix<T, 3>& m, Vector<T, 3>* eigenvalues,
+                           Matrix<T, 3>* eigenvectors) {
+  const T a[6] = {m(0, 0), m(1, 1), m(2, 2), m(0, 1), m(0, 2), m(1, 2)};
+  T values[3], vectors[9];
+  SvdEigenKernel(a, values, vectors);
+  *eigenvalues = Vector<T, 3>(values[0], values[1], values[2]);
+  *eigenvectors = Matrix<T, 3>(vectors);
+}
+
+/// @brief Calculate the eigenvalues and eigenvectors of an array of
+/// symmetric 3x3 matrices.
+///
+/// Each Matrix is decomposed as
+/// EigenDecompose(const Matrix<T, 3>&, Vector<T, 3>*, Matrix<T, 3>*) does.
+/// Float matrices are decomposed 4 or 8 at a time when
+/// MATHFU_COMPILE_WITH_SSE2 is defined or AVX is enabled.
+///
+/// @param matrices Array of count symmetric matrices to decompose.
+/// @param count Number of matrices.
+/// @param eigenvalues Array of count elements which receives the
+/// eigenvalues.
+/// @param eigenvectors Array of count elements which receives the
+/// eigenvectors.
+template <class T>
+inline void EigenDecompose(const Matrix<T, 3>* matrices, size_t count,
+                           Vector<T, 3>* eigenvalues,
+                           Matrix<T, 3>* eigenvectors) {
+  for (size_t i = 0; i < count; ++i) {
+    EigenDecompose(matrices[i], &eigenvalues[i], &eigenvectors[i]);
+  }
+}
+
+/// @brief Calculate the singular value decomposition of a 3x3 Matrix.
+///
+/// The decomposition <code>m = U * diag(sigma) * V^T</code> is calculated
+/// such that U and V are rotations, which is the form required by
+/// point set alignment (the rotation which best aligns two point sets with
+/// cross covariance m is <code>U * V^T</code>) and by polar decomposition of
+/// deformation gradients.  As a consequence the last singular value is
+/// negative when m contains a reflection.
+///
+/// @param m Matrix to decompose.
+/// @param u Receives the rotation Matrix U.
+/// @param sigma Receives the singular values in descending order of
+/// magnitude.
+/// @param v Receives the rotation Matrix V.
+template <class T>
+inline void SingularValueDecompose(const Matrix<T, 3>& m, Matrix<T, 3>* u,
+                                   Vector<T, 3>* sigma, Matrix<T, 3>* v) {
+  T elements[9], u_elements[9], sigma_elements[3], v_elements[9];
+  for (int i = 0; i < 9; ++i) elements[i] = m[i];
+  SvdKernel(elements, SvdEpsilon<T>(), u_elements, sigma_elements,
+            v_elements);
+  *u = Matrix<T, 3>(u_elements);
+  *sigma = Vector<T, 3>(sigma_elements[0], sigma_elements[1],
+                        sigma_elements[2]);
+  *v = Matrix<T, 3>(v_elements);
+}
+
+/// @brief Calculate the singular value decomposition of an array of 3x3
+/// matrices.
+///
+/// Each Matrix is decomposed as SingularValueDecompose(const Matrix<T, 3>&,
+/// Matrix<T, 3>*, Vector<T, 3>*, Matrix<T, 3>*) does.  Float matrices are
+/// decomposed 4 or 8 at a time when MATHFU_COMPILE_WITH_SSE2 is defined or
+/// AVX is enabled.
+///
+/// @param matrices Array of count matrices to decompose.
+/// @param count Number of matrices.
+/// @param u Array of count elements which receives the U matrices.
+/// @param sigma Array of count elements which receives the singular values.
+/// @param v Array of count elements which receives the V matrices.
+template <class T>
+inline void SingularValueDecompose(const Matrix<T, 3>* matrices, size_t count,
+                                   Matrix<T, 3>* u, Vector<T, 3>* sigma,
+                                   Matrix<T, 3>* v) {
+  for (size_t i = 0; i < count; ++i) {
+    SingularValueDecompose(matrices[i], &u[i], &sigma[i], &v[i]);
+  }
+}
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+/// @cond MATHFU_INTERNAL
+// Float overloads of the batch functions which decompose one matrix per
+// SIMD lane.
+inline void EigenDecompose(const Matrix<float, 3>* matrices, size_t count,
+                           Vector<float, 3>* eigenvalues,
+                           Matrix<float, 3>* eigenvectors) {
+  size_t i = 0;
+#ifdef MATHFU_SVD_AVX
+  i += EigenDecomposeLanes<SvdFloat8>(matrices, count, eigenvalues,
+                                      eigenvectors);
+#endif  // MATHFU_SVD_AVX
+  i += EigenDecomposeLanes<SvdFloat4>(&matrices[i], count - i,
+                                      &eigenvalues[i], &eigenvectors[i]);
+  for (; i < count; ++i) {
+    EigenDecompose(matrices[i], &eigenvalues[i], &eigenvectors[i]);
+  }
+}
+
+inline void SingularValueDecompose(const Matrix<float, 3>* matrices,
+                                   size_t count, Matrix<float, 3>* u,
+                                   Vector<float, 3>* sigma,
+                                   Matrix<float, 3>* v) {
+  size_t i = 0;
+#ifdef MATHFU_SVD_AVX
+  i += SingularValueDecomposeLanes<SvdFloat8>(matrices, count, u, sigma, v);
+#endif  // MATHFU_SVD_AVX
+  i += SingularValueDecomposeLanes<SvdFloat4>(&matrices[i], count - i, &u[i],
+                                              &sigma[i], &v[i]);
+  for (; i < count; ++i) {
+    SingularValueDecompose(matrices[i], &u[i], &sigma[i], &v[i]);
+  }
+}
+/// @endcond
+#endif  // MATHFU_COMPILE_WITH_SSE2
+/// @}
+
+}  // namespace mathfu
+
+#endif  // MATHFU_SVD_H_
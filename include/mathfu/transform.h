@@ -0,0 +1,495 @@
+/*
+* Copyright 2016 Google Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef MATHFU_TRANSFORM_H_
+#define MATHFU_TRANSFORM_H_
+
+#include "mathfu/matrix.h"
+#include "mathfu/quaternion.h"
+#include "mathfu/utilities.h"
+#include "mathfu/vector.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <cmath>
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+#include <emmintrin.h>
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
+/// @file mathfu/transform.h
+/// @brief Position, rotation and scale of an object.
+
+namespace mathfu {
+
+/// @cond MATHFU_INTERNAL
+// Decompose an affine transform, see Decompose().  Every step is written so
+// that Decompose4() can evaluate it without branches.
+template <class T>
+inline bool DecomposeHelper(const Matrix<T, 4>& m, T tolerance,
+                            Vector<T, 3>* position, Quaternion<T>* rotation,
+                            Vector<T, 3>* scale) {
+  const T zero = static_cast<T>(0);
+  const T one = static_cast<T>(1);
+  const T half = static_cast<T>(0.5);
+  T c[3][3];
+  T s[3];
+  for (int j = 0; j < 3; ++j) {
+    for (int i = 0; i < 3; ++i) c[j][i] = m(i, j);
+    s[j] = std::sqrt(c[j][0] * c[j][0] + c[j][1] * c[j][1] +
+                     c[j][2] * c[j][2]);
+  }
+  // Reflections are represented by a negative scale along the x axis.
+  const T det = (c[0][1] * c[1][2] - c[0][2] * c[1][1]) * c[2][0] +
+                (c[0][2] * c[1][0] - c[0][0] * c[1][2]) * c[2][1] +
+                (c[0][0] * c[1][1] - c[0][1] * c[1][0]) * c[2][2];
+  if (det < zero) s[0] = -s[0];
+  T r[3][3];
+  for (int j = 0; j < 3; ++j) {
+    const T inverse_scale = s[j] != zero ? one / s[j] : zero;
+    for (int i = 0; i < 3; ++i) r[j][i] = c[j][i] * inverse_scale;
+  }
+
+  // Calculate the largest quaternion component from the diagonal and the
+  // others from the off diagonal elements (Shepperd's method).
+  const T tw = one + r[0][0] + r[1][1] + r[2][2];
+  const T tx = one + r[0][0] - r[1][1] - r[2][2];
+  const T ty = one - r[0][0] + r[1][1] - r[2][2];
+  const T tz = one - r[0][0] - r[1][1] + r[2][2];
+  const T dx = r[1][2] - r[2][1];
+  const T dy = r[2][0] - r[0][2];
+  const T dz = r[0][1] - r[1][0];
+  const T sxy = r[1][0] + r[0][1];
+  const T sxz = r[2][0] + r[0][2];
+  const T syz = r[2][1] + r[1][2];
+  T t, q[4];
+  int largest;
+  if (tw >= tx && tw >= ty && tw >= tz) {
+    t = tw;
+    largest = 0;
+    q[1] = dx; q[2] = dy; q[3] = dz;
+  } else if (tx >= ty && tx >= tz) {
+    t = tx;
+    largest = 1;
+    q[0] = dx; q[2] = sxy; q[3] = sxz;
+  } else if (ty >= tz) {
+    t = ty;
+    largest = 2;
+    q[0] = dy; q[1] = sxy; q[3] = syz;
+  } else {
+    t = tz;
+    largest = 3;
+    q[0] = dz; q[1] = sxz; q[2] = syz;
+  }
+  const T root = std::sqrt(t);
+  const T k = half / root;
+  for (int i = 0; i < 4; ++i) q[i] = i == largest ? half * root : q[i] * k;
+  if (q[0] < zero) {
+    for (int i = 0; i < 4; ++i) q[i] = -q[i];
+  }
+
+  *position = Vector<T, 3>(m(0, 3), m(1, 3), m(2, 3));
+  *rotation = Quaternion<T>(q[0], q[1], q[2], q[3]);
+  *scale = Vector<T, 3>(s[0], s[1], s[2]);
+  const T r01 = r[0][0] * r[1][0] + r[0][1] * r[1][1] + r[0][2] * r[1][2];
+  const T r02 = r[0][0] * r[2][0] + r[0][1] * r[2][1] + r[0][2] * r[2][2];
+  const T r12 = r[1][0] * r[2][0] + r[1][1] * r[2][1] + r[1][2] * r[2][2];
+  return s[0] != zero && s[1] != zero && s[2] != zero &&
+         std::fabs(r01) <= tolerance && std::fabs(r02) <= tolerance &&
+         std::fabs(r12) <= tolerance && std::fabs(m(3, 0)) <= tolerance &&
+         std::fabs(m(3, 1)) <= tolerance && std::fabs(m(3, 2)) <= tolerance &&
+         std::fabs(m(3, 3) - one) <= tolerance;
+}
+// Decompose a batch of matrices with SIMD, returns the number of matrices
+// processed.  The remainder is decomposed by DecomposeHelper().
+template <class T>
+inline size_t DecomposeSimd(const Matrix<T, 4>* /*matrices*/,
+                            size_t /*count*/, T /*tolerance*/,
+                            Vector<T, 3>* /*positions*/,
+                            Quaternion<T>* /*rotations*/,
+                            Vector<T, 3>* /*scales*/, bool* /*valid*/,
+                            size_t* /*num_valid*/) {
+  return 0;
+}
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+inline __m128 DecomposeSelect(__m128 mask, __m128 a, __m128 b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// Decompose 4 matrices using the same operations as DecomposeHelper(), so
+// the results are identical.  Returns a bit mask of the valid matrices.
+inline int Decompose4(const Matrix<float, 4>* matrices, float tolerance,
+                      Vector<float, 3>* positions,
+                      Quaternion<float>* rotations, Vector<float, 3>* scales) {
+  // m[i][j] holds element (i, j) of each matrix.
+  __m128 m[4][4];
+  for (int j = 0; j < 4; ++j) {
+    __m128 a = _mm_loadu_ps(&matrices[0][4 * j]);
+    __m128 b = _mm_loadu_ps(&matrices[1][4 * j]);
+    __m128 c = _mm_loadu_ps(&matrices[2][4 * j]);
+    __m128 d = _mm_loadu_ps(&matrices[3][4 * j]);
+    _MM_TRANSPOSE4_PS(a, b, c, d);
+    m[0][j] = a;
+    m[1][j] = b;
+    m[2][j] = c;
+    m[3][j] = d;
+  }
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 sign = _mm_set1_ps(-0.0f);
+  const __m128 tolerances = _mm_set1_ps(tolerance);
+
+  __m128 s[3];
+  for (int j = 0; j < 3; ++j) {
+    s[j] = _mm_sqrt_ps(_mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(m[0][j], m[0][j]), _mm_mul_ps(m[1][j], m[1][j])),
+        _mm_mul_ps(m[2][j], m[2][j])));
+  }
+  const __m128 det = _mm_add_ps(
+      _mm_add_ps(
+          _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(m[1][0], m[2][1]),
+                                _mm_mul_ps(m[2][0], m[1][1])),
+                     m[0][2]),
+          _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(m[2][0], m[0][1]),
+                                _mm_mul_ps(m[0][0], m[2][1])),
+                     m[1][2])),
+      _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(m[0][0], m[1][1]),
+                            _mm_mul_ps(m[1][0], m[0][1])),
+                 m[2][2]));
+  s[0] = _mm_xor_ps(s[0], _mm_and_ps(_mm_cmplt_ps(det, zero), sign));
+  // r[j][i] holds element (i, j) of the rotation.
+  __m128 r[3][3];
+  for (int j = 0; j < 3; ++j) {
+    const __m128 inverse_scale =
+        _mm_and_ps(_mm_cmpneq_ps(s[j], zero), _mm_div_ps(one, s[j]));
+    for (int i = 0; i < 3; ++i) r[j][i] = _mm_mul_ps(m[i][j], inverse_scale);
+  }
+
+  const __m128 tw = _mm_add_ps(_mm_add_ps(_mm_add_ps(one, r[0][0]), r[1][1]),
+                               r[2][2]);
+  const __m128 tx = _mm_sub_ps(_mm_sub_ps(_mm_add_ps(one, r[0][0]), r[1][1]),
+                               r[2][2]);
+  const __m128 ty = _mm_sub_ps(_mm_add_ps(_mm_sub_ps(one, r[0][0]), r[1][1]),
+                               r[2][2]);
+  const __m128 tz = _mm_add_ps(_mm_sub_ps(_mm_sub_ps(one, r[0][0]), r[1][1]),
+                               r[2][2]);
+  const __m128 is_w =
+      _mm_and_ps(_mm_cmpge_ps(tw, tx),
+                 _mm_and_ps(_mm_cmpge_ps(tw, ty), _mm_cmpge_ps(tw, tz)));
+  const __m128 is_x = _mm_andnot_ps(
+      is_w, _mm_and_ps(_mm_cmpge_ps(tx, ty), _mm_cmpge_ps(tx, tz)));
+  const __m128 is_y =
+      _mm_andnot_ps(_mm_or_ps(is_w, is_x), _mm_cmpge_ps(ty, tz));
+  const __m128 t = DecomposeSelect(
+      is_w, tw, DecomposeSelect(is_x, tx, DecomposeSelect(is_y, ty, tz)));
+  const __m128 root = _mm_sqrt_ps(t);
+  const __m128 k = _mm_div_ps(half, root);
+  const __m128 largest = _mm_mul_ps(half, root);
+  const __m128 dx = _mm_mul_ps(_mm_sub_ps(r[1][2], r[2][1]), k);
+  const __m128 dy = _mm_mul_ps(_mm_sub_ps(r[2][0], r[0][2]), k);
+  const __m128 dz = _mm_mul_ps(_mm_sub_ps(r[0][1], r[1][0]), k);
+  const __m128 sxy = _mm_mul_ps(_mm_add_ps(r[1][0], r[0][1]), k);
+  const __m128 sxz = _mm_mul_ps(_mm_add_ps(r[2][0], r[0][2]), k);
+  const __m128 syz = _mm_mul_ps(_mm_add_ps(r[2][1], r[1][2]), k);
+  __m128 q[4];
+  q[0] = DecomposeSelect(
+      is_w, largest,
+      DecomposeSelect(is_x, dx, DecomposeSelect(is_y, dy, dz)));
+  q[1] = DecomposeSelect(
+      is_w, dx, DecomposeSelect(is_x, largest, DecomposeSelect(is_y, sxy, sxz)));
+  q[2] = DecomposeSelect(
+      is_w, dy, DecomposeSelect(is_x, sxy, DecomposeSelect(is_y, largest, syz)));
+  q[3] = DecomposeSelect(
+      is_w, dz, DecomposeSelect(is_x, sxz, DecomposeSelect(is_y, syz, largest)));
+  const __m128 flip = _mm_and_ps(_mm_cmplt_ps(q[0], zero), sign);
+  for (int i = 0; i < 4; ++i) q[i] = _mm_xor_ps(q[i], flip);
+
+  __m128 dot[3];
+  for (int a = 0, pair = 0; a < 2; ++a) {
+    for (int b = a + 1; b < 3; ++b, ++pair) {
+      dot[pair] = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(r[a][0], r[b][0]), _mm_mul_ps(r[a][1], r[b][1])),
+          _mm_mul_ps(r[a][2], r[b][2]));
+    }
+  }
+  __m128 valid = _mm_and_ps(
+      _mm_cmpneq_ps(s[0], zero),
+      _mm_and_ps(_mm_cmpneq_ps(s[1], zero), _mm_cmpneq_ps(s[2], zero)));
+  for (int i = 0; i < 3; ++i) {
+    valid = _mm_and_ps(
+        valid, _mm_cmple_ps(_mm_andnot_ps(sign, dot[i]), tolerances));
+    valid = _mm_and_ps(
+        valid, _mm_cmple_ps(_mm_andnot_ps(sign, m[3][i]), tolerances));
+  }
+  valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_andnot_ps(
+                                             sign, _mm_sub_ps(m[3][3], one)),
+                                         tolerances));
+
+  float p[3][4], o[4][4], l[3][4];
+  for (int i = 0; i < 3; ++i) {
+    _mm_storeu_ps(p[i], m[i][3]);
+    _mm_storeu_ps(l[i], s[i]);
+  }
+  for (int i = 0; i < 4; ++i) _mm_storeu_ps(o[i], q[i]);
+  for (int i = 0; i < 4; ++i) {
+    positions[i] = Vector<float, 3>(p[0][i], p[1][i], p[2][i]);
+    rotations[i] = Quaternion<float>(o[0][i], o[1][i], o[2][i], o[3][i]);
+    scales[i] = Vector<float, 3>(l[0][i], l[1][i], l[2][i]);
+  }
+  return _mm_movemask_ps(valid);
+}
+
+inline size_t DecomposeSimd(const Matrix<float, 4>* matrices, size_t count,
+                            float tolerance, Vector<float, 3>* positions,
+                            Quaternion<float>* rotations,
+                            Vector<float, 3>* scales, bool* valid,
+                            size_t* num_valid) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const int mask = Decompose4(&matrices[i], tolerance, &positions[i],
+                                &rotations[i], &scales[i]);
+    for (int j = 0; j < 4; ++j) {
+      const bool is_valid = (mask >> j) & 1;
+      if (valid) valid[i + j] = is_valid;
+      *num_valid += is_valid;
+    }
+  }
+  return i;
+}
+#endif  // MATHFU_COMPILE_WITH_SSE2
+/// @endcond
+
+/// @addtogroup mathfu_matrix
+/// @{
+
+/// @class Transform "mathfu/transform.h"
+/// @brief Position, rotation and scale of an object with cached matrices.
+///
+/// The transform Matrix and its inverse are calculated when they are first
+/// requested after the transform changes, so querying an unchanged
+/// transform every frame costs nothing.  Each change also increments
+/// version(), which allows objects derived from the transform to detect
+/// when they need to be updated.
+///
+/// The cached matrices are updated by const methods, so a Transform must not
+/// be accessed from multiple threads without synchronization.
+///
+/// @tparam T type of each element, float or double.
+template <class T>
+class Transform {
+ public:
+  /// @brief Create an identity transform.
+  Transform()
+      : position_(static_cast<T>(0)),
+        rotation_(Quaternion<T>::identity),
+        scale_(static_cast<T>(1)) {
+    Invalidate(0);
+  }
+
+  /// @brief Create a transform.
+  ///
+  /// @param position Position of the object.
+  /// @param rotation Unit quaternion which specifies the rotation.
+  /// @param scale Scale along each local axis.
+  Transform(const Vector<T, 3>& position, const Quaternion<T>& rotation,
+            const Vector<T, 3>& scale)
+      : position_(position), rotation_(rotation), scale_(scale) {
+    Invalidate(0);
+  }
+
+  /// @return Position of the object.
+  inline const Vector<T, 3>& position() const { return position_; }
+
+  /// @brief Set the position of the object.
+  ///
+  /// @param position Position of the object.
+  inline void set_position(const Vector<T, 3>& position) {
+    position_ = position;
+    Invalidate(version_ + 1);
+  }
+
+  /// @return Unit quaternion which specifies the rotation.
+  inline const Quaternion<T>& rotation() const { return rotation_; }
+
+  /// @brief Set the rotation of the object.
+  ///
+  /// @param rotation Unit quaternion which specifies the rotation.
+  inline void set_rotation(const Quaternion<T>& rotation) {
+    rotation_ = rotation;
+    Invalidate(version_ + 1);
+  }
+
+  /// @return Scale along each local axis.
+  inline const Vector<T, 3>& scale() const { return scale_; }
+
+  /// @brief Set the scale of the object.
+  ///
+  /// @param scale Scale along each local axis.
+  inline void set_scale(const Vector<T, 3>& scale) {
+    scale_ = scale;
+    Invalidate(version_ + 1);
+  }
+
+  /// @brief Set the position, rotation and scale of the object.
+  ///
+  /// @param position Position of the object.
+  /// @param rotation Unit quaternion which specifies the rotation.
+  /// @param scale Scale along each local axis.
+  inline void Set(const Vector<T, 3>& position, const Quaternion<T>& rotation,
+                  const Vector<T, 3>& scale) {
+    position_ = position;
+    rotation_ = rotation;
+    scale_ = scale;
+    Invalidate(version_ + 1);
+  }
+
+  /// @brief Get the number of times the transform has been changed.
+  ///
+  /// @return Version of the transform, which is incremented by each setter.
+  inline uint32_t version() const { return version_; }
+
+  /// @brief Get the transform Matrix.
+  ///
+  /// @return Matrix which scales, rotates then translates, see
+  /// Matrix::Transform().  The reference is valid until the transform is
+  /// changed.
+  inline const Matrix<T, 4, 4>& matrix() const {
+    if (matrix_dirty_) {
+      matrix_ = Matrix<T, 4, 4>::Transform(position_, rotation_.ToMatrix(),
+                                           scale_);
+      matrix_dirty_ = false;
+    }
+    return matrix_;
+  }
+
+  /// @brief Get the inverse of the transform Matrix.
+  ///
+  /// The inverse is calculated directly from the position, rotation and
+  /// scale, which is cheaper and more accurate than Matrix::Inverse().  The
+  /// scale must not have zero elements.
+  ///
+  /// @return Inverse of matrix().  The reference is valid until the
+  /// transform is changed.
+  inline const Matrix<T, 4, 4>& inverse_matrix() const {
+    if (inverse_dirty_) {
+      // (T * R * S)^-1 = S^-1 * R^T * T^-1
+      const Vector<T, 3> inverse_scale = Vector<T, 3>(static_cast<T>(1)) /
+                                         scale_;
+      const Matrix<T, 3> inverse_rotation = rotation_.Inverse().ToMatrix();
+      const Vector<T, 3> x = inverse_rotation.GetColumn(0) * inverse_scale;
+      const Vector<T, 3> y = inverse_rotation.GetColumn(1) * inverse_scale;
+      const Vector<T, 3> z = inverse_rotation.GetColumn(2) * inverse_scale;
+      const Vector<T, 3> translation =
+          -(x * position_[0] + y * position_[1] + z * position_[2]);
+      inverse_matrix_ = Matrix<T, 4, 4>(
+          Vector<T, 4>(x, static_cast<T>(0)),
+          Vector<T, 4>(y, static_cast<T>(0)),
+          Vector<T, 4>(z, static_cast<T>(0)),
+          Vector<T, 4>(translation, static_cast<T>(1)));
+      inverse_dirty_ = false;
+    }
+    return inverse_matrix_;
+  }
+
+  MATHFU_DEFINE_CLASS_SIMD_AWARE_NEW_DELETE
+
+ private:
+  /// @cond MATHFU_INTERNAL
+  inline void Invalidate(uint32_t version) {
+    version_ = version;
+    matrix_dirty_ = true;
+    inverse_dirty_ = true;
+  }
+  /// @endcond
+
+  Vector<T, 3> position_;
+  Quaternion<T> rotation_;
+  Vector<T, 3> scale_;
+  mutable Matrix<T, 4, 4> matrix_;
+  mutable Matrix<T, 4, 4> inverse_matrix_;
+  uint32_t version_;
+  mutable bool matrix_dirty_;
+  mutable bool inverse_dirty_;
+};
+/// @brief Decompose an affine transform Matrix into position, rotation and
+/// scale.
+///
+/// This is the inverse of Matrix::Transform().  Unlike extracting each
+/// component with Matrix::TranslationVector3D(), Matrix::ScaleVector3D() and
+/// Quaternion::FromMatrix() this makes a single pass over the matrix and
+/// selects the quaternion calculation without branching, so arrays of
+/// matrices can be decomposed with SIMD instructions.  Reflections are
+/// returned as a negative scale along the x axis.
+///
+/// @param matrix Matrix to decompose.
+/// @param position Receives the translation of the matrix.
+/// @param rotation Receives the rotation as a unit quaternion with a
+/// non-negative scalar component.
+/// @param scale Receives the scale along each local axis.
+/// @param tolerance Maximum absolute cosine of the angle between the axes
+/// and maximum difference between the bottom row of the matrix and
+/// (0, 0, 0, 1).
+/// @return true if the matrix was decomposed, false if it has shear, a
+/// projection or a zero scale.  When false is returned the outputs only
+/// approximate the matrix.
+template <class T>
+inline bool Decompose(const Matrix<T, 4>& matrix, Vector<T, 3>* position,
+                      Quaternion<T>* rotation, Vector<T, 3>* scale,
+                      T tolerance = static_cast<T>(1e-4)) {
+  return DecomposeHelper(matrix, tolerance, position, rotation, scale);
+}
+
+/// @brief Decompose an array of affine transform matrices into position,
+/// rotation and scale.
+///
+/// Each matrix is decomposed as Decompose(const Matrix<T, 4>&, Vector<T, 3>*,
+/// Quaternion<T>*, Vector<T, 3>*, T) does, with identical results.  Float
+/// matrices are decomposed 4 at a time when MATHFU_COMPILE_WITH_SSE2 is
+/// defined.
+///
+/// @param matrices Array of count matrices to decompose.
+/// @param count Number of matrices.
+/// @param positions Array of count elements which receives the translations.
+/// @param rotations Array of count elements which receives the rotations.
+/// @param scales Array of count elements which receives the scales.
+/// @param valid Optional array of count elements which receives the result of
+/// each decomposition, may be NULL.
+/// @param tolerance See Decompose().
+/// @return Number of matrices which were decomposed without shear,
+/// projection or zero scale.
+template <class T>
+inline size_t Decompose(const Matrix<T, 4>* matrices, size_t count,
+                        Vector<T, 3>* positions, Quaternion<T>* rotations,
+                        Vector<T, 3>* scales, bool* valid,
+                        T tolerance = static_cast<T>(1e-4)) {
+  size_t num_valid = 0;
+  size_t i = DecomposeSimd(matrices, count, tolerance, positions, rotations,
+                           scales, valid, &num_valid);
+  for (; i < count; ++i) {
+    const bool is_valid = DecomposeHelper(matrices[i], tolerance,
+                                          &positions[i], &rotations[i],
+                                          &scales[i]);
+    if (valid) valid[i] = is_valid;
+    num_valid += is_valid;
+  }
+  return num_valid;
+}
+/// @}
+
+}  // namespace mathfu
+
+#endif  // MATHFU_TRANSFORM_H_
@@ -36,6 +36,7 @@
 ///
 /// @li @ref MATHFU_COMPILE_WITHOUT_SIMD_SUPPORT
 /// @li @ref MATHFU_COMPILE_FORCE_PADDING
+/// @li @ref MATHFU_COMPILE_WITH_VECTOR_EXTENSIONS
 ///
 /// <table>
 /// <tr>
@@ -80,9 +81,36 @@
 #define MATHFU_COMPILE_WITHOUT_SIMD_SUPPORT
 /// @}
 #endif  // DOXYGEN
+#ifdef DOXYGEN
+/// @addtogroup mathfu_build_config
+/// @{
+/// @def MATHFU_COMPILE_WITH_VECTOR_EXTENSIONS
+/// @brief Implement SIMD operations with GCC / Clang vector extensions.
+///
+/// When defined, the SIMD specializations of Vector are implemented using
+/// the vector extensions of GCC and Clang rather than the [vectorial][]
+/// library, so vectorial is not required to build the project.  Since the
+/// compiler generates code for the vector extensions for any target, SIMD
+/// is also enabled on architectures other than x86 and ARM NEON.  This
+/// option is ignored by other compilers.
+///
+/// To use this build option, this macro <b>must</b> be defined in all modules
+/// of the project.
+///
+///   [vectorial]: http://github.com/scoopr/vectorial
+#define MATHFU_COMPILE_WITH_VECTOR_EXTENSIONS
+/// @}
+#endif  // DOXYGEN
+#if defined(MATHFU_COMPILE_WITH_VECTOR_EXTENSIONS) && \
+    !(defined(__GNUC__) || defined(__clang__))
+#undef MATHFU_COMPILE_WITH_VECTOR_EXTENSIONS
+#endif
+
 #if !defined(MATHFU_COMPILE_WITHOUT_SIMD_SUPPORT)
 #if defined(__SSE__)
 #define MATHFU_COMPILE_WITH_SIMD
+#elif defined(MATHFU_COMPILE_WITH_VECTOR_EXTENSIONS)
+#define MATHFU_COMPILE_WITH_SIMD
 #elif defined(__ARM_NEON__)
 #define MATHFU_COMPILE_WITH_SIMD
 #elif defined(_M_IX86_FP)  // MSVC
@@ -149,6 +177,25 @@
 #endif  // MATHFU_COMPILE_WITH_PADDING
 #endif  // MATHFU_COMPILE_FORCE_PADDING == 1
 #endif  // MATHFU_COMPILE_FORCE_PADDING
+
+/// @addtogroup mathfu_build_config
+/// @{
+/// @def MATHFU_COMPILE_WITH_SSE2
+/// @brief Enable code paths which use SSE2 intrinsics directly.
+///
+/// These implement operations the SIMD library used by the Vector classes
+/// (see mathfu/internal/simd4f.h) cannot express, such as integer and packed
+/// data conversions, matrix transposes, reciprocal square root estimates and
+/// lane masks in the batch functions.  They are only available on x86, where
+/// they are used with either SIMD backend, other architectures use the
+/// scalar implementations of these functions.  This option is defined when
+/// SIMD is enabled and the target supports SSE2.
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATHFU_COMPILE_WITH_SSE2
+#include <emmintrin.h>
+#endif
+/// @}
 /// @endcond
 #endif  // MATHFU_COMPILE_WITH_SIMD
 
@@ -344,6 +391,61 @@ bool InRange(T val, T range_start, T range_end) {
   return val >= range_start && val < range_end;
 }
 
+/// @brief Calculate an approximation of 1 / x.
+/// @anchor mathfu_ReciprocalFast
+///
+/// When SSE2 is enabled the float version refines the estimate of the rcpss
+/// instruction with one Newton-Raphson step.  The result is within 3 ULP of
+/// 1 / x when the magnitude of x is between 2^-126 and 2^125, otherwise the
+/// result may be zero or infinity.  Other types and targets calculate 1 / x.
+///
+/// @param x Value to calculate the reciprocal of.
+/// @return Approximation of 1 / x.
+template <class T>
+inline T ReciprocalFast(T x) {
+  return T(1) / x;
+}
+
+/// @brief Calculate an approximation of 1 / sqrt(x).
+/// @anchor mathfu_ReciprocalSqrtFast
+///
+/// When SSE2 is enabled the float version refines the estimate of the
+/// rsqrtss instruction with one Newton-Raphson step.  The result is within
+/// 3 ULP of 1 / sqrt(x) when x is a positive normal value.  Other types and
+/// targets calculate 1 / sqrt(x).
+///
+/// @param x Value to calculate the reciprocal square root of.
+/// @return Approximation of 1 / sqrt(x).
+template <class T>
+inline T ReciprocalSqrtFast(T x) {
+  return T(1) / sqrt(x);
+}
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+/// @cond MATHFU_INTERNAL
+template <>
+inline float ReciprocalFast(float x) {
+  // y = y * (2 - x * y)
+  const __m128 value = _mm_set_ss(x);
+  const __m128 estimate = _mm_rcp_ss(value);
+  return _mm_cvtss_f32(_mm_mul_ss(
+      estimate,
+      _mm_sub_ss(_mm_set_ss(2.0f), _mm_mul_ss(value, estimate))));
+}
+
+template <>
+inline float ReciprocalSqrtFast(float x) {
+  // y = y * (3 - x * y * y) / 2
+  const __m128 value = _mm_set_ss(x);
+  const __m128 estimate = _mm_rsqrt_ss(value);
+  return _mm_cvtss_f32(_mm_mul_ss(
+      _mm_mul_ss(_mm_set_ss(0.5f), estimate),
+      _mm_sub_ss(_mm_set_ss(3.0f),
+                 _mm_mul_ss(_mm_mul_ss(value, estimate), estimate))));
+}
+/// @endcond
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
 /// @brief  Generate a random value of type T.
 /// @anchor mathfu_Random
 ///
@@ -351,7 +453,9 @@ bool InRange(T val, T range_start, T range_end) {
 /// 0.0 and less than 1.0.
 ///
 /// This function uses the standard C library function rand() from math.h to
-/// generate the random number.
+/// generate the random number.  rand() shares state between threads, see
+/// RandomGenerator in mathfu/random.h for a faster generator with per thread
+/// state.
 ///
 /// @returns Random number greater than or equal to 0.0 and less than 1.0.
 ///
@@ -61,6 +61,15 @@
   }
 /// @endcond
 
+/// @cond MATHFU_INTERNAL
+#define MATHFU_VECTOR_MASK_OPERATOR(OP)                                   \
+  {                                                                       \
+    VectorMask<Dims> result;                                              \
+    MATHFU_VECTOR_OPERATION(result.data_[i] = -static_cast<int32_t>(OP)); \
+    return result;                                                        \
+  }
+/// @endcond
+
 namespace mathfu {
 
 template <class T, int Dims>
@@ -398,6 +407,52 @@ class Vector {
   /// @return The normalized vector.
   inline Vector<T, Dims> Normalized() const { return NormalizedHelper(*this); }
 
+  /// @brief Calculate an approximation of the length of this vector.
+  ///
+  /// This uses ReciprocalSqrtFast() so for float vectors the result is
+  /// within 4 ULP of Length() (ignoring the error of LengthSquared()).
+  ///
+  /// @return The approximate length of this vector.
+  inline T LengthFast() const { return LengthFastHelper(*this); }
+
+  /// @brief Normalize this vector in-place using an approximation of the
+  /// length.
+  ///
+  /// @see LengthFast()
+  ///
+  /// @return The approximate length of this vector.
+  inline T NormalizeFast() { return NormalizeFastHelper(*this); }
+
+  /// @brief Calculate the normalized version of this vector using an
+  /// approximation of the length.
+  ///
+  /// @see LengthFast()
+  ///
+  /// @return The normalized vector.
+  inline Vector<T, Dims> NormalizedFast() const {
+    return NormalizedFastHelper(*this);
+  }
+
+  /// @brief Calculate the sum of the elements of this vector.
+  ///
+  /// @return The sum of the elements.
+  inline T Sum() const { return SumHelper(*this); }
+
+  /// @brief Calculate the product of the elements of this vector.
+  ///
+  /// @return The product of the elements.
+  inline T Product() const { return ProductHelper(*this); }
+
+  /// @brief Find the smallest element of this vector.
+  ///
+  /// @return The value of the smallest element.
+  inline T MinComponent() const { return MinComponentHelper(*this); }
+
+  /// @brief Find the largest element of this vector.
+  ///
+  /// @return The value of the largest element.
+  inline T MaxComponent() const { return MaxComponentHelper(*this); }
+
   /// @brief Load from any type that is some formulation of a length Dims array
   /// of
   ///        type T.
@@ -536,6 +591,110 @@ class Vector {
 /// @addtogroup mathfu_vector
 /// @{
 
+/// @class VectorMask "mathfu/vector.h"
+/// @brief Result of a lane-wise comparison of two Vectors.
+///
+/// Each element of the mask has all bits set when the comparison of the
+/// corresponding Vector elements is true and is zero otherwise, which matches
+/// the result of SIMD compare instructions.  Masks are used with Select() to
+/// choose between the elements of two Vectors without branches.
+///
+/// @tparam Dims Dimensions (number of elements) of the compared Vectors.
+template <int Dims>
+class VectorMask {
+ public:
+  /// @brief Create an uninitialized mask.
+  inline VectorMask() {}
+
+  /// @brief Create a mask with all elements set to a value.
+  ///
+  /// @param value Value of every element.
+  explicit inline VectorMask(bool value) {
+    MATHFU_VECTOR_OPERATION(data_[i] = value ? -1 : 0);
+  }
+
+  /// @brief Access an element of the mask.
+  ///
+  /// @param i Index of the element to access.
+  /// @return true if the element is set, false otherwise.
+  inline bool operator[](const int i) const { return data_[i] != 0; }
+
+  /// @brief Pack the elements of the mask into an integer.
+  ///
+  /// This matches the result of the movemask SIMD instructions.
+  ///
+  /// @return Integer where bit i is set if element i of the mask is set.
+  inline uint32_t MoveMask() const {
+    MATHFU_STATIC_ASSERT(Dims <= 32);
+    uint32_t bits = 0;
+    MATHFU_VECTOR_OPERATION(bits |= (static_cast<uint32_t>(data_[i]) & 1U)
+                                    << i);
+    return bits;
+  }
+
+  /// @brief Determine whether any element of the mask is set.
+  ///
+  /// @return true if any element is set, false otherwise.
+  inline bool Any() const {
+    int32_t any = 0;
+    MATHFU_VECTOR_OPERATION(any |= data_[i]);
+    return any != 0;
+  }
+
+  /// @brief Determine whether all elements of the mask are set.
+  ///
+  /// @return true if all elements are set, false otherwise.
+  inline bool All() const {
+    int32_t all = -1;
+    MATHFU_VECTOR_OPERATION(all &= data_[i]);
+    return all != 0;
+  }
+
+  /// Elements of the mask, -1 (all bits set) or 0.
+  int32_t data_[Dims];
+};
+
+/// @brief Calculate the lane-wise logical AND of two masks.
+///
+/// @param lhs First mask.
+/// @param rhs Second mask.
+/// @return Mask containing the result.
+template <int Dims>
+inline VectorMask<Dims> operator&(const VectorMask<Dims>& lhs,
+                                  const VectorMask<Dims>& rhs) {
+  VectorMask<Dims> result;
+  MATHFU_VECTOR_OPERATION(result.data_[i] = lhs.data_[i] & rhs.data_[i]);
+  return result;
+}
+
+/// @brief Calculate the lane-wise logical OR of two masks.
+///
+/// @param lhs First mask.
+/// @param rhs Second mask.
+/// @return Mask containing the result.
+template <int Dims>
+inline VectorMask<Dims> operator|(const VectorMask<Dims>& lhs,
+                                  const VectorMask<Dims>& rhs) {
+  VectorMask<Dims> result;
+  MATHFU_VECTOR_OPERATION(result.data_[i] = lhs.data_[i] | rhs.data_[i]);
+  return result;
+}
+
+/// @brief Calculate the lane-wise logical NOT of a mask.
+///
+/// @param mask Mask to invert.
+/// @return Mask containing the result.
+template <int Dims>
+inline VectorMask<Dims> operator~(const VectorMask<Dims>& mask) {
+  VectorMask<Dims> result;
+  MATHFU_VECTOR_OPERATION(result.data_[i] = ~mask.data_[i]);
+  return result;
+}
+/// @}
+
+/// @addtogroup mathfu_vector
+/// @{
+
 /// @brief Compare 2 Vectors of the same size for equality.
 ///
 /// @note: The likelyhood of two float values being the same is very small.
@@ -560,6 +719,92 @@ inline bool operator!=(const Vector<T, Dims>& lhs, const Vector<T, Dims>& rhs) {
   return !(lhs == rhs);
 }
 
+/// @brief Lane-wise compare whether each element of a Vector is less than
+/// the corresponding element of another Vector.
+///
+/// @param lhs First Vector.
+/// @param rhs Second Vector.
+/// @return Mask where each element is set if lhs[i] < rhs[i].
+template <class T, int Dims>
+inline VectorMask<Dims> operator<(const Vector<T, Dims>& lhs,
+                                  const Vector<T, Dims>& rhs) {
+  MATHFU_VECTOR_MASK_OPERATOR(lhs[i] < rhs[i]);
+}
+
+/// @brief Lane-wise compare whether each element of a Vector is
+/// less than or equal to the corresponding element of another Vector.
+///
+/// @param lhs First Vector.
+/// @param rhs Second Vector.
+/// @return Mask where each element is set if lhs[i] <= rhs[i].
+template <class T, int Dims>
+inline VectorMask<Dims> operator<=(const Vector<T, Dims>& lhs,
+                                   const Vector<T, Dims>& rhs) {
+  MATHFU_VECTOR_MASK_OPERATOR(lhs[i] <= rhs[i]);
+}
+
+/// @brief Lane-wise compare whether each element of a Vector is greater than
+/// the corresponding element of another Vector.
+///
+/// @param lhs First Vector.
+/// @param rhs Second Vector.
+/// @return Mask where each element is set if lhs[i] > rhs[i].
+template <class T, int Dims>
+inline VectorMask<Dims> operator>(const Vector<T, Dims>& lhs,
+                                  const Vector<T, Dims>& rhs) {
+  MATHFU_VECTOR_MASK_OPERATOR(lhs[i] > rhs[i]);
+}
+
+/// @brief Lane-wise compare whether each element of a Vector is
+/// greater than or equal to the corresponding element of another Vector.
+///
+/// @param lhs First Vector.
+/// @param rhs Second Vector.
+/// @return Mask where each element is set if lhs[i] >= rhs[i].
+template <class T, int Dims>
+inline VectorMask<Dims> operator>=(const Vector<T, Dims>& lhs,
+                                   const Vector<T, Dims>& rhs) {
+  MATHFU_VECTOR_MASK_OPERATOR(lhs[i] >= rhs[i]);
+}
+
+/// @brief Lane-wise compare two Vectors for equality.
+///
+/// Unlike operator==(), which compares whole Vectors, this compares each
+/// element.
+///
+/// @param lhs First Vector.
+/// @param rhs Second Vector.
+/// @return Mask where each element is set if lhs[i] == rhs[i].
+template <class T, int Dims>
+inline VectorMask<Dims> Equal(const Vector<T, Dims>& lhs,
+                              const Vector<T, Dims>& rhs) {
+  MATHFU_VECTOR_MASK_OPERATOR(lhs[i] == rhs[i]);
+}
+
+/// @brief Lane-wise compare two Vectors for inequality.
+///
+/// @param lhs First Vector.
+/// @param rhs Second Vector.
+/// @return Mask where each element is set if lhs[i] != rhs[i].
+template <class T, int Dims>
+inline VectorMask<Dims> NotEqual(const Vector<T, Dims>& lhs,
+                                 const Vector<T, Dims>& rhs) {
+  MATHFU_VECTOR_MASK_OPERATOR(lhs[i] != rhs[i]);
+}
+
+/// @brief Select the elements of one of two Vectors using a mask.
+///
+/// @param mask Mask which selects the source of each element.
+/// @param v1 Vector whose elements are selected where the mask is set.
+/// @param v2 Vector whose elements are selected where the mask is not set.
+/// @return Vector containing the result.
+template <class T, int Dims>
+inline Vector<T, Dims> Select(const VectorMask<Dims>& mask,
+                              const Vector<T, Dims>& v1,
+                              const Vector<T, Dims>& v2) {
+  MATHFU_VECTOR_OPERATOR(mask.data_[i] ? v1[i] : v2[i]);
+}
+
 /// @brief Negate all elements of the Vector.
 ///
 /// @return A new Vector containing the result.
@@ -862,6 +1107,84 @@ inline Vector<T, Dims> NormalizedHelper(const Vector<T, Dims>& v) {
   return v * (T(1) / LengthHelper(v));
 }
 
+/// @brief Calculate an approximation of the length of a vector.
+///
+/// @param v Vector to get the length of.
+/// @return The approximate length of the vector.
+template <class T, int Dims>
+inline T LengthFastHelper(const Vector<T, Dims>& v) {
+  const T length_squared = LengthSquaredHelper(v);
+  return length_squared > T(0)
+             ? length_squared * ReciprocalSqrtFast(length_squared)
+             : T(0);
+}
+
+/// @brief Normalize a vector in-place using an approximation of the length.
+///
+/// @param v Vector to normalize.
+/// @return The approximate length of the vector.
+template <class T, int Dims>
+inline T NormalizeFastHelper(Vector<T, Dims>& v) {
+  const T length_squared = LengthSquaredHelper(v);
+  const T scale = ReciprocalSqrtFast(length_squared);
+  v *= scale;
+  return length_squared * scale;
+}
+
+/// @brief Calculate the normalized version of a vector using an
+/// approximation of the length.
+///
+/// @param v Vector to get the normalized version of.
+/// @return The normalized vector.
+template <class T, int Dims>
+inline Vector<T, Dims> NormalizedFastHelper(const Vector<T, Dims>& v) {
+  return v * ReciprocalSqrtFast(LengthSquaredHelper(v));
+}
+
+/// @brief Calculate the sum of the elements of a vector.
+///
+/// @param v Vector to sum.
+/// @return The sum of the elements.
+template <class T, int Dims>
+inline T SumHelper(const Vector<T, Dims>& v) {
+  T sum = v[0];
+  for (int i = 1; i < Dims; ++i) sum += v[i];
+  return sum;
+}
+
+/// @brief Calculate the product of the elements of a vector.
+///
+/// @param v Vector to multiply the elements of.
+/// @return The product of the elements.
+template <class T, int Dims>
+inline T ProductHelper(const Vector<T, Dims>& v) {
+  T product = v[0];
+  for (int i = 1; i < Dims; ++i) product *= v[i];
+  return product;
+}
+
+/// @brief Find the smallest element of a vector.
+///
+/// @param v Vector to search.
+/// @return The value of the smallest element.
+template <class T, int Dims>
+inline T MinComponentHelper(const Vector<T, Dims>& v) {
+  T result = v[0];
+  for (int i = 1; i < Dims; ++i) result = v[i] < result ? v[i] : result;
+  return result;
+}
+
+/// @brief Find the largest element of a vector.
+///
+/// @param v Vector to search.
+/// @return The value of the largest element.
+template <class T, int Dims>
+inline T MaxComponentHelper(const Vector<T, Dims>& v) {
+  T result = v[0];
+  for (int i = 1; i < Dims; ++i) result = v[i] > result ? v[i] : result;
+  return result;
+}
+
 /// @brief Linearly interpolate two vectors.
 ///
 /// @param v1 First vector.
@@ -1077,9 +1400,11 @@ inline Vector<T, Dims> Clamp(const Vector<T, Dims>& x,
 // For example, if you include vector.h, use Vector<float, 3>, and then
 // include vector_3.h, you the compiler will generate an error since you're
 // specializing something that has already been instantiated.
+#include "mathfu/internal/vector_int_simd.h"
 #include "mathfu/internal/vector_2_simd.h"
 #include "mathfu/internal/vector_3_simd.h"
 #include "mathfu/internal/vector_4_simd.h"
+#include "mathfu/internal/vector_wide_simd.h"
 
 #if defined(_MSC_VER)
 #pragma warning(pop)
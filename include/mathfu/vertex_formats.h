@@ -0,0 +1,572 @@
+/*
+* Copyright 2016 Google Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef MATHFU_VERTEX_FORMATS_H_
+#define MATHFU_VERTEX_FORMATS_H_
+
+#include "mathfu/utilities.h"
+#include "mathfu/vector.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+#include <emmintrin.h>
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
+/// @file mathfu/vertex_formats.h
+/// @brief Compressed storage formats for vertex and texture data.
+///
+/// Vectors are stored as normalized integers, which map the range of the
+/// integer type to [-1, 1] for signed (snorm) types or [0, 1] for unsigned
+/// (unorm) types, following the conversion rules used by graphics APIs.
+/// Values are rounded to the nearest integer, ties away from -infinity, and
+/// values outside of the representable range are clamped.
+///
+/// Each storage type can be converted individually or, much faster, as an
+/// array using PackVectors() and UnpackVectors().  PackVectors() produces
+/// results identical to converting each element, UnpackVectors() matches
+/// Unpack() to within rounding as the compiler may contract the scalar
+/// conversion into fused multiply-adds.
+
+namespace mathfu {
+
+/// @cond MATHFU_INTERNAL
+// Range of the values stored in a normalized integer type.
+template <class T>
+struct NormalizedIntegerRange;
+
+template <>
+struct NormalizedIntegerRange<int8_t> {
+  static inline float Min() { return -1.0f; }
+  static inline float Max() { return 127.0f; }
+};
+
+template <>
+struct NormalizedIntegerRange<uint8_t> {
+  static inline float Min() { return 0.0f; }
+  static inline float Max() { return 255.0f; }
+};
+
+template <>
+struct NormalizedIntegerRange<int16_t> {
+  static inline float Min() { return -1.0f; }
+  static inline float Max() { return 32767.0f; }
+};
+
+template <>
+struct NormalizedIntegerRange<uint16_t> {
+  static inline float Min() { return 0.0f; }
+  static inline float Max() { return 65535.0f; }
+};
+
+// Convert value in [min, 1] to an integer in [min * max, max].
+inline int32_t QuantizeNormalized(float value, float min, float max) {
+  return static_cast<int32_t>(floorf(Clamp(value, min, 1.0f) * max + 0.5f));
+}
+
+// Convert an integer in [min * max, max] to a value in [min, 1].
+inline float DequantizeNormalized(int32_t value, float min, float max) {
+  return std::max(min, static_cast<float>(value) * (1.0f / max));
+}
+
+// Convert a unit vector to octahedral coordinates in [-1, 1].
+inline void OctahedralEncode(float x, float y, float z, float* u, float* v) {
+  const float inverse_norm = 1.0f / (fabsf(x) + fabsf(y) + fabsf(z));
+  *u = x * inverse_norm;
+  *v = y * inverse_norm;
+  if (z < 0.0f) {
+    // Fold the lower hemisphere over the diagonals.
+    const float folded_u = (1.0f - fabsf(*v)) * (*u >= 0.0f ? 1.0f : -1.0f);
+    *v = (1.0f - fabsf(*u)) * (*v >= 0.0f ? 1.0f : -1.0f);
+    *u = folded_u;
+  }
+}
+
+// Convert octahedral coordinates to a unit vector.
+inline Vector<float, 3> OctahedralDecode(float u, float v) {
+  const float z = 1.0f - fabsf(u) - fabsf(v);
+  const float fold = -z > 0.0f ? -z : 0.0f;
+  const float x = u + (u >= 0.0f ? -fold : fold);
+  const float y = v + (v >= 0.0f ? -fold : fold);
+  const float inverse_length = 1.0f / sqrtf(x * x + y * y + z * z);
+  return Vector<float, 3>(x * inverse_length, y * inverse_length,
+                          z * inverse_length);
+}
+
+#ifdef MATHFU_COMPILE_WITH_SSE2
+// Quantize 4 values, rounding like QuantizeNormalized().
+inline __m128i QuantizeNormalized4(__m128 value, float min, float max) {
+  // Clamp in the same order as Clamp() so NaN is converted to min.
+  const __m128 clamped =
+      _mm_max_ps(_mm_min_ps(_mm_set1_ps(1.0f), value), _mm_set1_ps(min));
+  const __m128 biased =
+      _mm_add_ps(_mm_mul_ps(clamped, _mm_set1_ps(max)), _mm_set1_ps(0.5f));
+  const __m128i truncated = _mm_cvttps_epi32(biased);
+  // Truncation rounds negative values up, subtract 1 to floor them.
+  const __m128 rounded_up = _mm_cmplt_ps(biased, _mm_cvtepi32_ps(truncated));
+  return _mm_add_epi32(truncated, _mm_castps_si128(rounded_up));
+}
+
+// Dequantize 4 values like DequantizeNormalized().
+inline __m128 DequantizeNormalized4(__m128i value, float min, float max) {
+  return _mm_max_ps(_mm_set1_ps(min), _mm_mul_ps(_mm_cvtepi32_ps(value),
+                                                 _mm_set1_ps(1.0f / max)));
+}
+
+// Store 4 32-bit lanes, which are within the range of the output type.
+inline void StoreNormalized4(__m128i value, int8_t* output) {
+  const __m128i packed =
+      _mm_packs_epi16(_mm_packs_epi32(value, value), _mm_setzero_si128());
+  const int32_t bytes = _mm_cvtsi128_si32(packed);
+  memcpy(output, &bytes, sizeof(bytes));
+}
+
+inline void StoreNormalized4(__m128i value, uint8_t* output) {
+  const __m128i packed =
+      _mm_packus_epi16(_mm_packs_epi32(value, value), _mm_setzero_si128());
+  const int32_t bytes = _mm_cvtsi128_si32(packed);
+  memcpy(output, &bytes, sizeof(bytes));
+}
+
+inline void StoreNormalized4(__m128i value, int16_t* output) {
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(output),
+                   _mm_packs_epi32(value, value));
+}
+
+inline void StoreNormalized4(__m128i value, uint16_t* output) {
+  // SSE2 only has a signed saturating pack, so bias into the signed range.
+  const __m128i bias = _mm_set1_epi32(0x8000);
+  const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(value, bias),
+                                         _mm_setzero_si128());
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(output),
+                   _mm_xor_si128(packed, _mm_set1_epi16(-0x8000)));
+}
+
+// Load 4 values and extend them to 32-bit lanes.
+inline __m128i LoadNormalized4(const int8_t* input) {
+  int32_t bytes;
+  memcpy(&bytes, input, sizeof(bytes));
+  const __m128i value = _mm_cvtsi32_si128(bytes);
+  const __m128i words = _mm_unpacklo_epi8(value, value);
+  return _mm_srai_epi32(_mm_unpacklo_epi16(words, words), 24);
+}
+
+inline __m128i LoadNormalized4(const uint8_t* input) {
+  int32_t bytes;
+  memcpy(&bytes, input, sizeof(bytes));
+  const __m128i zero = _mm_setzero_si128();
+  return _mm_unpacklo_epi16(
+      _mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero);
+}
+
+inline __m128i LoadNormalized4(const int16_t* input) {
+  const __m128i value =
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(input));
+  return _mm_srai_epi32(_mm_unpacklo_epi16(value, value), 16);
+}
+
+inline __m128i LoadNormalized4(const uint16_t* input) {
+  return _mm_unpacklo_epi16(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(input)),
+      _mm_setzero_si128());
+}
+
+// Select a where mask is set, b otherwise.
+inline __m128 VertexFormatSelect(__m128 mask, __m128 a, __m128 b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+#endif  // MATHFU_COMPILE_WITH_SSE2
+
+// Quantize an array of count vectors into count * Dims normalized integers.
+template <class T, int Dims>
+inline void PackNormalized(const Vector<float, Dims>* vectors, size_t count,
+                           T* output) {
+  typedef NormalizedIntegerRange<T> Range;
+  size_t i = 0;
+#ifdef MATHFU_COMPILE_WITH_SSE2
+  if (sizeof(Vector<float, Dims>) == sizeof(float) * Dims) {
+    // Vectors are contiguous so the elements can be converted as one array.
+    const size_t elements = count * Dims;
+    const float* const input = reinterpret_cast<const float*>(vectors);
+    for (; i + 4 <= elements; i += 4) {
+      StoreNormalized4(QuantizeNormalized4(_mm_loadu_ps(&input[i]),
+                                           Range::Min(), Range::Max()),
+                       &output[i]);
+    }
+    for (; i < elements; ++i) {
+      output[i] = static_cast<T>(
+          QuantizeNormalized(input[i], Range::Min(), Range::Max()));
+    }
+    return;
+  }
+  // Padded vectors are converted one at a time.
+  for (; i < count; ++i) {
+    float lanes[4] = {0};
+    for (int j = 0; j < Dims; ++j) lanes[j] = vectors[i][j];
+    T values[4];
+    StoreNormalized4(
+        QuantizeNormalized4(_mm_loadu_ps(lanes), Range::Min(), Range::Max()),
+        values);
+    memcpy(&output[i * Dims], values, sizeof(T) * Dims);
+  }
+#endif  // MATHFU_COMPILE_WITH_SSE2
+  for (; i < count; ++i) {
+    for (int j = 0; j < Dims; ++j) {
+      output[i * Dims + j] = static_cast<T>(
+          QuantizeNormalized(vectors[i][j], Range::Min(), Range::Max()));
+    }
+  }
+}
+
+// Dequantize count * Dims normalized integers into an array of vectors.
+template <class T, int Dims>
+inline void UnpackNormalized(const T* input, size_t count,
+                             Vector<float, Dims>* vectors) {
+  typedef NormalizedIntegerRange<T> Range;
+  size_t i = 0;
+#ifdef MATHFU_COMPILE_WITH_SSE2
+  if (sizeof(Vector<float, Dims>) == sizeof(float) * Dims) {
+    const size_t elements = count * Dims;
+    float* const output = reinterpret_cast<float*>(vectors);
+    for (; i + 4 <= elements; i += 4) {
+      _mm_storeu_ps(&output[i],
+                    DequantizeNormalized4(LoadNormalized4(&input[i]),
+                                          Range::Min(), Range::Max()));
+    }
+    for (; i < elements; ++i) {
+      output[i] = DequantizeNormalized(input[i], Range::Min(), Range::Max());
+    }
+    return;
+  }
+  for (; i < count; ++i) {
+    T values[4] = {0};
+    memcpy(values, &input[i * Dims], sizeof(T) * Dims);
+    float lanes[4];
+    _mm_storeu_ps(lanes, DequantizeNormalized4(LoadNormalized4(values),
+                                               Range::Min(), Range::Max()));
+    for (int j = 0; j < Dims; ++j) vectors[i][j] = lanes[j];
+  }
+#endif  // MATHFU_COMPILE_WITH_SSE2
+  for (; i < count; ++i) {
+    for (int j = 0; j < Dims; ++j) {
+      vectors[i][j] = DequantizeNormalized(input[i * Dims + j], Range::Min(),
+                                           Range::Max());
+    }
+  }
+}
+/// @endcond
+
+/// @addtogroup mathfu_vector
+/// @{
+
+/// @class VectorPackedNormalized "mathfu/vertex_formats.h"
+/// @brief Packed N-dimensional vector of normalized integers.
+///
+/// Signed element types (int8_t, int16_t) store snorm values in [-1, 1],
+/// where the most negative integer also represents -1.  Unsigned element
+/// types (uint8_t, uint16_t) store unorm values in [0, 1].
+///
+/// @tparam T type of each element, int8_t, uint8_t, int16_t or uint16_t.
+/// @tparam Dims dimensions (number of elements) in the structure.
+template <class T, int Dims>
+struct VectorPackedNormalized {
+  /// Create an uninitialized VectorPackedNormalized.
+  VectorPackedNormalized() {}
+
+  /// Create a VectorPackedNormalized from a Vector.
+  ///
+  /// @param vector Vector to pack.  Elements are clamped to the range of
+  /// the format.
+  explicit VectorPackedNormalized(const Vector<float, Dims>& vector) {
+    PackNormalized(&vector, 1, data_);
+  }
+
+  /// Convert this object to a Vector.
+  ///
+  /// @return Vector containing the unpacked values of this object.
+  Vector<float, Dims> Unpack() const {
+    Vector<float, Dims> vector;
+    UnpackNormalized(data_, 1, &vector);
+    return vector;
+  }
+
+  /// Elements of the packed vector one per dimension.
+  T data_[Dims];
+};
+
+/// @class VectorPackedRGB10A2 "mathfu/vertex_formats.h"
+/// @brief 4-dimensional vector packed into 32 bits as unorm values.
+///
+/// The first three elements are stored with 10 bits and the last element
+/// with 2 bits, matching the RGB10_A2 / R10G10B10A2_UNORM texture and
+/// vertex formats.
+struct VectorPackedRGB10A2 {
+  /// Create an uninitialized VectorPackedRGB10A2.
+  VectorPackedRGB10A2() {}
+
+  /// Create a VectorPackedRGB10A2 from a Vector.
+  ///
+  /// @param vector Vector to pack.  Elements are clamped to [0, 1].
+  explicit VectorPackedRGB10A2(const Vector<float, 4>& vector) {
+    const uint32_t x = QuantizeNormalized(vector[0], 0.0f, 1023.0f);
+    const uint32_t y = QuantizeNormalized(vector[1], 0.0f, 1023.0f);
+    const uint32_t z = QuantizeNormalized(vector[2], 0.0f, 1023.0f);
+    const uint32_t w = QuantizeNormalized(vector[3], 0.0f, 3.0f);
+    data_ = x | (y << 10) | (z << 20) | (w << 30);
+  }
+
+  /// Convert this object to a Vector.
+  ///
+  /// @return Vector containing the unpacked values of this object.
+  Vector<float, 4> Unpack() const {
+    return Vector<float, 4>(
+        DequantizeNormalized(data_ & 0x3FF, 0.0f, 1023.0f),
+        DequantizeNormalized((data_ >> 10) & 0x3FF, 0.0f, 1023.0f),
+        DequantizeNormalized((data_ >> 20) & 0x3FF, 0.0f, 1023.0f),
+        DequantizeNormalized(data_ >> 30, 0.0f, 3.0f));
+  }
+
+  /// Bits 0-9, 10-19 and 20-29 contain the first three elements and bits
+  /// 30-31 the last element.
+  uint32_t data_;
+};
+
+/// @class VectorPackedOctahedral "mathfu/vertex_formats.h"
+/// @brief Unit length 3-dimensional vector using the octahedral encoding.
+///
+/// The vector is projected onto an octahedron which is unfolded onto a
+/// square, the coordinates of the point in the square are stored as two
+/// snorm values.  This is well suited to normals and tangents: with int8_t
+/// elements (2 bytes) the angular error is less than 0.017 radians and with
+/// int16_t elements (4 bytes) less than 6.5e-5 radians.
+///
+/// @tparam T type of each element, int8_t or int16_t.
+template <class T>
+struct VectorPackedOctahedral {
+  /// Create an uninitialized VectorPackedOctahedral.
+  VectorPackedOctahedral() {}
+
+  /// Create a VectorPackedOctahedral from a Vector.
+  ///
+  /// @param vector Unit length vector to pack.
+  explicit VectorPackedOctahedral(const Vector<float, 3>& vector) {
+    typedef NormalizedIntegerRange<T> Range;
+    float u, v;
+    OctahedralEncode(vector[0], vector[1], vector[2], &u, &v);
+    data_[0] = static_cast<T>(QuantizeNormalized(u, -1.0f, Range::Max()));
+    data_[1] = static_cast<T>(QuantizeNormalized(v, -1.0f, Range::Max()));
+  }
+
+  /// Convert this object to a Vector.
+  ///
+  /// @return Unit length vector.
+  Vector<float, 3> Unpack() const {
+    typedef NormalizedIntegerRange<T> Range;
+    return OctahedralDecode(
+        DequantizeNormalized(data_[0], -1.0f, Range::Max()),
+        DequantizeNormalized(data_[1], -1.0f, Range::Max()));
+  }
+
+  /// Octahedral coordinates.
+  T data_[2];
+};
+
+/// @brief Pack an array of vectors.
+///
+/// @param vectors Array of count vectors to pack.
+/// @param count Number of vectors.
+/// @param packed Array of count elements which receives the result.
+template <class T, int Dims>
+inline void PackVectors(const Vector<float, Dims>* vectors, size_t count,
+                        VectorPackedNormalized<T, Dims>* packed) {
+  PackNormalized(vectors, count, reinterpret_cast<T*>(packed));
+}
+
+/// @brief Unpack an array of vectors.
+///
+/// @param packed Array of count packed vectors.
+/// @param count Number of vectors.
+/// @param vectors Array of count elements which receives the result.
+template <class T, int Dims>
+inline void UnpackVectors(const VectorPackedNormalized<T, Dims>* packed,
+                          size_t count, Vector<float, Dims>* vectors) {
+  UnpackNormalized(reinterpret_cast<const T*>(packed), count, vectors);
+}
+
+/// @brief Pack an array of vectors.
+///
+/// @param vectors Array of count vectors to pack.
+/// @param count Number of vectors.
+/// @param packed Array of count elements which receives the result.
+inline void PackVectors(const Vector<float, 4>* vectors, size_t count,
+                        VectorPackedRGB10A2* packed) {
+  size_t i = 0;
+#ifdef MATHFU_COMPILE_WITH_SSE2
+  for (; i + 4 <= count; i += 4) {
+    __m128 x = _mm_loadu_ps(&vectors[i][0]);
+    __m128 y = _mm_loadu_ps(&vectors[i + 1][0]);
+    __m128 z = _mm_loadu_ps(&vectors[i + 2][0]);
+    __m128 w = _mm_loadu_ps(&vectors[i + 3][0]);
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    const __m128i data = _mm_or_si128(
+        _mm_or_si128(QuantizeNormalized4(x, 0.0f, 1023.0f),
+                     _mm_slli_epi32(QuantizeNormalized4(y, 0.0f, 1023.0f),
+                                    10)),
+        _mm_or_si128(
+            _mm_slli_epi32(QuantizeNormalized4(z, 0.0f, 1023.0f), 20),
+            _mm_slli_epi32(QuantizeNormalized4(w, 0.0f, 3.0f), 30)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&packed[i].data_), data);
+  }
+#endif  // MATHFU_COMPILE_WITH_SSE2
+  for (; i < count; ++i) packed[i] = VectorPackedRGB10A2(vectors[i]);
+}
+
+/// @brief Unpack an array of vectors.
+///
+/// @param packed Array of count packed vectors.
+/// @param count Number of vectors.
+/// @param vectors Array of count elements which receives the result.
+inline void UnpackVectors(const VectorPackedRGB10A2* packed, size_t count,
+                          Vector<float, 4>* vectors) {
+  size_t i = 0;
+#ifdef MATHFU_COMPILE_WITH_SSE2
+  const __m128i mask = _mm_set1_epi32(0x3FF);
+  for (; i + 4 <= count; i += 4) {
+    const __m128i data =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&packed[i].data_));
+    __m128 x =
+        DequantizeNormalized4(_mm_and_si128(data, mask), 0.0f, 1023.0f);
+    __m128 y = DequantizeNormalized4(
+        _mm_and_si128(_mm_srli_epi32(data, 10), mask), 0.0f, 1023.0f);
+    __m128 z = DequantizeNormalized4(
+        _mm_and_si128(_mm_srli_epi32(data, 20), mask), 0.0f, 1023.0f);
+    __m128 w = DequantizeNormalized4(_mm_srli_epi32(data, 30), 0.0f, 3.0f);
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    _mm_storeu_ps(&vectors[i][0], x);
+    _mm_storeu_ps(&vectors[i + 1][0], y);
+    _mm_storeu_ps(&vectors[i + 2][0], z);
+    _mm_storeu_ps(&vectors[i + 3][0], w);
+  }
+#endif  // MATHFU_COMPILE_WITH_SSE2
+  for (; i < count; ++i) vectors[i] = packed[i].Unpack();
+}
+
+/// @brief Pack an array of unit vectors.
+///
+/// @param vectors Array of count unit vectors to pack.
+/// @param count Number of vectors.
+/// @param packed Array of count elements which receives the result.
+template <class T>
+inline void PackVectors(const Vector<float, 3>* vectors, size_t count,
+                        VectorPackedOctahedral<T>* packed) {
+  size_t i = 0;
+#ifdef MATHFU_COMPILE_WITH_SSE2
+  const float max = NormalizedIntegerRange<T>::Max();
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 sign_mask = _mm_set1_ps(-0.0f);
+  for (; i + 4 <= count; i += 4) {
+    const Vector<float, 3>* const v = &vectors[i];
+    const __m128 x = _mm_setr_ps(v[0][0], v[1][0], v[2][0], v[3][0]);
+    const __m128 y = _mm_setr_ps(v[0][1], v[1][1], v[2][1], v[3][1]);
+    const __m128 z = _mm_setr_ps(v[0][2], v[1][2], v[2][2], v[3][2]);
+    const __m128 inverse_norm = _mm_div_ps(
+        one, _mm_add_ps(_mm_add_ps(_mm_andnot_ps(sign_mask, x),
+                                   _mm_andnot_ps(sign_mask, y)),
+                        _mm_andnot_ps(sign_mask, z)));
+    const __m128 u = _mm_mul_ps(x, inverse_norm);
+    const __m128 w = _mm_mul_ps(y, inverse_norm);
+    // Signs of u and w with zero treated as positive.
+    const __m128 u_sign =
+        _mm_andnot_ps(_mm_cmpge_ps(u, zero), sign_mask);
+    const __m128 w_sign =
+        _mm_andnot_ps(_mm_cmpge_ps(w, zero), sign_mask);
+    const __m128 folded_u = _mm_mul_ps(
+        _mm_sub_ps(one, _mm_andnot_ps(sign_mask, w)), _mm_or_ps(one, u_sign));
+    const __m128 folded_w = _mm_mul_ps(
+        _mm_sub_ps(one, _mm_andnot_ps(sign_mask, u)), _mm_or_ps(one, w_sign));
+    const __m128 lower = _mm_cmplt_ps(z, zero);
+    const __m128i qu = QuantizeNormalized4(
+        VertexFormatSelect(lower, folded_u, u), -1.0f, max);
+    const __m128i qw = QuantizeNormalized4(
+        VertexFormatSelect(lower, folded_w, w), -1.0f, max);
+    T* const output = packed[i].data_;
+    StoreNormalized4(_mm_unpacklo_epi32(qu, qw), output);
+    StoreNormalized4(_mm_unpackhi_epi32(qu, qw), output + 4);
+  }
+#endif  // MATHFU_COMPILE_WITH_SSE2
+  for (; i < count; ++i) packed[i] = VectorPackedOctahedral<T>(vectors[i]);
+}
+
+/// @brief Unpack an array of unit vectors.
+///
+/// @param packed Array of count packed vectors.
+/// @param count Number of vectors.
+/// @param vectors Array of count elements which receives the result.
+template <class T>
+inline void UnpackVectors(const VectorPackedOctahedral<T>* packed,
+                          size_t count, Vector<float, 3>* vectors) {
+  size_t i = 0;
+#ifdef MATHFU_COMPILE_WITH_SSE2
+  const float max = NormalizedIntegerRange<T>::Max();
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 sign_mask = _mm_set1_ps(-0.0f);
+  for (; i + 4 <= count; i += 4) {
+    const T* const input = packed[i].data_;
+    const __m128 uv01 =
+        DequantizeNormalized4(LoadNormalized4(input), -1.0f, max);
+    const __m128 uv23 =
+        DequantizeNormalized4(LoadNormalized4(input + 4), -1.0f, max);
+    const __m128 u = _mm_shuffle_ps(uv01, uv23, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 w = _mm_shuffle_ps(uv01, uv23, _MM_SHUFFLE(3, 1, 3, 1));
+    const __m128 z = _mm_sub_ps(
+        _mm_sub_ps(one, _mm_andnot_ps(sign_mask, u)),
+        _mm_andnot_ps(sign_mask, w));
+    const __m128 minus_z = _mm_xor_ps(z, sign_mask);
+    const __m128 fold = _mm_and_ps(_mm_cmpgt_ps(minus_z, zero), minus_z);
+    // Move towards zero by fold.
+    const __m128 x = _mm_add_ps(
+        u, _mm_xor_ps(fold, _mm_and_ps(_mm_cmpge_ps(u, zero), sign_mask)));
+    const __m128 y = _mm_add_ps(
+        w, _mm_xor_ps(fold, _mm_and_ps(_mm_cmpge_ps(w, zero), sign_mask)));
+    const __m128 inverse_length = _mm_div_ps(
+        one, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x),
+                                               _mm_mul_ps(y, y)),
+                                    _mm_mul_ps(z, z))));
+    union {
+      __m128 simd[3];
+      float lanes[3][4];
+    } components;
+    components.simd[0] = _mm_mul_ps(x, inverse_length);
+    components.simd[1] = _mm_mul_ps(y, inverse_length);
+    components.simd[2] = _mm_mul_ps(z, inverse_length);
+    for (int j = 0; j < 4; ++j) {
+      vectors[i + j] =
+          Vector<float, 3>(components.lanes[0][j], components.lanes[1][j],
+                           components.lanes[2][j]);
+    }
+  }
+#endif  // MATHFU_COMPILE_WITH_SSE2
+  for (; i < count; ++i) vectors[i] = packed[i].Unpack();
+}
+/// @}
+
+}  // namespace mathfu
+
+#endif  // MATHFU_VERTEX_FORMATS_H_
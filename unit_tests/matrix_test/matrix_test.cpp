@@ -14,20 +14,27 @@
 * limitations under the License.
 */
 #include "mathfu/matrix.h"
+#include "mathfu/bounds.h"
 
 #include "mathfu/io.h"
+#include "mathfu/projector.h"
 #include "mathfu/quaternion.h"
+#include "mathfu/svd.h"
+#include "mathfu/transform.h"
 #include "mathfu/utilities.h"
 #include "mathfu/vector.h"
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 
 #include "precision.h"
 static const float kUnProjectFloatPrecision = 0.0012f;
+static const double kUnProjectDoublePrecision = 1e-11;
 static const double kLookAtDoublePrecision = 1e-8;
 class MatrixTests : public ::testing::Test {
  protected:
@@ -444,6 +451,27 @@ void InverseSmallScale_Test(const T& precision) {
 }
 TEST_ALL_F(InverseSmallScale, FLOAT_PRECISION, DOUBLE_PRECISION)
 
+// Test that a 4x4 matrix with a pivot below the determinant threshold is not
+// invertible, with or without SIMD, even though its determinant passes a
+// small threshold.
+template <class T>
+void InverseSmallPivot_Test() {
+  static const T kDeterminantThreshold =
+      mathfu::Constants<T>::GetDeterminantThreshold();
+  mathfu::Matrix<T, 4> matrix = mathfu::Matrix<T, 4>::Identity();
+  matrix(0, 0) = kDeterminantThreshold / 2;
+  mathfu::Matrix<T, 4> inverse_matrix;
+  EXPECT_FALSE(matrix.InverseWithDeterminantCheck(&inverse_matrix));
+  EXPECT_FALSE(matrix.InverseWithDeterminantCheck(&inverse_matrix,
+                                                  kDeterminantThreshold / 100));
+}
+TEST_F(MatrixTests, InverseSmallPivot_float) {
+  InverseSmallPivot_Test<float>();
+}
+TEST_F(MatrixTests, InverseSmallPivot_double) {
+  InverseSmallPivot_Test<double>();
+}
+
 // This will test calculating the inverse of a matrix. The template parameter d
 // corresponds to the number of rows and columns.
 template <class T, int d>
@@ -856,6 +884,582 @@ void UnProject_Test(const T& precision) {
 }
 TEST_SCALAR_F(UnProject, kUnProjectFloatPrecision, DOUBLE_PRECISION)
 
+// Test cached and batched UnProject / Project calculations.
+template <class T>
+void Projector_Test(const T& precision) {
+  typedef mathfu::Vector<T, 3> Vector3;
+  // clang-format off
+  mathfu::Matrix<T, 4, 4> modelView =
+      mathfu::Matrix<T, 4, 4>(-1, 0,                   0, 0,
+                               0, 1,                   0, 0,
+                               0, 0,                  -1, 0,
+                               0, 0, static_cast<T>(-10), 1);
+  mathfu::Matrix<T, 4, 4> projection =
+      mathfu::Matrix<T, 4, 4>(
+          static_cast<T>(1.81066),  0,                            0,   0,
+                        0, static_cast<T>(2.41421342),            0,   0,
+                        0,          0,   static_cast<T>(-1.00001991), -1,
+                        0,          0,  static_cast<T>(-0.200001985),  0);
+  // clang-format on
+  const mathfu::Projector<T> projector(modelView, projection, 1600, 1200);
+  mathfu::Vector<T, 3> window_coords[] = {
+      mathfu::Vector<T, 3>(754, 1049, 1),
+      mathfu::Vector<T, 3>(800, 600, 0),
+      mathfu::Vector<T, 3>(12, 34, static_cast<T>(0.5)),
+      mathfu::Vector<T, 3>(10, 10, 2),
+      mathfu::Vector<T, 3>(1599, 3, static_cast<T>(0.25)),
+  };
+  const size_t count = sizeof(window_coords) / sizeof(window_coords[0]);
+  mathfu::Vector<T, 3> positions[count];
+  EXPECT_EQ(count - 1, projector.UnProject(window_coords, count, positions));
+  EXPECT_NEAR(positions[0].x, 319.00242400912055, 300.0 * precision);
+  EXPECT_NEAR(positions[0].y, 3113.7409399625253, 3000.0 * precision);
+  EXPECT_NEAR(positions[0].z, 10035.303114023569, 10000.0 * precision);
+  // Depth outside of [0, 1] can't be mapped.
+  EXPECT_EQ(Vector3(static_cast<T>(0)), positions[3]);
+  for (size_t i = 0; i < count; ++i) {
+    if (i == 3) continue;
+    // The batch must match the uncached implementation.
+    const mathfu::Vector<T, 3> expected = mathfu::Matrix<T, 4, 4>::UnProject(
+        window_coords[i], modelView, projection, 1600, 1200);
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_NEAR(expected[j], positions[i][j],
+                  std::fabs(expected[j]) * precision + precision);
+    }
+  }
+
+  // Projecting the object space positions must give back the window
+  // coordinates.
+  mathfu::Vector<T, 3> projected[count];
+  EXPECT_EQ(count, projector.Project(positions, count, projected));
+  for (size_t i = 0; i < count; ++i) {
+    if (i == 3) continue;
+    EXPECT_NEAR(window_coords[i].x, projected[i].x, 1000 * precision);
+    EXPECT_NEAR(window_coords[i].y, projected[i].y, 1000 * precision);
+    EXPECT_NEAR(window_coords[i].z, projected[i].z, 10 * precision);
+  }
+
+  // Results may be written in place.
+  EXPECT_EQ(count, projector.Project(positions, count, positions));
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_EQ(projected[i], positions[i]);
+  }
+}
+TEST_SCALAR_F(Projector, kUnProjectFloatPrecision, kUnProjectDoublePrecision)
+
+// Test the cached matrices of Transform.
+template <class T>
+void Transform_Test(const T& precision) {
+  typedef mathfu::Vector<T, 3> Vec3;
+  typedef mathfu::Matrix<T, 4> Mat4;
+  typedef mathfu::Quaternion<T> Quat;
+  mathfu::Transform<T> transform;
+  const uint32_t initial_version = transform.version();
+  for (int i = 0; i < 16; ++i) {
+    EXPECT_EQ(Mat4::Identity()[i], transform.matrix()[i]);
+    EXPECT_EQ(Mat4::Identity()[i], transform.inverse_matrix()[i]);
+  }
+
+  const Vec3 position(1, -2, 3);
+  const Quat rotation = Quat::FromAngleAxis(static_cast<T>(0.7), Vec3(1, 2, 3));
+  const Vec3 scale(2, static_cast<T>(0.5), 3);
+  transform.Set(position, rotation, scale);
+  EXPECT_NE(initial_version, transform.version());
+  Mat4 expected = Mat4::Transform(position, rotation.ToMatrix(), scale);
+  const Mat4* const matrix = &transform.matrix();
+  EXPECT_EQ(matrix, &transform.matrix());
+  // The cached matrices can be rounded differently, for example when the
+  // compiler contracts operations into fused multiply-adds, so the
+  // tolerance scales with the magnitude of each element.
+  for (int i = 0; i < 16; ++i) {
+    EXPECT_NEAR(expected[i], (*matrix)[i],
+                std::fabs(expected[i]) * precision + precision);
+    const T inverse = expected.Inverse()[i];
+    EXPECT_NEAR(inverse, transform.inverse_matrix()[i],
+                std::fabs(inverse) * precision + precision);
+  }
+  const Mat4 identity = transform.matrix() * transform.inverse_matrix();
+  for (int i = 0; i < 16; ++i) {
+    EXPECT_NEAR(Mat4::Identity()[i], identity[i], precision);
+  }
+
+  // Each change updates the version and the matrices.
+  const uint32_t version = transform.version();
+  transform.set_position(Vec3(4, 5, 6));
+  EXPECT_EQ(version + 1, transform.version());
+  EXPECT_EQ(4, transform.matrix()(0, 3));
+  EXPECT_NEAR(0, (transform.inverse_matrix() * Vec3(4, 5, 6))[0],
+              precision);
+  transform.set_rotation(Quat::identity);
+  EXPECT_EQ(version + 2, transform.version());
+  EXPECT_EQ(2, transform.matrix()(0, 0));
+  transform.set_scale(Vec3(static_cast<T>(1)));
+  EXPECT_EQ(version + 3, transform.version());
+  expected = Mat4::FromTranslationVector(Vec3(4, 5, 6));
+  for (int i = 0; i < 16; ++i) {
+    EXPECT_EQ(expected[i], transform.matrix()[i]);
+    const T inverse = expected.Inverse()[i];
+    EXPECT_NEAR(inverse, transform.inverse_matrix()[i],
+                std::fabs(inverse) * precision + precision);
+  }
+}
+TEST_SCALAR_F(Transform, FLOAT_PRECISION, DOUBLE_PRECISION)
+
+// Test decomposing matrices into position, rotation and scale.
+template <class T>
+void Decompose_Test(const T& precision) {
+  typedef mathfu::Vector<T, 3> Vec3;
+  typedef mathfu::Matrix<T, 4> Mat4;
+  typedef mathfu::Quaternion<T> Quat;
+  static const size_t kNumMatrices = 11;
+  // Includes reflections and half turns, which Quaternion::FromMatrix()
+  // handles in separate branches.
+  const Quat rotations[kNumMatrices] = {
+      Quat::identity,
+      Quat::FromAngleAxis(static_cast<T>(0.7), Vec3(1, 2, 3)),
+      Quat::FromAngleAxis(static_cast<T>(M_PI), Vec3(1, 0, 0)),
+      Quat::FromAngleAxis(static_cast<T>(M_PI), Vec3(0, 1, 0)),
+      Quat::FromAngleAxis(static_cast<T>(M_PI), Vec3(0, 0, 1)),
+      Quat::FromAngleAxis(static_cast<T>(M_PI), Vec3(1, 1, 0)),
+      Quat::FromAngleAxis(static_cast<T>(3), Vec3(-1, 2, -1)),
+      Quat::FromAngleAxis(static_cast<T>(-2), Vec3(0, -3, 1)),
+      Quat::FromAngleAxis(static_cast<T>(1), Vec3(2, 1, 5)),
+      Quat::FromAngleAxis(static_cast<T>(2.5), Vec3(-2, -1, 1)),
+      Quat::FromAngleAxis(static_cast<T>(0.1), Vec3(4, -1, 1)),
+  };
+  Mat4 matrices[kNumMatrices];
+  for (size_t i = 0; i < kNumMatrices; ++i) {
+    const T t = static_cast<T>(i);
+    const Vec3 scale(i % 3 ? 1 + t : -1 - t, static_cast<T>(0.5), 2);
+    matrices[i] = Mat4::Transform(Vec3(t, -t, 3), rotations[i].ToMatrix(),
+                                  scale);
+  }
+
+  Vec3 positions[kNumMatrices];
+  Quat decomposed[kNumMatrices];
+  Vec3 scales[kNumMatrices];
+  for (size_t i = 0; i < kNumMatrices; ++i) {
+    EXPECT_TRUE(mathfu::Decompose(matrices[i], &positions[i], &decomposed[i],
+                                  &scales[i]));
+    EXPECT_LE(0, decomposed[i][0]);
+    EXPECT_NEAR(1, decomposed[i].Normalize(), precision);
+    EXPECT_NEAR(static_cast<T>(i % 3 ? 1 + i : -1.0 - i), scales[i][0],
+                precision * 10);
+    const Mat4 matrix = Mat4::Transform(positions[i], decomposed[i].ToMatrix(),
+                                        scales[i]);
+    for (int j = 0; j < 16; ++j) {
+      EXPECT_NEAR(matrices[i][j], matrix[j], precision * 10);
+    }
+  }
+
+  // The batch version produces the same results.
+  Vec3 batch_positions[kNumMatrices];
+  Quat batch_rotations[kNumMatrices];
+  Vec3 batch_scales[kNumMatrices];
+  bool valid[kNumMatrices];
+  matrices[5](1, 1) += static_cast<T>(0.5);
+  matrices[9](3, 2) = static_cast<T>(0.5);
+  EXPECT_EQ(kNumMatrices - 2,
+            mathfu::Decompose(matrices, kNumMatrices, batch_positions,
+                              batch_rotations, batch_scales, valid));
+  for (size_t i = 0; i < kNumMatrices; ++i) {
+    Vec3 position, scale;
+    Quat rotation;
+    EXPECT_EQ(i != 5 && i != 9, valid[i]);
+    EXPECT_EQ(valid[i], mathfu::Decompose(matrices[i], &position, &rotation,
+                                          &scale));
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_NEAR(position[j], batch_positions[i][j], precision);
+      EXPECT_NEAR(scale[j], batch_scales[i][j], precision);
+    }
+    for (int j = 0; j < 4; ++j) {
+      EXPECT_NEAR(rotation[j], batch_rotations[i][j], precision);
+    }
+  }
+
+  // Matrices with a zero scale can't be decomposed.
+  Vec3 position, scale;
+  Quat rotation;
+  EXPECT_FALSE(mathfu::Decompose(Mat4::FromScaleVector(Vec3(1, 0, 1)),
+                                 &position, &rotation, &scale));
+  EXPECT_EQ(0, scale[1]);
+}
+TEST_SCALAR_F(Decompose, FLOAT_PRECISION, DOUBLE_PRECISION)
+
+// Test correcting the drift of rotation matrices.
+template <class T>
+void Orthonormalize_Test(const T& precision) {
+  typedef mathfu::Vector<T, 3> Vec3;
+  typedef mathfu::Matrix<T, 3> Mat3;
+  typedef mathfu::Matrix<T, 4> Mat4;
+  const Mat3 rotation =
+      mathfu::Quaternion<T>::FromAngleAxis(static_cast<T>(0.7), Vec3(1, 2, 3))
+          .ToMatrix();
+  Mat3 drifted = rotation;
+  drifted(1, 0) += static_cast<T>(0.01);
+  drifted(2, 1) -= static_cast<T>(0.02);
+  drifted(0, 2) *= static_cast<T>(1.03);
+  const Mat3 corrected = Mat3::Orthonormalize(drifted);
+  const Mat3 identity = corrected.Transpose() * corrected;
+  for (int i = 0; i < 9; ++i) {
+    EXPECT_NEAR(Mat3::Identity()[i], identity[i], precision);
+    EXPECT_NEAR(rotation[i], corrected[i], static_cast<T>(0.05));
+  }
+  const Vec3 x = Vec3(drifted(0, 0), drifted(1, 0), drifted(2, 0));
+  EXPECT_NEAR(x.Length(), Vec3::DotProduct(x, corrected.GetColumn(0)),
+              precision);
+  EXPECT_NEAR(1, Vec3::DotProduct(
+                     Vec3::CrossProduct(corrected.GetColumn(0),
+                                        corrected.GetColumn(1)),
+                     corrected.GetColumn(2)),
+              precision);
+
+  // The translation of 4x4 matrices is preserved.
+  const Mat4 transform = Mat4::FromTranslationVector(Vec3(1, 2, 3)) *
+                         Mat4::FromRotationMatrix(drifted);
+  const Mat4 corrected_transform = Mat4::Orthonormalize(transform);
+  const Mat4 expected = Mat4::FromTranslationVector(Vec3(1, 2, 3)) *
+                        Mat4::FromRotationMatrix(corrected);
+  for (int i = 0; i < 16; ++i) {
+    EXPECT_NEAR(expected[i], corrected_transform[i], precision);
+  }
+}
+TEST_SCALAR_F(Orthonormalize, FLOAT_PRECISION, DOUBLE_PRECISION)
+
+// Test LU and Cholesky factorization of a d x d matrix.
+template <class T, int d>
+void LinearSolveSize_Test(const T& precision) {
+  typedef mathfu::Vector<T, d> Vec;
+  typedef mathfu::Matrix<T, d> Mat;
+  // Pseudo random matrix which requires pivoting.
+  Mat matrix;
+  Vec b;
+  for (int i = 0; i < d * d; ++i) {
+    matrix[i] = static_cast<T>((i * 37 + 11) % 23) / 23 - static_cast<T>(0.5);
+  }
+  for (int i = 0; i < d; ++i) {
+    matrix(i, i) = static_cast<T>(0.01);
+    b[i] = static_cast<T>(i) - static_cast<T>(d) / 2;
+  }
+
+  Vec x(static_cast<T>(0));
+  EXPECT_TRUE(matrix.Solve(b, &x));
+  const Vec residual = matrix * x - b;
+  for (int i = 0; i < d; ++i) EXPECT_NEAR(0, residual[i], precision);
+
+  Mat inverse;
+  EXPECT_TRUE(matrix.InverseWithDeterminantCheck(&inverse));
+  const Mat identity = matrix * inverse;
+  for (int i = 0; i < d * d; ++i) {
+    EXPECT_NEAR(Mat::Identity()[i], identity[i], precision);
+  }
+
+  // The matrix is not positive definite, but its product with its transpose
+  // is.
+  Mat l;
+  EXPECT_FALSE(matrix.FactorizeCholesky(&l));
+  const Mat spd = matrix.Transpose() * matrix + Mat::Identity();
+  EXPECT_TRUE(spd.FactorizeCholesky(&l));
+  const Mat product = l * l.Transpose();
+  for (int i = 0; i < d; ++i) {
+    for (int j = 0; j < d; ++j) {
+      if (j > i) {
+        EXPECT_EQ(0, l(i, j));
+      }
+      EXPECT_NEAR(spd(i, j), product(i, j), precision);
+    }
+  }
+  const Vec cholesky_residual = spd * Mat::SolveCholesky(l, b) - b;
+  for (int i = 0; i < d; ++i) EXPECT_NEAR(0, cholesky_residual[i], precision);
+
+  // Singular matrices can't be factorized.
+  Mat singular = matrix;
+  singular.GetColumn(d - 1) = singular.GetColumn(0) * static_cast<T>(2);
+  mathfu::Vector<int, d> pivots;
+  EXPECT_FALSE(singular.FactorizeLU(&l, &pivots));
+  EXPECT_FALSE(singular.Solve(b, &x));
+}
+
+template <class T>
+void LinearSolve_Test(const T& precision) {
+  LinearSolveSize_Test<T, 4>(precision * 10);
+  LinearSolveSize_Test<T, 6>(precision * 100);
+  LinearSolveSize_Test<T, 12>(precision * 1000);
+}
+TEST_SCALAR_F(LinearSolve, FLOAT_PRECISION, DOUBLE_PRECISION)
+
+// Generate pseudo random 3x3 matrices which include reflections and rank
+// deficient matrices.
+template <class T>
+static void SvdTestMatrices(mathfu::Matrix<T, 3>* matrices, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    for (int j = 0; j < 9; ++j) {
+      matrices[i][j] = static_cast<T>((i * 97 + j * 31 + 7) % 41) / 20 - 1;
+    }
+  }
+  matrices[1] = mathfu::Matrix<T, 3>::Identity();
+  matrices[2] = mathfu::Matrix<T, 3>(static_cast<T>(0));
+  // Rank 1 and rank 2.
+  matrices[3] = mathfu::Matrix<T, 3>::OuterProduct(
+      mathfu::Vector<T, 3>(1, 2, 3), mathfu::Vector<T, 3>(-1, 0, 2));
+  matrices[4].GetColumn(2) = matrices[4].GetColumn(0) + matrices[4].GetColumn(1);
+  // Repeated eigenvalues.
+  matrices[5] = mathfu::Matrix<T, 3>::FromScaleVector(
+      mathfu::Vector<T, 2>(static_cast<T>(2), static_cast<T>(2)));
+}
+
+template <class T>
+static void ExpectRotation(const mathfu::Matrix<T, 3>& m, const T& precision) {
+  typedef mathfu::Matrix<T, 3> Mat3;
+  typedef mathfu::Vector<T, 3> Vec3;
+  const Mat3 identity = m.Transpose() * m;
+  for (int i = 0; i < 9; ++i) {
+    EXPECT_NEAR(Mat3::Identity()[i], identity[i], precision);
+  }
+  const Vec3 cross = Vec3::CrossProduct(m.GetColumn(0), m.GetColumn(1));
+  EXPECT_NEAR(1, Vec3::DotProduct(cross, m.GetColumn(2)), precision);
+}
+
+// Test eigen decomposition of symmetric 3x3 matrices.
+template <class T>
+void EigenDecompose_Test(const T& precision) {
+  typedef mathfu::Matrix<T, 3> Mat3;
+  static const size_t kNumMatrices = 19;
+  Mat3 matrices[kNumMatrices];
+  SvdTestMatrices(matrices, kNumMatrices);
+  for (size_t i = 0; i < kNumMatrices; ++i) {
+    matrices[i] = matrices[i] * matrices[i].Transpose() - Mat3::Identity();
+  }
+  mathfu::Vector<T, 3> values[kNumMatrices];
+  Mat3 vectors[kNumMatrices];
+  mathfu::EigenDecompose(matrices, kNumMatrices, values, vectors);
+  for (size_t i = 0; i < kNumMatrices; ++i) {
+    mathfu::Vector<T, 3> value;
+    Mat3 vector;
+    mathfu::EigenDecompose(matrices[i], &value, &vector);
+    for (int j = 0; j < 3; ++j) EXPECT_NEAR(value[j], values[i][j], precision);
+    // Eigenvectors are only unique for distinct eigenvalues, the rotation
+    // and reconstruction checks below cover repeated eigenvalues.
+    for (int j = 0; j < 3; ++j) {
+      const T gap = std::min(std::fabs(values[i][j] - values[i][(j + 1) % 3]),
+                             std::fabs(values[i][j] - values[i][(j + 2) % 3]));
+      if (gap < static_cast<T>(1e-3)) continue;
+      for (int k = 0; k < 3; ++k) {
+        EXPECT_NEAR(vector(k, j), vectors[i](k, j), precision);
+      }
+    }
+    EXPECT_GE(values[i][0], values[i][1]);
+    EXPECT_GE(values[i][1], values[i][2]);
+    ExpectRotation(vectors[i], precision);
+    const Mat3 product = vectors[i] *
+                         Mat3::FromScaleVector(mathfu::Vector<T, 2>(
+                             values[i][0], values[i][1])) *
+                         vectors[i].Transpose();
+    // FromScaleVector() sets the last diagonal element to 1.
+    const Mat3 reconstructed =
+        product + Mat3::OuterProduct(vectors[i].GetColumn(2),
+                                     vectors[i].GetColumn(2)) *
+                      (values[i][2] - 1);
+    for (int j = 0; j < 9; ++j) {
+      EXPECT_NEAR(matrices[i][j], reconstructed[j], precision);
+    }
+  }
+}
+TEST_SCALAR_F(EigenDecompose, FLOAT_PRECISION * 20, DOUBLE_PRECISION * 50)
+
+// Test singular value decomposition of 3x3 matrices.
+template <class T>
+void SingularValueDecompose_Test(const T& precision) {
+  typedef mathfu::Matrix<T, 3> Mat3;
+  typedef mathfu::Vector<T, 3> Vec3;
+  static const size_t kNumMatrices = 19;
+  Mat3 matrices[kNumMatrices];
+  SvdTestMatrices(matrices, kNumMatrices);
+  Mat3 u[kNumMatrices], v[kNumMatrices];
+  Vec3 sigma[kNumMatrices];
+  mathfu::SingularValueDecompose(matrices, kNumMatrices, u, sigma, v);
+  for (size_t i = 0; i < kNumMatrices; ++i) {
+    Mat3 single_u, single_v;
+    Vec3 single_sigma;
+    mathfu::SingularValueDecompose(matrices[i], &single_u, &single_sigma,
+                                   &single_v);
+    for (int j = 0; j < 9; ++j) {
+      EXPECT_NEAR(single_u[j], u[i][j], precision);
+      EXPECT_NEAR(single_v[j], v[i][j], precision);
+    }
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_NEAR(single_sigma[j], sigma[i][j], precision);
+    }
+    ExpectRotation(u[i], precision);
+    ExpectRotation(v[i], precision);
+    EXPECT_LE(0, sigma[i][1]);
+    EXPECT_GE(sigma[i][0], sigma[i][1]);
+    EXPECT_GE(sigma[i][1], fabs(sigma[i][2]) - precision);
+    Mat3 scaled = u[i];
+    for (int j = 0; j < 3; ++j) scaled.GetColumn(j) *= sigma[i][j];
+    const Mat3 reconstructed = scaled * v[i].Transpose();
+    for (int j = 0; j < 9; ++j) {
+      EXPECT_NEAR(matrices[i][j], reconstructed[j], precision);
+    }
+  }
+  // Reflections have a negative singular value.
+  Mat3 single_u, single_v;
+  Vec3 single_sigma;
+  mathfu::SingularValueDecompose(
+      Mat3::FromScaleVector(mathfu::Vector<T, 2>(-2, 3)), &single_u,
+      &single_sigma, &single_v);
+  EXPECT_NEAR(3, single_sigma[0], precision);
+  EXPECT_NEAR(2, single_sigma[1], precision);
+  EXPECT_NEAR(-1, single_sigma[2], precision);
+}
+TEST_SCALAR_F(SingularValueDecompose, FLOAT_PRECISION * 20,
+              DOUBLE_PRECISION * 50)
+
+// Test accumulating the covariance of points.
+template <class T>
+void CovarianceAccumulator_Test(const T& precision) {
+  typedef mathfu::Vector<T, 3> Vec3;
+  typedef mathfu::Matrix<T, 3> Mat3;
+  static const size_t kNumPoints = 2500;
+  std::vector<Vec3> points(kNumPoints);
+  for (size_t i = 0; i < kNumPoints; ++i) {
+    const T t = static_cast<T>(i) / kNumPoints;
+    points[i] = Vec3(100 + 3 * t, -50 + t * t, static_cast<T>(sin(7 * t)));
+  }
+  // Calculate the expected results in double precision with two passes.
+  mathfu::Vector<double, 3> mean(0.0);
+  for (size_t i = 0; i < kNumPoints; ++i) {
+    mean += mathfu::Vector<double, 3>(points[i][0], points[i][1],
+                                      points[i][2]);
+  }
+  mean /= static_cast<double>(kNumPoints);
+  mathfu::Matrix<double, 3> expected(0.0);
+  for (size_t i = 0; i < kNumPoints; ++i) {
+    const mathfu::Vector<double, 3> delta =
+        mathfu::Vector<double, 3>(points[i][0], points[i][1], points[i][2]) -
+        mean;
+    expected += mathfu::Matrix<double, 3>::OuterProduct(delta, delta);
+  }
+  expected /= static_cast<double>(kNumPoints);
+
+  // Adding the points individually, as an array and merging two halves
+  // produce the same results.
+  mathfu::CovarianceAccumulator<T> single, batch, first, second;
+  for (size_t i = 0; i < kNumPoints; ++i) single.Add(points[i]);
+  batch.Add(&points[0], kNumPoints);
+  first.Add(&points[0], 1000);
+  second.Add(&points[1000], kNumPoints - 1000);
+  first.Merge(second);
+  const mathfu::CovarianceAccumulator<T>* accumulators[] = {&single, &batch,
+                                                           &first};
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(kNumPoints, accumulators[i]->count());
+    const Mat3 covariance = accumulators[i]->covariance();
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_NEAR(mean[j], accumulators[i]->mean()[j], precision * 100);
+    }
+    for (int j = 0; j < 9; ++j) {
+      EXPECT_NEAR(expected[j], covariance[j], precision);
+    }
+  }
+  const mathfu::CovarianceAccumulator<T> empty;
+  EXPECT_EQ(0, empty.covariance()[0]);
+}
+TEST_SCALAR_F(CovarianceAccumulator, FLOAT_PRECISION * 100,
+              DOUBLE_PRECISION * 100)
+
+// Test fitting oriented boxes to points and intersection tests.
+template <class T>
+void OrientedBox_Test(const T& precision) {
+  typedef mathfu::Vector<T, 3> Vec3;
+  typedef mathfu::Matrix<T, 3> Mat3;
+  typedef mathfu::OrientedBox<T> Box;
+  // Points on the surface of a rotated 8x4x2 box.
+  const Mat3 rotation =
+      mathfu::Quaternion<T>::FromAngleAxis(static_cast<T>(0.6), Vec3(1, 2, 3))
+          .ToMatrix();
+  const Vec3 center(5, -2, 1);
+  const Vec3 extents(4, 2, 1);
+  std::vector<Vec3> points;
+  for (int i = 0; i <= 8; ++i) {
+    for (int j = 0; j <= 8; ++j) {
+      for (int k = 0; k <= 8; ++k) {
+        if (i % 8 && j % 8 && k % 8) continue;
+        const Vec3 local(static_cast<T>(i) / 4 - 1, static_cast<T>(j) / 4 - 1,
+                         static_cast<T>(k) / 4 - 1);
+        points.push_back(center +
+                         rotation * Vec3::HadamardProduct(local, extents));
+      }
+    }
+  }
+  const Box box = Box::FromPoints(&points[0], points.size());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_NEAR(center[i], box.center[i], precision);
+    EXPECT_NEAR(extents[i], box.extents[i], precision);
+    EXPECT_NEAR(1, fabs(Vec3::DotProduct(rotation.GetColumn(i),
+                                         box.axes.GetColumn(i))),
+                precision);
+  }
+
+  // Compare box intersection with a direct test of each separating axis.
+  unsigned int seed = 1;
+  int num_intersecting = 0;
+  for (int test = 0; test < 500; ++test) {
+    Box boxes[2];
+    for (int i = 0; i < 2; ++i) {
+      seed = seed * 1103515245 + 12345;
+      const T angle = static_cast<T>(seed % 1000) / 100;
+      const Vec3 axis(static_cast<T>(seed % 7) - 3,
+                      static_cast<T>(seed % 11) - 5,
+                      static_cast<T>(seed % 13) + 1);
+      boxes[i].axes =
+          mathfu::Quaternion<T>::FromAngleAxis(angle, axis).ToMatrix();
+      boxes[i].center = Vec3(static_cast<T>(seed % 17) / 4,
+                             static_cast<T>(seed % 19) / 5,
+                             static_cast<T>(seed % 23) / 6);
+      boxes[i].extents = Vec3(static_cast<T>(seed % 5) / 4 + 1,
+                              static_cast<T>(seed % 3) / 4 + static_cast<T>(0.1),
+                              static_cast<T>(seed % 29) / 8 + 1);
+    }
+    bool separated = false;
+    for (int i = 0; i < 15; ++i) {
+      Vec3 axis = i < 3 ? boxes[0].axes.GetColumn(i)
+                        : i < 6 ? boxes[1].axes.GetColumn(i - 3)
+                                : Vec3::CrossProduct(
+                                      boxes[0].axes.GetColumn((i - 6) / 3),
+                                      boxes[1].axes.GetColumn((i - 6) % 3));
+      T radius = 0;
+      for (int j = 0; j < 2; ++j) {
+        for (int k = 0; k < 3; ++k) {
+          radius += boxes[j].extents[k] *
+                    fabs(Vec3::DotProduct(boxes[j].axes.GetColumn(k), axis));
+        }
+      }
+      separated |= fabs(Vec3::DotProduct(boxes[1].center - boxes[0].center,
+                                         axis)) > radius;
+    }
+    EXPECT_EQ(!separated, boxes[0].Intersects(boxes[1]));
+    EXPECT_EQ(!separated, boxes[1].Intersects(boxes[0]));
+    num_intersecting += !separated;
+  }
+  // Both outcomes are exercised.
+  EXPECT_LT(50, num_intersecting);
+  EXPECT_GT(450, num_intersecting);
+
+  // Frustum looking down the negative z axis.
+  const mathfu::Frustum<T> frustum = mathfu::Frustum<T>::FromMatrix(
+      mathfu::Matrix<T, 4>::Perspective(static_cast<T>(1), 1, 1, 100));
+  const Box visible(Vec3(0, 0, -10), rotation, Vec3(1, 1, 1));
+  EXPECT_TRUE(visible.Intersects(frustum));
+  const Box behind(Vec3(0, 0, 10), rotation, Vec3(1, 1, 1));
+  EXPECT_FALSE(behind.Intersects(frustum));
+  const Box left(Vec3(-20, 0, -10), rotation, Vec3(1, 1, 1));
+  EXPECT_FALSE(left.Intersects(frustum));
+  const Box straddling(Vec3(-5.5, 0, -10), rotation, Vec3(1, 1, 1));
+  EXPECT_TRUE(straddling.Intersects(frustum));
+}
+TEST_SCALAR_F(OrientedBox, FLOAT_PRECISION * 10, DOUBLE_PRECISION * 100)
+
 // Test matrix transposition.
 template <class T, int d>
 void Transpose_Test(const T& precision) {
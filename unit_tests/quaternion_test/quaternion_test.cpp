@@ -14,10 +14,18 @@
 * limitations under the License.
 */
 #include "mathfu/quaternion.h"
+#include "mathfu/animation.h"
 #include "mathfu/constants.h"
 #include "mathfu/io.h"
+#include "mathfu/quaternion_packed.h"
+#include "mathfu/spline.h"
 
 #include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -430,6 +438,31 @@ void Normalize_Test(const T& precision) {
 }
 TEST_ALL_F(Normalize)
 
+// Test normalization of arrays of quaternions.
+template <class T>
+void NormalizeQuaternions_Test(const T& precision) {
+  typedef mathfu::Quaternion<T> Quat;
+  static const size_t kNumQuaternions = 11;
+  Quat quaternions[kNumQuaternions];
+  Quat expected[kNumQuaternions];
+  const Quat rotation = Quat::FromAngleAxis(static_cast<T>(0.3),
+                                            mathfu::Vector<T, 3>(1, 2, 3));
+  Quat q = Quat::identity;
+  for (size_t i = 0; i < kNumQuaternions; ++i) {
+    // Scale each quaternion to simulate drift.
+    q = q * rotation;
+    const T scale = static_cast<T>(0.9) + static_cast<T>(i) / 50;
+    quaternions[i] = Quat(q[0] * scale, q[1] * scale, q[2] * scale,
+                          q[3] * scale);
+    expected[i] = q.Normalized();
+  }
+  mathfu::NormalizeQuaternions(quaternions, kNumQuaternions);
+  for (size_t i = 0; i < kNumQuaternions; ++i) {
+    EXPECT_NEAR_QUAT(expected[i], quaternions[i], precision);
+  }
+}
+TEST_ALL_F(NormalizeQuaternions)
+
 // This tests that ToAngleAxis returns angle <= 180 degrees, even if the
 // Quaternion had a larger angle.
 template <class T>
@@ -713,6 +746,388 @@ void Slerp_Test(const T& precision) {
 }
 TEST_ALL_F(Slerp)
 
+// Compares the approximations SlerpFast(), SlerpFastNoFlip() and Nlerp()
+// against Slerp() over the full range of angles, using the error bounds from
+// their documentation.
+template <class T>
+void SlerpApproximation_Test(const T& precision) {
+  using Quaternion = mathfu::Quaternion<T>;
+  using Vector3 = mathfu::Vector<T, 3>;
+  const T kSlerpFastMaxError = static_cast<T>(7.5e-6) + 4 * precision;
+  const T kNlerpMaxError = static_cast<T>(3.4e-4) + 4 * precision;
+  const Vector3 axes[] = {Vector3(0, 1, 0), Vector3(1, 2, 3).Normalized(),
+                          Vector3(-3, 0, 1).Normalized()};
+  T slerp_fast_max_error = 0;
+  T nlerp_max_error = 0;
+  for (const Vector3& axis : axes) {
+    const Quaternion q1 = Quaternion::FromAngleAxis(static_cast<T>(0.3), axis);
+    for (int degrees = -359; degrees <= 359; degrees += 7) {
+      const Quaternion q2 =
+          q1 * Quaternion::FromAngleAxis(
+                   degrees * static_cast<T>(mathfu::kDegreesToRadians),
+                   axis);
+      for (int step = 0; step <= 20; ++step) {
+        const T t = static_cast<T>(step) / 20;
+        const Quaternion expected = Quaternion::Slerp(q1, q2, t);
+        const Quaternion fast = Quaternion::SlerpFast(q1, q2, t);
+        const Quaternion nlerp = Quaternion::Nlerp(q1, q2, t);
+        // SlerpFastNoFlip() takes the long path for more than half a turn,
+        // which is ill-conditioned close to a full turn.
+        if (std::abs(degrees) <= 340) {
+          const double angle = std::acos(static_cast<double>(
+              mathfu::Clamp<T>(Quaternion::DotProduct(q1, q2), -1, 1)));
+          const T w1 = static_cast<T>(std::sin((1 - t) * angle) /
+                                      std::sin(angle));
+          const T w2 = static_cast<T>(std::sin(t * angle) / std::sin(angle));
+          const Quaternion no_flip = Quaternion::SlerpFastNoFlip(q1, q2, t);
+          for (int i = 0; i < 4; ++i) {
+            slerp_fast_max_error =
+                std::max(slerp_fast_max_error,
+                         std::fabs(no_flip[i] - (q1[i] * w1 + q2[i] * w2)));
+          }
+        }
+        // Compare orientations since Slerp() may return either
+        // representation.
+        const T fast_sign =
+            Quaternion::DotProduct(expected, fast) < 0 ? -1 : 1;
+        const T nlerp_sign =
+            Quaternion::DotProduct(expected, nlerp) < 0 ? -1 : 1;
+        for (int i = 0; i < 4; ++i) {
+          slerp_fast_max_error =
+              std::max(slerp_fast_max_error,
+                       std::fabs(fast[i] * fast_sign - expected[i]));
+          nlerp_max_error =
+              std::max(nlerp_max_error,
+                       std::fabs(nlerp[i] * nlerp_sign - expected[i]));
+        }
+      }
+    }
+  }
+  EXPECT_LE(slerp_fast_max_error, kSlerpFastMaxError);
+  EXPECT_LE(nlerp_max_error, kNlerpMaxError);
+
+  // The end points are exact for both approximations.
+  const Quaternion q1 = Quaternion::FromAngleAxis(1, axes[1]);
+  const Quaternion q2 = Quaternion::FromAngleAxis(-2, axes[2]);
+  EXPECT_NEAR_QUAT(q1, Quaternion::SlerpFast(q1, q2, 0), precision);
+  EXPECT_NEAR_QUAT(q2, Quaternion::SlerpFast(q1, q2, 1), precision);
+  EXPECT_NEAR_QUAT(q1, Quaternion::Nlerp(q1, q2, 0), precision);
+  EXPECT_NEAR_QUAT(q2, Quaternion::Nlerp(q1, q2, 1), precision);
+}
+TEST_ALL_F(SlerpApproximation)
+
+// Tests keyframe lookup and interpolation of AnimationSampler.
+template <class T>
+void AnimationSampler_Test(const T& precision) {
+  using Quaternion = mathfu::Quaternion<T>;
+  using Vector3 = mathfu::Vector<T, 3>;
+  using Matrix4 = mathfu::Matrix<T, 4, 4>;
+
+  const T times[] = {0, 1, 2, 4};
+  const Vector3 translations[] = {Vector3(0, 0, 0), Vector3(1, 2, 3),
+                                  Vector3(-1, 0, 1), Vector3(5, 5, 5)};
+  const Vector3 axis = Vector3(1, 1, 0).Normalized();
+  const Quaternion rotations[] = {
+      Quaternion::FromAngleAxis(0, axis), Quaternion::FromAngleAxis(1, axis),
+      Quaternion::FromAngleAxis(2, axis), Quaternion::FromAngleAxis(3, axis)};
+  const T scale_times[] = {1, 3};
+  const Vector3 scales[] = {Vector3(1, 1, 1), Vector3(2, 4, 6)};
+
+  mathfu::AnimationTrack<T> tracks[2];
+  tracks[0].translation =
+      mathfu::AnimationChannel<T, Vector3>(times, translations, 4);
+  tracks[0].rotation =
+      mathfu::AnimationChannel<T, Quaternion>(times, rotations, 4);
+  tracks[0].scale = mathfu::AnimationChannel<T, Vector3>(scale_times, scales, 2);
+  // tracks[1] has no keyframes.
+  mathfu::AnimationSampler<T> sampler(tracks, 2);
+  EXPECT_EQ(2, sampler.num_tracks());
+
+  // Play forward, then seek backwards.
+  const T sample_times[] = {-1, 0, static_cast<T>(0.25), static_cast<T>(0.5),
+                            static_cast<T>(1.5), 3, static_cast<T>(3.5), 4,
+                            5, static_cast<T>(0.75), 3};
+  for (T time : sample_times) {
+    Vector3 sampled_translations[2];
+    Quaternion sampled_rotations[2];
+    Vector3 sampled_scales[2];
+    sampler.Sample(time, sampled_translations, sampled_rotations,
+                   sampled_scales);
+
+    const T clamped = mathfu::Clamp<T>(time, 0, 4);
+    const int key = clamped < 1 ? 0 : clamped < 2 ? 1 : clamped < 4 ? 2 : 3;
+    Vector3 expected_translation = translations[3];
+    if (key < 3) {
+      const T t = (clamped - times[key]) / (times[key + 1] - times[key]);
+      expected_translation =
+          Vector3::Lerp(translations[key], translations[key + 1], t);
+    }
+    const Vector3 expected_scale = Vector3::Lerp(
+        scales[0], scales[1], (mathfu::Clamp<T>(time, 1, 3) - 1) / 2);
+    const Quaternion expected_rotation =
+        Quaternion::FromAngleAxis(clamped < 2 ? clamped : 2 + (clamped - 2) / 2,
+                                  axis);
+    EXPECT_NEAR_VEC3(expected_translation, sampled_translations[0],
+                     4 * precision);
+    EXPECT_NEAR_VEC3(expected_scale, sampled_scales[0], 8 * precision);
+    EXPECT_NEAR_QUAT(expected_rotation, sampled_rotations[0], 1e-5);
+    EXPECT_NEAR_VEC3(Vector3(0, 0, 0), sampled_translations[1], 0);
+    EXPECT_NEAR_QUAT(Quaternion::identity, sampled_rotations[1], 0);
+    EXPECT_NEAR_VEC3(Vector3(1, 1, 1), sampled_scales[1], 0);
+
+    Matrix4 transforms[2];
+    sampler.Sample(time, transforms);
+    for (int i = 0; i < 2; ++i) {
+      const Matrix4 expected = Matrix4::Transform(
+          sampled_translations[i], sampled_rotations[i].ToMatrix(),
+          sampled_scales[i]);
+      for (int j = 0; j < 16; ++j) {
+        EXPECT_NEAR(expected[j], transforms[i][j], precision);
+      }
+    }
+  }
+
+  // The cursor is used as a hint, whatever its value.
+  for (int cursor_hint = -1; cursor_hint <= 4; ++cursor_hint) {
+    int cursor = cursor_hint;
+    const T t = mathfu::AnimationSampler<T>::FindKeyframe(
+        times, 4, static_cast<T>(2.5), &cursor);
+    EXPECT_EQ(2, cursor);
+    EXPECT_NEAR(static_cast<T>(0.25), t, precision);
+  }
+}
+TEST_ALL_F(AnimationSampler)
+
+// Checks the end points and tangents of each form of cubic curve and that
+// splines pass through their keys.
+template <class T>
+void CubicSpline_Test(const T& precision) {
+  typedef mathfu::Vector<T, 3> Vector3;
+  typedef mathfu::CubicCurve<T, 3> Curve;
+  const Vector3 p0(0, 0, 0), p1(1, 2, 0), p2(3, 2, 1), p3(4, 0, 2);
+
+  const Curve bezier = Curve::FromBezier(p0, p1, p2, p3);
+  EXPECT_NEAR_VEC3(p0, bezier.Evaluate(0), precision);
+  EXPECT_NEAR_VEC3(p3, bezier.Evaluate(1), precision);
+  EXPECT_NEAR_VEC3((p0 + (p1 + p2) * T(3) + p3) / T(8),
+                   bezier.Evaluate(static_cast<T>(0.5)), precision);
+  EXPECT_NEAR_VEC3((p1 - p0) * T(3), bezier.Derivative(0), precision);
+
+  const Curve hermite = Curve::FromHermite(p0, p1, p2, p3);
+  EXPECT_NEAR_VEC3(p0, hermite.Evaluate(0), precision);
+  EXPECT_NEAR_VEC3(p2, hermite.Evaluate(1), precision);
+  EXPECT_NEAR_VEC3(p1, hermite.Derivative(0), precision);
+  EXPECT_NEAR_VEC3(p3, hermite.Derivative(1), precision);
+
+  const Curve catmull_rom = Curve::FromCatmullRom(p0, p1, p2, p3);
+  EXPECT_NEAR_VEC3(p1, catmull_rom.Evaluate(0), precision);
+  EXPECT_NEAR_VEC3(p2, catmull_rom.Evaluate(1), precision);
+  EXPECT_NEAR_VEC3((p2 - p0) / T(2), catmull_rom.Derivative(0), precision);
+
+  const T t[] = {-1, 0, static_cast<T>(0.25), 1, static_cast<T>(2.5), 3, 7};
+  const size_t count = sizeof(t) / sizeof(t[0]);
+  Vector3 points[count];
+  catmull_rom.Evaluate(t, count, points);
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_NEAR_VEC3(catmull_rom.Evaluate(t[i]), points[i], precision);
+  }
+  const Curve curves[] = {bezier, hermite, catmull_rom};
+  mathfu::EvaluateCurves(curves, 3, static_cast<T>(0.25), points);
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_NEAR_VEC3(curves[i].Evaluate(static_cast<T>(0.25)), points[i],
+                     precision);
+  }
+
+  const Vector3 keys[] = {p0, p1, p2, p3};
+  const mathfu::CubicSpline<T, 3> spline =
+      mathfu::CubicSpline<T, 3>::FromCatmullRom(keys, 4);
+  EXPECT_EQ(3u, spline.num_segments());
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_NEAR_VEC3(keys[i], spline.Evaluate(static_cast<T>(i)), precision);
+  }
+  // Parameters outside the spline are clamped.
+  EXPECT_NEAR_VEC3(p0, spline.Evaluate(-1), precision);
+  EXPECT_NEAR_VEC3(p3, spline.Evaluate(10), precision);
+  // The tangent is continuous between segments.
+  EXPECT_NEAR_VEC3(spline.segment(0).Derivative(1),
+                   spline.segment(1).Derivative(0), precision);
+  spline.Evaluate(t, count, points);
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_NEAR_VEC3(spline.Evaluate(t[i]), points[i], precision);
+  }
+
+  const Vector3 tangents[] = {p1, p1, p1, p1};
+  const mathfu::CubicSpline<T, 3> hermite_spline =
+      mathfu::CubicSpline<T, 3>::FromHermite(keys, tangents, 4);
+  EXPECT_NEAR_VEC3(p2, hermite_spline.Evaluate(2), precision);
+  EXPECT_NEAR_VEC3(p1, hermite_spline.Derivative(static_cast<T>(1.5) - 1),
+                   precision * 10);
+  const mathfu::CubicSpline<T, 3> bezier_spline =
+      mathfu::CubicSpline<T, 3>::FromBezier(keys, 4);
+  EXPECT_EQ(1u, bezier_spline.num_segments());
+  EXPECT_NEAR_VEC3(bezier.Evaluate(static_cast<T>(0.75)),
+                   bezier_spline.Evaluate(static_cast<T>(0.75)), precision);
+
+  // A single point is a constant spline.
+  const mathfu::CubicSpline<T, 3> splines[] = {
+      mathfu::CubicSpline<T, 3>::FromBezier(&p1, 1),
+      mathfu::CubicSpline<T, 3>::FromHermite(&p1, &p2, 1),
+      mathfu::CubicSpline<T, 3>::FromCatmullRom(&p1, 1)};
+  for (size_t i = 0; i < sizeof(splines) / sizeof(splines[0]); ++i) {
+    EXPECT_EQ(1u, splines[i].num_segments());
+    EXPECT_NEAR_VEC3(p1, splines[i].Evaluate(-1), precision);
+    EXPECT_NEAR_VEC3(p1, splines[i].Evaluate(static_cast<T>(0.5)), precision);
+    EXPECT_NEAR_VEC3(Vector3(0, 0, 0), splines[i].Derivative(0), precision);
+  }
+}
+TEST_ALL_F(CubicSpline)
+
+// Checks that squad interpolation passes through its keys and matches slerp
+// for rotations with a constant angular velocity.
+template <class T>
+void QuaternionSpline_Test(const T& precision) {
+  (void)precision;
+  typedef mathfu::Quaternion<T> Quaternion;
+  typedef mathfu::Vector<T, 3> Vector3;
+  // Slerp is approximated by SlerpFast() so use its error bound.
+  const T tolerance = static_cast<T>(1e-4);
+  const Vector3 axis = Vector3(1, 2, 3).Normalized();
+  Quaternion keys[5];
+  for (int i = 0; i < 5; ++i) {
+    keys[i] = Quaternion::FromAngleAxis(static_cast<T>(0.5) * i, axis);
+  }
+  // Negated keys represent the same orientation.
+  keys[3] = Quaternion(-keys[3].scalar(), -keys[3].vector());
+  const mathfu::QuaternionSpline<T> spline(keys, 5);
+  EXPECT_EQ(4u, spline.num_segments());
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_NEAR_ORIENTATION(keys[i], spline.Evaluate(static_cast<T>(i)),
+                            tolerance);
+  }
+  for (int i = 0; i < 20; ++i) {
+    const T t = static_cast<T>(i) * static_cast<T>(0.2);
+    const Quaternion expected = Quaternion::FromAngleAxis(
+        static_cast<T>(0.5) * t, axis);
+    Quaternion result = spline.Evaluate(t);
+    EXPECT_NEAR_ORIENTATION(expected, result, tolerance);
+    EXPECT_NEAR(1, result.Normalize(), tolerance);
+  }
+
+  // Control points of keys with varying angular velocity differ from the
+  // keys, the result must still pass through the keys.
+  Quaternion irregular[4];
+  irregular[0] = Quaternion::identity;
+  irregular[1] = Quaternion::FromAngleAxis(static_cast<T>(0.3), axis);
+  irregular[2] = Quaternion::FromAngleAxis(static_cast<T>(1.5),
+                                           Vector3(0, 1, 0));
+  irregular[3] = Quaternion::FromAngleAxis(static_cast<T>(2), Vector3(1, 0, 0));
+  const mathfu::QuaternionSpline<T> irregular_spline(irregular, 4);
+  T t[9];
+  for (int i = 0; i < 9; ++i) t[i] = static_cast<T>(i) * static_cast<T>(0.375);
+  Quaternion results[9];
+  irregular_spline.Evaluate(t, 9, results);
+  for (int i = 0; i < 9; ++i) {
+    EXPECT_NEAR_QUAT(irregular_spline.Evaluate(t[i]), results[i], 0);
+    EXPECT_NEAR(1, results[i].Normalize(), tolerance);
+  }
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_NEAR_ORIENTATION(irregular[i],
+                            irregular_spline.Evaluate(static_cast<T>(i)),
+                            tolerance);
+  }
+
+  // Squad must not jump between the two representations of an orientation
+  // within a segment, even for rotations of up to 3 radians between keys.
+  Quaternion large[5];
+  large[0] = Quaternion::identity;
+  const T angles[] = {static_cast<T>(2.9), static_cast<T>(-3),
+                      static_cast<T>(2.5), static_cast<T>(3)};
+  const Vector3 turn_axes[] = {axis, Vector3(0, 1, 0), Vector3(1, 0, 0),
+                               Vector3(-3, 1, 2).Normalized()};
+  for (int i = 0; i < 4; ++i) {
+    large[i + 1] =
+        large[i] * Quaternion::FromAngleAxis(angles[i], turn_axes[i]);
+  }
+  const mathfu::QuaternionSpline<T> large_spline(large, 5);
+  const int kSamples = 1000;
+  Quaternion previous = large_spline.Evaluate(0);
+  previous.Normalize();
+  T max_step = 0;
+  for (int i = 1; i <= 4 * kSamples; ++i) {
+    Quaternion current = large_spline.Evaluate(static_cast<T>(i) / kSamples);
+    current.Normalize();
+    // Rotation angle between consecutive samples.
+    const T cos_half_step =
+        std::min(static_cast<T>(1),
+                 std::fabs(Quaternion::DotProduct(previous, current)));
+    max_step = std::max(max_step, 2 * std::acos(cos_half_step));
+    previous = current;
+  }
+  EXPECT_LT(max_step, static_cast<T>(0.02));
+
+  // A single key is a constant spline.
+  const mathfu::QuaternionSpline<T> constant_spline(&irregular[2], 1);
+  EXPECT_EQ(0u, constant_spline.num_segments());
+  EXPECT_NEAR_QUAT(irregular[2], constant_spline.Evaluate(-1), 0);
+  EXPECT_NEAR_QUAT(irregular[2], constant_spline.Evaluate(static_cast<T>(0.5)),
+                   0);
+  constant_spline.Evaluate(t, 9, results);
+  for (int i = 0; i < 9; ++i) EXPECT_NEAR_QUAT(irregular[2], results[i], 0);
+}
+TEST_ALL_F(QuaternionSpline)
+
+// Packs quaternions with each of the compressed formats, checks the
+// documented error bounds and that the batch functions match the scalar
+// conversions.
+template <class Packed>
+void CheckQuaternionPacking(float max_error, bool same_sign) {
+  using Quaternion = mathfu::Quaternion<float>;
+  using Vector3 = mathfu::Vector<float, 3>;
+  std::vector<Quaternion> quaternions;
+  quaternions.push_back(Quaternion(1, 0, 0, 0));
+  quaternions.push_back(Quaternion(0, -1, 0, 0));
+  quaternions.push_back(Quaternion(0, 0, 1, 0));
+  quaternions.push_back(Quaternion(0, 0, 0, -1));
+  quaternions.push_back(Quaternion(0.5f, -0.5f, 0.5f, -0.5f));
+  for (int i = 0; i < 101; ++i) {
+    const Vector3 axis =
+        Vector3(sinf(i * 1.3f), cosf(i * 0.7f), sinf(i * 2.9f + 1))
+            .Normalized();
+    quaternions.push_back(Quaternion::FromAngleAxis(i * 0.37f, axis));
+    quaternions.push_back(Quaternion(-quaternions.back().scalar(),
+                                     -quaternions.back().vector()));
+  }
+  const size_t count = quaternions.size();
+  std::vector<Packed> packed(count);
+  std::vector<Quaternion> unpacked(count);
+  mathfu::PackQuaternions(&quaternions[0], count, &packed[0]);
+  mathfu::UnpackQuaternions(&packed[0], count, &unpacked[0]);
+  for (size_t i = 0; i < count; ++i) {
+    const Packed scalar_packed(quaternions[i]);
+    EXPECT_EQ(0, memcmp(&scalar_packed, &packed[i], sizeof(Packed)));
+    // The batch conversion matches to within rounding since the scalar
+    // conversion can be contracted into fused multiply-adds.  Components
+    // are at most 1 so epsilon is at least one ULP.
+    const Quaternion scalar_unpacked = scalar_packed.Unpack();
+    EXPECT_NEAR_QUAT(scalar_unpacked, unpacked[i],
+                     std::numeric_limits<float>::epsilon());
+    if (same_sign) {
+      EXPECT_NEAR_QUAT(quaternions[i], unpacked[i], max_error);
+    } else {
+      EXPECT_NEAR_ORIENTATION(quaternions[i], unpacked[i], max_error);
+    }
+  }
+}
+
+TEST_F(QuaternionTests, QuaternionPacked) {
+  EXPECT_EQ(4U, sizeof(mathfu::QuaternionPacked32));
+  EXPECT_EQ(6U, sizeof(mathfu::QuaternionPacked48));
+  EXPECT_EQ(8U, sizeof(mathfu::QuaternionPackedSnorm16));
+  CheckQuaternionPacking<mathfu::QuaternionPacked32>(1.5e-3f, false);
+  CheckQuaternionPacking<mathfu::QuaternionPacked48>(5e-5f, false);
+  CheckQuaternionPacking<mathfu::QuaternionPackedSnorm16>(1.6e-5f, true);
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -14,15 +14,26 @@
 * limitations under the License.
 */
 #include "mathfu/vector.h"
+#include "mathfu/array_ops.h"
+#include "mathfu/binary_archive.h"
 #include "mathfu/constants.h"
+#include "mathfu/half.h"
 #include "mathfu/io.h"
+#include "mathfu/random.h"
+#include "mathfu/vertex_formats.h"
 
 #include "gtest/gtest.h"
 
 #include "precision.h"
 
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <limits>
 #include <sstream>
 #include <string>
+#include <vector>
 
 class VectorTests : public ::testing::Test {
  protected:
@@ -416,6 +427,307 @@ void Norm_Test(const T& precision) {
 }
 TEST_ALL_F(Norm)
 
+// Tests the approximate length and normalization functions, which are within
+// 4 ULP of the exact result for float vectors.
+template <class T, int d>
+void NormFast_Test(const T& precision) {
+  (void)precision;
+  typedef mathfu::Vector<T, d> Vec;
+  const T tolerance = 4 * std::numeric_limits<T>::epsilon();
+  for (int count = 0; count < 100; ++count) {
+    T x[d];
+    for (int i = 0; i < d; ++i) {
+      x[i] = (rand() / static_cast<T>(RAND_MAX) - static_cast<T>(0.5)) *
+             static_cast<T>(count + 1);
+    }
+    Vec vector(x);
+    const T length = sqrt(vector.LengthSquared());
+    EXPECT_NEAR(length, vector.LengthFast(), length * tolerance);
+    const Vec normalized = vector.NormalizedFast();
+    EXPECT_NEAR(length, vector.NormalizeFast(), length * tolerance);
+    for (int i = 0; i < d; ++i) {
+      EXPECT_NEAR(x[i] / length, normalized[i], tolerance);
+      EXPECT_EQ(normalized[i], vector[i]);
+    }
+  }
+  EXPECT_EQ(0, Vec(static_cast<T>(0)).LengthFast());
+}
+TEST_ALL_F(NormFast)
+
+// Tests lane-wise comparison of vectors, mask operations and selection of
+// elements using masks.
+template <class T, int d>
+void CompareMask_Test(const T& precision) {
+  (void)precision;
+  typedef mathfu::Vector<T, d> Vec;
+  typedef mathfu::VectorMask<d> Mask;
+  Vec v1, v2;
+  for (int i = 0; i < d; ++i) {
+    v1[i] = static_cast<T>(i);
+    v2[i] = static_cast<T>(d - 1 - i);
+  }
+  const Mask less = v1 < v2;
+  const Mask less_equal = v1 <= v2;
+  const Mask greater = v1 > v2;
+  const Mask greater_equal = v1 >= v2;
+  const Mask equal = mathfu::Equal(v1, v2);
+  const Mask not_equal = mathfu::NotEqual(v1, v2);
+  uint32_t less_bits = 0;
+  for (int i = 0; i < d; ++i) {
+    EXPECT_EQ(v1[i] < v2[i], less[i]);
+    EXPECT_EQ(v1[i] <= v2[i], less_equal[i]);
+    EXPECT_EQ(v1[i] > v2[i], greater[i]);
+    EXPECT_EQ(v1[i] >= v2[i], greater_equal[i]);
+    EXPECT_EQ(v1[i] == v2[i], equal[i]);
+    EXPECT_EQ(v1[i] != v2[i], not_equal[i]);
+    EXPECT_EQ(less[i] ? -1 : 0, less.data_[i]);
+    EXPECT_EQ(greater_equal[i] ? -1 : 0, greater_equal.data_[i]);
+    if (less[i]) less_bits |= 1U << i;
+  }
+  EXPECT_EQ(less_bits, less.MoveMask());
+  EXPECT_TRUE(less.Any());
+  EXPECT_FALSE(less.All());
+  EXPECT_TRUE((less | greater_equal).All());
+  EXPECT_FALSE((less & greater_equal).Any());
+  EXPECT_EQ((~less).MoveMask(), greater_equal.MoveMask());
+  EXPECT_EQ((less | greater | equal).MoveMask(), Mask(true).MoveMask());
+  EXPECT_FALSE(Mask(false).Any());
+  EXPECT_TRUE(mathfu::Equal(v1, v1).All());
+  EXPECT_FALSE(mathfu::NotEqual(v1, v1).Any());
+
+  const Vec selected = mathfu::Select(less, v1, v2);
+  for (int i = 0; i < d; ++i) {
+    EXPECT_EQ(less[i] ? v1[i] : v2[i], selected[i]);
+  }
+  // Clamp without branches.
+  const Vec upper(static_cast<T>(1));
+  const Vec clamped = mathfu::Select(v1 > upper, upper, v1);
+  for (int i = 0; i < d; ++i) {
+    EXPECT_EQ(v1[i] > 1 ? 1 : v1[i], clamped[i]);
+  }
+}
+TEST_ALL_F(CompareMask)
+TEST_ALL_INTS_F(CompareMask)
+
+// Tests the sum, product, minimum and maximum of the elements of a vector.
+template <class T, int d>
+void Reduce_Test(const T& precision) {
+  T x[d];
+  T sum = 0, product = 1;
+  for (int i = 0; i < d; ++i) {
+    x[i] = static_cast<T>((i * 7) % 5) - static_cast<T>(2);
+    if (x[i] == 0) x[i] = static_cast<T>(3);
+    sum += x[i];
+    product *= x[i];
+  }
+  const mathfu::Vector<T, d> vector(x);
+  EXPECT_NEAR(sum, vector.Sum(), precision);
+  EXPECT_NEAR(product, vector.Product(), precision);
+  EXPECT_EQ(*std::min_element(x, x + d), vector.MinComponent());
+  EXPECT_EQ(*std::max_element(x, x + d), vector.MaxComponent());
+}
+TEST_ALL_F(Reduce)
+TEST_ALL_INTS_F(Reduce)
+
+TEST_F(VectorTests, ReduceWide) {
+  mathfu::Vector<float, 16> vector;
+  for (int i = 0; i < 16; ++i) vector[i] = static_cast<float>(i);
+  typedef mathfu::Vector<float, 8> Vector8;
+  EXPECT_EQ(120.0f, vector.Sum());
+  EXPECT_EQ(28.0f, Vector8(&vector[0]).Sum());
+  // Each lane is a different power of two so the sum is only correct if every
+  // lane of each register is added once.
+  for (int i = 0; i < 16; ++i) vector[i] = static_cast<float>(1 << i);
+  EXPECT_EQ(65535.0f, vector.Sum());
+  EXPECT_EQ(255.0f, Vector8(&vector[0]).Sum());
+  EXPECT_EQ(65280.0f, Vector8(&vector[8]).Sum());
+}
+
+// Tests the sum, bounds and centroid of arrays of vectors.
+template <class T, int d>
+void ArrayReduce_Test(const T& precision) {
+  typedef mathfu::Vector<T, d> Vec;
+  // Include counts which leave a remainder after each unrolled loop.
+  const size_t counts[] = {1, 2, 3, 5, 18, 103};
+  for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+    const size_t count = counts[c];
+    std::vector<Vec> vectors(count);
+    Vec sum(static_cast<T>(0));
+    Vec lower(static_cast<T>(1000)), upper(static_cast<T>(-1000));
+    for (size_t j = 0; j < count; ++j) {
+      for (int i = 0; i < d; ++i) {
+        vectors[j][i] = static_cast<T>((j * 13 + i * 7) % 17) -
+                        static_cast<T>(8);
+      }
+      sum += vectors[j];
+      lower = Vec::Min(lower, vectors[j]);
+      upper = Vec::Max(upper, vectors[j]);
+    }
+    const Vec array_sum = mathfu::Sum(&vectors[0], count);
+    const Vec centroid = mathfu::Centroid(&vectors[0], count);
+    Vec array_lower, array_upper;
+    mathfu::Bounds(&vectors[0], count, &array_lower, &array_upper);
+    for (int i = 0; i < d; ++i) {
+      EXPECT_NEAR(sum[i], array_sum[i], precision);
+      EXPECT_NEAR(sum[i] / static_cast<T>(count), centroid[i], precision);
+      EXPECT_EQ(lower[i], array_lower[i]);
+      EXPECT_EQ(upper[i], array_upper[i]);
+    }
+
+    // Reduce the elements of the vectors as an array of scalars.
+    std::vector<T> values(count);
+    for (size_t j = 0; j < count; ++j) values[j] = vectors[j][j % d];
+    T value_sum = 0, value_lower = values[0], value_upper = values[0];
+    for (size_t j = 0; j < count; ++j) {
+      value_sum += values[j];
+      value_lower = std::min(value_lower, values[j]);
+      value_upper = std::max(value_upper, values[j]);
+    }
+    T array_value_lower, array_value_upper;
+    mathfu::Bounds(&values[0], count, &array_value_lower, &array_value_upper);
+    EXPECT_NEAR(value_sum, mathfu::Sum(&values[0], count), precision);
+    EXPECT_EQ(value_lower, array_value_lower);
+    EXPECT_EQ(value_upper, array_value_upper);
+  }
+  EXPECT_EQ(0, mathfu::Sum(static_cast<const T*>(0), 0));
+}
+TEST_ALL_F(ArrayReduce)
+TEST_ALL_INTS_F(ArrayReduce)
+
+// Compare the element-wise array functions with the equivalent calculation
+// on each element.
+template <class T, int d>
+void ArrayKernels_Test(const T& precision) {
+  typedef mathfu::Vector<T, d> Vec;
+  const T zero = static_cast<T>(0), one = static_cast<T>(1);
+  // Include counts which leave a remainder after each SIMD loop.
+  const size_t counts[] = {1, 3, 4, 7, 18, 103};
+  for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+    const size_t count = counts[c];
+    std::vector<T> values(count), others(count), percents(count);
+    for (size_t j = 0; j < count; ++j) {
+      values[j] = static_cast<T>((j * 13) % 17) / static_cast<T>(4) - 2;
+      others[j] = static_cast<T>((j * 7) % 11) - 5;
+      percents[j] = static_cast<T>(j % 9) / static_cast<T>(8);
+    }
+    const T lower = static_cast<T>(-1), upper = static_cast<T>(1.5);
+    const T edge0 = static_cast<T>(-1), edge1 = static_cast<T>(2);
+    std::vector<T> results(count);
+
+    mathfu::Clamp(&values[0], count, lower, upper, &results[0]);
+    for (size_t j = 0; j < count; ++j) {
+      EXPECT_EQ(mathfu::Clamp(values[j], lower, upper), results[j]);
+    }
+    mathfu::Lerp(&values[0], &others[0], count, static_cast<T>(0.25),
+                 &results[0]);
+    for (size_t j = 0; j < count; ++j) {
+      EXPECT_NEAR(mathfu::Lerp(values[j], others[j], static_cast<T>(0.25)),
+                  results[j], precision);
+    }
+    mathfu::Lerp(&values[0], &others[0], &percents[0], count, &results[0]);
+    for (size_t j = 0; j < count; ++j) {
+      EXPECT_NEAR(mathfu::Lerp(values[j], others[j], percents[j]), results[j],
+                  precision);
+    }
+    mathfu::Remap(&values[0], count, edge0, edge1, static_cast<T>(10),
+                  static_cast<T>(4), &results[0]);
+    for (size_t j = 0; j < count; ++j) {
+      EXPECT_NEAR(10 - 2 * (values[j] - edge0), results[j], precision * 10);
+    }
+    mathfu::RemapClamped(&values[0], count, edge0, edge1, static_cast<T>(10),
+                         static_cast<T>(4), &results[0]);
+    for (size_t j = 0; j < count; ++j) {
+      const T expected = mathfu::Clamp(10 - 2 * (values[j] - edge0),
+                                       static_cast<T>(4), static_cast<T>(10));
+      EXPECT_NEAR(expected, results[j], precision * 10);
+    }
+    // Process the array in place.
+    results = values;
+    mathfu::SmoothStep(&results[0], count, edge0, edge1, &results[0]);
+    for (size_t j = 0; j < count; ++j) {
+      const T t = mathfu::Clamp((values[j] - edge0) / (edge1 - edge0), zero,
+                                one);
+      EXPECT_NEAR(t * t * (3 - 2 * t), results[j], precision);
+    }
+
+    // Process arrays of vectors with different ranges for each element.
+    std::vector<Vec> vectors(count), vector_results(count);
+    Vec vector_lower, vector_upper, vector_edge0, vector_edge1;
+    for (int i = 0; i < d; ++i) {
+      vector_lower[i] = lower - static_cast<T>(i);
+      vector_upper[i] = upper + static_cast<T>(i);
+      vector_edge0[i] = edge0 + static_cast<T>(i) / 4;
+      vector_edge1[i] = edge1 - static_cast<T>(i) / 4;
+    }
+    for (size_t j = 0; j < count; ++j) {
+      for (int i = 0; i < d; ++i) vectors[j][i] = values[(j + i) % count];
+    }
+    mathfu::Clamp(&vectors[0], count, vector_lower, vector_upper,
+                  &vector_results[0]);
+    for (size_t j = 0; j < count; ++j) {
+      for (int i = 0; i < d; ++i) {
+        EXPECT_EQ(mathfu::Clamp(vectors[j][i], vector_lower[i],
+                                vector_upper[i]),
+                  vector_results[j][i]);
+      }
+    }
+    std::vector<Vec> shifted(count);
+    for (size_t j = 0; j < count; ++j) {
+      shifted[j] = vectors[j] + static_cast<T>(2);
+    }
+    mathfu::Lerp(&vectors[0], &shifted[0], count, static_cast<T>(0.5),
+                 &vector_results[0]);
+    for (size_t j = 0; j < count; ++j) {
+      for (int i = 0; i < d; ++i) {
+        EXPECT_NEAR(vectors[j][i] + 1, vector_results[j][i], precision);
+      }
+    }
+    mathfu::RemapClamped(&vectors[0], count, vector_edge0, vector_edge1,
+                         Vec(zero), Vec(static_cast<T>(2)),
+                         &vector_results[0]);
+    for (size_t j = 0; j < count; ++j) {
+      for (int i = 0; i < d; ++i) {
+        const T t = mathfu::Clamp((vectors[j][i] - vector_edge0[i]) /
+                                      (vector_edge1[i] - vector_edge0[i]),
+                                  zero, one);
+        EXPECT_NEAR(2 * t, vector_results[j][i], precision * 10);
+      }
+    }
+    mathfu::SmoothStep(&vectors[0], count, vector_edge0, vector_edge1,
+                       &vector_results[0]);
+    for (size_t j = 0; j < count; ++j) {
+      for (int i = 0; i < d; ++i) {
+        const T t = mathfu::Clamp((vectors[j][i] - vector_edge0[i]) /
+                                      (vector_edge1[i] - vector_edge0[i]),
+                                  zero, one);
+        EXPECT_NEAR(t * t * (3 - 2 * t), vector_results[j][i], precision);
+      }
+    }
+  }
+}
+TEST_ALL_F(ArrayKernels)
+
+// Compare the approximate reciprocal functions with the exact result over a
+// range of magnitudes.
+template <class T>
+void ReciprocalFast_Test(const T& precision) {
+  (void)precision;
+  const T tolerance = 3 * std::numeric_limits<T>::epsilon();
+  for (T x = static_cast<T>(1e-30); x < static_cast<T>(1e30);
+       x *= static_cast<T>(1.0137)) {
+    const T reciprocal = static_cast<T>(1.0 / static_cast<double>(x));
+    const T reciprocal_sqrt =
+        static_cast<T>(1.0 / sqrt(static_cast<double>(x)));
+    EXPECT_NEAR(reciprocal, mathfu::ReciprocalFast(x),
+                reciprocal * tolerance);
+    EXPECT_NEAR(-reciprocal, mathfu::ReciprocalFast(-x),
+                reciprocal * tolerance);
+    EXPECT_NEAR(reciprocal_sqrt, mathfu::ReciprocalSqrtFast(x),
+                reciprocal_sqrt * tolerance);
+  }
+}
+TEST_SCALAR_F(ReciprocalFast)
+
 // This will test the multiplication of vectors by vectors and scalars. The
 // template parameter d corresponds to the size of the vector.
 template <class T, int d>
@@ -614,6 +926,95 @@ void RandomInRange_Test(const T& precision) {
 }
 TEST_SCALAR_AND_INT_F(RandomInRange)
 
+// Tests seeding and the range of values produced by RandomGenerator.
+TEST_F(VectorTests, RandomGenerator) {
+  mathfu::RandomGenerator generator1(1234);
+  mathfu::RandomGenerator generator2(1234);
+  mathfu::RandomGenerator generator3(4321);
+  int differences = 0;
+  for (int i = 0; i < 100; ++i) {
+    const uint32_t value = generator1.NextUInt32();
+    EXPECT_EQ(value, generator2.NextUInt32());
+    differences += value != generator3.NextUInt32();
+  }
+  EXPECT_GT(differences, 90);
+
+  generator1.Seed(99);
+  float values[1001];
+  generator1.FillUniform(values, 1001);
+  generator2.Seed(99);
+  float sum = 0;
+  for (int i = 0; i < 1001; ++i) {
+    EXPECT_EQ(values[i], generator2.NextFloat());
+    EXPECT_GE(values[i], 0.0f);
+    EXPECT_LT(values[i], 1.0f);
+    sum += values[i];
+  }
+  EXPECT_NEAR(0.5f, sum / 1001, 0.05f);
+
+  for (int i = 0; i < 100; ++i) {
+    const double value = generator1.NextDouble();
+    EXPECT_GE(value, 0.0);
+    EXPECT_LT(value, 1.0);
+    const float in_range = generator1.NextFloatInRange(-3.0f, 5.0f);
+    EXPECT_GE(in_range, -3.0f);
+    EXPECT_LE(in_range, 5.0f);
+  }
+  EXPECT_EQ(&mathfu::ThreadLocalRandomGenerator(),
+            &mathfu::ThreadLocalRandomGenerator());
+}
+
+// Tests batch generation of random vectors within a range and unit vectors.
+template <int d>
+void RandomGeneratorVectors_Test() {
+  typedef mathfu::Vector<float, d> Vec;
+  mathfu::RandomGenerator generator;
+  Vec min, max;
+  for (int i = 0; i < d; ++i) {
+    min[i] = -i - 10.0f;
+    max[i] = i * 2 + 2.0f;
+  }
+  Vec vectors[100];
+  generator.FillInRange(min, max, vectors, 100);
+  for (int j = 0; j < 100; ++j) {
+    for (int i = 0; i < d; ++i) {
+      EXPECT_GE(vectors[j][i], min[i]);
+      EXPECT_LE(vectors[j][i], max[i]);
+    }
+  }
+
+  generator.FillUnitVectors(vectors, 100);
+  Vec sum(0.0f);
+  for (int j = 0; j < 100; ++j) {
+    EXPECT_NEAR(1.0f, vectors[j].Length(), 1e-5f);
+    sum += vectors[j];
+  }
+  EXPECT_LT((sum / 100.0f).Length(), 0.3f);
+}
+
+TEST_F(VectorTests, RandomGeneratorVectors) {
+  RandomGeneratorVectors_Test<2>();
+  RandomGeneratorVectors_Test<3>();
+  RandomGeneratorVectors_Test<4>();
+}
+
+// Tests batch generation of random rotations.
+TEST_F(VectorTests, RandomGeneratorQuaternions) {
+  mathfu::RandomGenerator generator(7);
+  mathfu::Quaternion<float> quaternions[100];
+  generator.FillQuaternions(quaternions, 100);
+  mathfu::Vector<float, 3> sum(0.0f);
+  for (int i = 0; i < 100; ++i) {
+    const mathfu::Vector<float, 3>& v = quaternions[i].vector();
+    EXPECT_NEAR(1.0f,
+                quaternions[i].scalar() * quaternions[i].scalar() +
+                    v.LengthSquared(),
+                1e-5f);
+    sum += quaternions[i] * mathfu::Vector<float, 3>(0.0f, 0.0f, 1.0f);
+  }
+  EXPECT_LT((sum / 100.0f).Length(), 0.3f);
+}
+
 // This will test initialization by passing in values. The template parameter d
 // corresponds to the size of the vector.
 template <class T, int d>
@@ -880,6 +1281,104 @@ void NotEqual_Test(const T& precision) {
 TEST_ALL_F(NotEqual)
 TEST_ALL_INTS_F(NotEqual)
 
+// Test integer vector operations with negative values, the conversions use
+// SSE2 for 3 and 4-dimensional vectors when enabled.
+template <class T, int d>
+void IntOperations_Test(const T& precision) {
+  (void)precision;
+  mathfu::Vector<int, d> a, b;
+  mathfu::Vector<float, d> f;
+  for (int i = 0; i < d; ++i) {
+    a[i] = (i + 1) * (i % 2 ? -7 : 5);
+    b[i] = 3 - i * 4;
+    f[i] = static_cast<float>(a[i]) + (i % 2 ? -0.75f : 0.75f);
+  }
+  const mathfu::Vector<int, d> sum = a + b;
+  const mathfu::Vector<int, d> difference = a - b;
+  const mathfu::Vector<int, d> negated = -a;
+  const mathfu::Vector<int, d> product = a * b;
+  const mathfu::Vector<int, d> scaled = a * -3;
+  const mathfu::Vector<int, d> scaled_left = -3 * a;
+  const mathfu::Vector<int, d> min = mathfu::Vector<int, d>::Min(a, b);
+  const mathfu::Vector<int, d> max = mathfu::Vector<int, d>::Max(a, b);
+  mathfu::Vector<int, d> accumulated(a);
+  accumulated += b;
+  accumulated *= b;
+  accumulated -= a;
+  const mathfu::Vector<float, d> converted(a);
+  const mathfu::Vector<int, d> truncated(f);
+  for (int i = 0; i < d; ++i) {
+    EXPECT_EQ(a[i] + b[i], sum[i]);
+    EXPECT_EQ(a[i] - b[i], difference[i]);
+    EXPECT_EQ(-a[i], negated[i]);
+    EXPECT_EQ(a[i] * b[i], product[i]);
+    EXPECT_EQ(a[i] * -3, scaled[i]);
+    EXPECT_EQ(a[i] * -3, scaled_left[i]);
+    EXPECT_EQ(std::min(a[i], b[i]), min[i]);
+    EXPECT_EQ(std::max(a[i], b[i]), max[i]);
+    EXPECT_EQ((a[i] + b[i]) * b[i] - a[i], accumulated[i]);
+    EXPECT_EQ(static_cast<float>(a[i]), converted[i]);
+    EXPECT_EQ(a[i], truncated[i]);
+  }
+  EXPECT_TRUE(sum - b == a);
+  EXPECT_FALSE(sum - b != a);
+  EXPECT_TRUE(sum != a);
+}
+TEST_ALL_INTS_F(IntOperations)
+
+// Test operations on wide float vectors, which use the SIMD overloads for 8
+// and 16-dimensional vectors when enabled.
+template <int d>
+void WideOperations_Test(const float& precision) {
+  typedef mathfu::Vector<float, d> Vec;
+  Vec a, b;
+  for (int i = 0; i < d; ++i) {
+    a[i] = static_cast<float>(i) * 0.5f - 3.0f;
+    b[i] = static_cast<float>(d - i) * 0.25f + 1.0f;
+  }
+  const Vec sum = a + b;
+  const Vec difference = a - b;
+  const Vec product = a * b;
+  const Vec quotient = a / b;
+  const Vec negated = -a;
+  const Vec scaled = 2.0f * a / 4.0f;
+  const Vec offset = a + 1.0f - 0.5f;
+  const Vec min = Vec::Min(a, b);
+  const Vec max = Vec::Max(a, b);
+  const Vec lerp = Vec::Lerp(a, b, 0.25f);
+  Vec accumulated(a);
+  accumulated += b;
+  accumulated *= b;
+  accumulated -= a;
+  accumulated /= b;
+  accumulated *= 3.0f;
+  float dot = 0;
+  for (int i = 0; i < d; ++i) {
+    EXPECT_EQ(a[i] + b[i], sum[i]);
+    EXPECT_EQ(a[i] - b[i], difference[i]);
+    EXPECT_EQ(a[i] * b[i], product[i]);
+    EXPECT_EQ(a[i] / b[i], quotient[i]);
+    EXPECT_EQ(-a[i], negated[i]);
+    EXPECT_EQ(a[i] * 2.0f / 4.0f, scaled[i]);
+    EXPECT_EQ(a[i] + 1.0f - 0.5f, offset[i]);
+    EXPECT_EQ(std::min(a[i], b[i]), min[i]);
+    EXPECT_EQ(std::max(a[i], b[i]), max[i]);
+    EXPECT_NEAR(a[i] * 0.75f + b[i] * 0.25f, lerp[i], precision);
+    EXPECT_NEAR(((a[i] + b[i]) * b[i] - a[i]) / b[i] * 3.0f, accumulated[i],
+                precision * 10);
+    dot += a[i] * b[i];
+  }
+  EXPECT_NEAR(dot, Vec::DotProduct(a, b), precision * 100);
+  EXPECT_NEAR(sqrt(Vec::DotProduct(a, a)), a.Length(),
+              precision);
+}
+TEST_F(VectorTests, WideOperations_8) {
+  WideOperations_Test<8>(FLOAT_PRECISION);
+}
+TEST_F(VectorTests, WideOperations_16) {
+  WideOperations_Test<16>(FLOAT_PRECISION);
+}
+
 // Simple class that represents a possible compatible type for a vector.
 // That is, it's just an array of T of length d, so can be loaded and
 // stored from mathfu::Vector<T,d> using ToType() and FromType().
@@ -960,6 +1459,422 @@ TEST_F(VectorTests, OutputStream_Test_float_1) {
   OutputStream_Test<float, 1>(0.0f);
 }
 
+// Convert a float bit pattern to half precision.
+static uint16_t FloatBitsToHalf(uint32_t bits) {
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return mathfu::FloatToHalf(value);
+}
+
+// Verify conversion of special values to and from half precision.
+TEST_F(VectorTests, HalfConversion) {
+  EXPECT_EQ(0x0000, mathfu::FloatToHalf(0.0f));
+  EXPECT_EQ(0x8000, mathfu::FloatToHalf(-0.0f));
+  EXPECT_EQ(0x3C00, mathfu::FloatToHalf(1.0f));
+  EXPECT_EQ(0xC000, mathfu::FloatToHalf(-2.0f));
+  // Largest half, rounding down to it and overflow to infinity.
+  EXPECT_EQ(0x7BFF, mathfu::FloatToHalf(65504.0f));
+  EXPECT_EQ(0x7BFF, mathfu::FloatToHalf(65519.99f));
+  EXPECT_EQ(0x7C00, mathfu::FloatToHalf(65520.0f));
+  EXPECT_EQ(0xFC00, mathfu::FloatToHalf(-1e10f));
+  EXPECT_EQ(0x7C00, FloatBitsToHalf(0x7F800000));
+  // NaNs are quiet and keep the upper bits of the payload.
+  EXPECT_EQ(0x7E00, FloatBitsToHalf(0x7FC00000));
+  EXPECT_EQ(0xFE01, FloatBitsToHalf(0xFF802000));
+  // Denormals, underflow and ties rounding to even.
+  EXPECT_EQ(0x0001, mathfu::FloatToHalf(ldexpf(1.0f, -24)));
+  EXPECT_EQ(0x0000, mathfu::FloatToHalf(ldexpf(1.0f, -25)));
+  EXPECT_EQ(0x0002, mathfu::FloatToHalf(ldexpf(3.0f, -25)));
+  EXPECT_EQ(0x3C00, mathfu::FloatToHalf(1.0f + ldexpf(1.0f, -11)));
+  EXPECT_EQ(0x3C02, mathfu::FloatToHalf(1.0f + ldexpf(3.0f, -11)));
+
+  EXPECT_EQ(1.0f, mathfu::HalfToFloat(0x3C00));
+  EXPECT_EQ(65504.0f, mathfu::HalfToFloat(0x7BFF));
+  EXPECT_EQ(ldexpf(1.0f, -24), mathfu::HalfToFloat(0x0001));
+  EXPECT_EQ(-ldexpf(1023.0f, -24), mathfu::HalfToFloat(0x83FF));
+  EXPECT_EQ(-HUGE_VALF, mathfu::HalfToFloat(0xFC00));
+  EXPECT_TRUE(mathfu::HalfToFloat(0x7C01) != mathfu::HalfToFloat(0x7C01));
+
+  // Every half precision value survives a round trip, signaling NaNs become
+  // quiet.
+  for (uint32_t i = 0; i <= 0xFFFF; ++i) {
+    const uint16_t half = static_cast<uint16_t>(i);
+    const bool nan = (half & 0x7C00) == 0x7C00 && (half & 0x3FF) != 0;
+    EXPECT_EQ(nan ? half | 0x200 : half,
+              mathfu::FloatToHalf(mathfu::HalfToFloat(half)));
+  }
+}
+
+// Verify batch conversions match the scalar conversions exactly.
+TEST_F(VectorTests, HalfConversionBatch) {
+  std::vector<uint16_t> halfs(0x10000);
+  for (size_t i = 0; i < halfs.size(); ++i) {
+    halfs[i] = static_cast<uint16_t>(i);
+  }
+  std::vector<float> floats(halfs.size());
+  mathfu::HalfToFloat(&halfs[0], halfs.size() - 3, &floats[0]);
+  for (size_t i = 0; i < halfs.size() - 3; ++i) {
+    const float expected = mathfu::HalfToFloat(halfs[i]);
+    EXPECT_EQ(0, memcmp(&expected, &floats[i], sizeof(expected)));
+  }
+
+  // Sample the float range including denormals, NaNs and values between
+  // representable halfs.
+  for (size_t i = 0; i < floats.size(); ++i) {
+    const uint32_t bits = static_cast<uint32_t>(i) * 65537U + 12345U;
+    memcpy(&floats[i], &bits, sizeof(bits));
+  }
+  mathfu::FloatToHalf(&floats[0], floats.size() - 5, &halfs[0]);
+  for (size_t i = 0; i < floats.size() - 5; ++i) {
+    EXPECT_EQ(mathfu::FloatToHalf(floats[i]), halfs[i]);
+  }
+}
+
+// Pack and unpack an array of vectors.
+template <int d>
+void PackHalf_Test() {
+  typedef mathfu::Vector<float, d> Vec;
+  std::vector<Vec> vectors(7);
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    for (int j = 0; j < d; ++j) {
+      vectors[i][j] = static_cast<float>(i) * 1.37f - static_cast<float>(j);
+    }
+  }
+  std::vector<mathfu::VectorPackedHalf<d> > packed(vectors.size());
+  mathfu::PackHalf(&vectors[0], vectors.size(), &packed[0]);
+  std::vector<Vec> unpacked(vectors.size());
+  mathfu::UnpackHalf(&packed[0], packed.size(), &unpacked[0]);
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    const mathfu::VectorPackedHalf<d> expected(vectors[i]);
+    EXPECT_EQ(0, memcmp(expected.data_, packed[i].data_,
+                        sizeof(expected.data_)));
+    for (int j = 0; j < d; ++j) {
+      EXPECT_EQ(mathfu::HalfToFloat(expected.data_[j]), unpacked[i][j]);
+      EXPECT_NEAR(vectors[i][j], unpacked[i][j], 5e-3f);
+    }
+  }
+}
+TEST_F(VectorTests, PackHalf) {
+  EXPECT_EQ(6u, sizeof(mathfu::VectorPackedHalf<3>));
+  PackHalf_Test<2>();
+  PackHalf_Test<3>();
+  PackHalf_Test<4>();
+}
+
+// Verify conversion of normalized integers.
+TEST_F(VectorTests, PackedNormalized) {
+  typedef mathfu::Vector<float, 4> Vec4;
+  const mathfu::VectorPackedNormalized<int8_t, 4> snorm8(
+      Vec4(-1.0f, 0.5f, 2.0f, -0.002f));
+  EXPECT_EQ(-127, snorm8.data_[0]);
+  EXPECT_EQ(64, snorm8.data_[1]);
+  EXPECT_EQ(127, snorm8.data_[2]);
+  EXPECT_EQ(0, snorm8.data_[3]);
+  const mathfu::VectorPackedNormalized<uint16_t, 4> unorm16(
+      Vec4(-1.0f, 0.5f, 2.0f, 1.0f));
+  EXPECT_EQ(0, unorm16.data_[0]);
+  EXPECT_EQ(32768, unorm16.data_[1]);
+  EXPECT_EQ(65535, unorm16.data_[2]);
+  EXPECT_EQ(65535, unorm16.data_[3]);
+  EXPECT_EQ(1.0f, unorm16.Unpack()[3]);
+
+  // Every value round trips, the most negative snorm value is -1.
+  typedef mathfu::VectorPackedNormalized<int8_t, 1> Snorm8;
+  typedef mathfu::VectorPackedNormalized<uint16_t, 1> Unorm16;
+  for (int i = -128; i < 128; ++i) {
+    Snorm8 packed;
+    packed.data_[0] = static_cast<int8_t>(i);
+    EXPECT_EQ(i == -128 ? -127 : i, Snorm8(packed.Unpack()).data_[0]);
+  }
+  for (int i = 0; i < 65536; ++i) {
+    Unorm16 packed;
+    packed.data_[0] = static_cast<uint16_t>(i);
+    EXPECT_EQ(i, Unorm16(packed.Unpack()).data_[0]);
+  }
+
+  const mathfu::VectorPackedRGB10A2 rgb10a2(Vec4(1.0f, 0.0f, 0.5f, 0.4f));
+  EXPECT_EQ(0x3FFU | (512U << 20) | (1U << 30), rgb10a2.data_);
+  const Vec4 unpacked = rgb10a2.Unpack();
+  EXPECT_EQ(1.0f, unpacked[0]);
+  EXPECT_EQ(0.0f, unpacked[1]);
+  EXPECT_NEAR(0.5f, unpacked[2], 1e-3f);
+  EXPECT_NEAR(1.0f / 3.0f, unpacked[3], 1e-6f);
+}
+
+// Pack and unpack vectors with an array function and compare the result
+// with converting each vector, unpacking may differ by rounding.
+template <class Packed, int d>
+void CheckPackVectors(const std::vector<mathfu::Vector<float, d> >& vectors) {
+  typedef mathfu::Vector<float, d> Vec;
+  std::vector<Packed> packed(vectors.size());
+  mathfu::PackVectors(&vectors[0], vectors.size(), &packed[0]);
+  std::vector<Vec> unpacked(vectors.size());
+  mathfu::UnpackVectors(&packed[0], packed.size(), &unpacked[0]);
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    const Packed expected(vectors[i]);
+    EXPECT_EQ(0, memcmp(&expected, &packed[i], sizeof(expected)));
+    const Vec expected_unpacked = expected.Unpack();
+    for (int j = 0; j < d; ++j) {
+      EXPECT_NEAR(expected_unpacked[j], unpacked[i][j],
+                  4 * std::numeric_limits<float>::epsilon());
+    }
+  }
+}
+
+// Vectors in and slightly beyond [-1, 1].
+template <int d>
+std::vector<mathfu::Vector<float, d> > NormalizedTestVectors() {
+  std::vector<mathfu::Vector<float, d> > vectors(11);
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    for (int j = 0; j < d; ++j) {
+      vectors[i][j] = sinf(static_cast<float>(i * d + j) * 0.7f) * 1.1f;
+    }
+  }
+  vectors[3][0] = 0.5f / 127.0f;
+  vectors[4][0] = -0.5f / 127.0f;
+  return vectors;
+}
+
+template <int d>
+void PackVectorsNormalized_Test() {
+  const std::vector<mathfu::Vector<float, d> > vectors =
+      NormalizedTestVectors<d>();
+  CheckPackVectors<mathfu::VectorPackedNormalized<int8_t, d> >(vectors);
+  CheckPackVectors<mathfu::VectorPackedNormalized<uint8_t, d> >(vectors);
+  CheckPackVectors<mathfu::VectorPackedNormalized<int16_t, d> >(vectors);
+  CheckPackVectors<mathfu::VectorPackedNormalized<uint16_t, d> >(vectors);
+}
+TEST_F(VectorTests, PackVectorsNormalized) {
+  PackVectorsNormalized_Test<2>();
+  PackVectorsNormalized_Test<3>();
+  PackVectorsNormalized_Test<4>();
+  CheckPackVectors<mathfu::VectorPackedRGB10A2>(NormalizedTestVectors<4>());
+}
+
+// Verify the accuracy of octahedral unit vectors.
+template <class T>
+void PackVectorsOctahedral_Test(double max_angle) {
+  typedef mathfu::Vector<float, 3> Vec3;
+  // Points spread over the sphere plus the axes.
+  std::vector<Vec3> vectors;
+  const int kPoints = 4001;
+  for (int i = 0; i < kPoints; ++i) {
+    const float z = 1.0f - 2.0f * (static_cast<float>(i) + 0.5f) / kPoints;
+    const float radius = sqrtf(1.0f - z * z);
+    const float angle = static_cast<float>(i) * 2.39996323f;
+    vectors.push_back(Vec3(radius * cosf(angle), radius * sinf(angle), z));
+  }
+  for (int i = 0; i < 3; ++i) {
+    Vec3 axis(0.0f, 0.0f, 0.0f);
+    axis[i] = 1.0f;
+    vectors.push_back(axis);
+    vectors.push_back(-axis);
+  }
+  CheckPackVectors<mathfu::VectorPackedOctahedral<T> >(vectors);
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    const Vec3 unpacked =
+        mathfu::VectorPackedOctahedral<T>(vectors[i]).Unpack();
+    EXPECT_NEAR(1.0f, unpacked.Length(), 1e-6f);
+    // Measure the angle in double precision, float acos() is not accurate
+    // enough for small angles.
+    const mathfu::Vector<double, 3> a(vectors[i][0], vectors[i][1],
+                                      vectors[i][2]);
+    const mathfu::Vector<double, 3> b(unpacked[0], unpacked[1], unpacked[2]);
+    EXPECT_LT(atan2(mathfu::Vector<double, 3>::CrossProduct(a, b).Length(),
+                    mathfu::Vector<double, 3>::DotProduct(a, b)),
+              max_angle);
+  }
+}
+TEST_F(VectorTests, PackVectorsOctahedral) {
+  EXPECT_EQ(2u, sizeof(mathfu::VectorPackedOctahedral<int8_t>));
+  EXPECT_EQ(4u, sizeof(mathfu::VectorPackedOctahedral<int16_t>));
+  PackVectorsOctahedral_Test<int8_t>(0.017);
+  PackVectorsOctahedral_Test<int16_t>(6.5e-5);
+}
+
+// Write arrays to an archive and access them in place.
+TEST_F(VectorTests, BinaryArchive) {
+  typedef mathfu::VectorPacked<float, 3> Packed3;
+  typedef mathfu::Matrix<float, 4, 4> Matrix4;
+  typedef mathfu::Quaternion<double> QuaternionD;
+  std::vector<Packed3> points(5);
+  for (size_t i = 0; i < points.size(); ++i) {
+    for (int j = 0; j < 3; ++j) {
+      points[i].data_[j] = static_cast<float>(i * 3 + j);
+    }
+  }
+  std::vector<Matrix4, mathfu::simd_allocator<Matrix4> > transforms(3);
+  for (size_t i = 0; i < transforms.size(); ++i) {
+    transforms[i] = Matrix4::FromTranslationVector(
+        mathfu::Vector<float, 3>(static_cast<float>(i), 2.0f, 3.0f));
+  }
+  const QuaternionD rotations[] = {QuaternionD(1.0, 0.0, 0.0, 0.0),
+                                   QuaternionD(0.5, 0.5, 0.5, 0.5)};
+  mathfu::BinaryArchiveWriter writer;
+  writer.AddArray(1, &points[0], points.size());
+  writer.AddArray(2, &transforms[0], transforms.size());
+  writer.AddArray(3, rotations, 2);
+  writer.AddArray(4, static_cast<const float*>(NULL), 0);
+  const size_t size = writer.size();
+  EXPECT_EQ(0u, size % mathfu::kBinaryArchiveAlignment);
+  uint8_t* const buffer =
+      static_cast<uint8_t*>(mathfu::AllocateAligned(size));
+  EXPECT_FALSE(writer.Write(buffer, size - 1));
+  EXPECT_TRUE(writer.Write(buffer, size));
+
+  mathfu::BinaryArchive archive;
+  ASSERT_TRUE(archive.Initialize(buffer, size));
+  EXPECT_EQ(4u, archive.num_arrays());
+  EXPECT_EQ(3u, archive.array(2).id);
+  mathfu::BinaryArrayView<Packed3> point_view;
+  ASSERT_TRUE(archive.FindArray(1, &point_view));
+  ASSERT_EQ(points.size(), point_view.size());
+  EXPECT_TRUE(point_view.data() > static_cast<const void*>(buffer) &&
+              point_view.end() <= static_cast<const void*>(buffer + size));
+  EXPECT_EQ(0, memcmp(&points[0], point_view.data(),
+                      sizeof(points[0]) * points.size()));
+  mathfu::BinaryArrayView<Matrix4> transform_view;
+  ASSERT_TRUE(archive.GetArray(1, &transform_view));
+  ASSERT_EQ(transforms.size(), transform_view.size());
+  for (size_t i = 0; i < transforms.size(); ++i) {
+    for (int j = 0; j < 16; ++j) {
+      EXPECT_EQ(transforms[i][j], transform_view[i][j]);
+    }
+  }
+  mathfu::BinaryArrayView<QuaternionD> rotation_view;
+  ASSERT_TRUE(archive.FindArray(3, &rotation_view));
+  ASSERT_EQ(2u, rotation_view.size());
+  for (int j = 0; j < 4; ++j) EXPECT_EQ(rotations[1][j], rotation_view[1][j]);
+  mathfu::BinaryArrayView<float> empty_view;
+  EXPECT_TRUE(archive.FindArray(4, &empty_view));
+  EXPECT_TRUE(empty_view.empty());
+
+  // Arrays are only returned as the type they were written with.
+  mathfu::BinaryArrayView<mathfu::VectorPacked<float, 4> > packed4_view;
+  EXPECT_FALSE(archive.FindArray(1, &packed4_view));
+  mathfu::BinaryArrayView<mathfu::Quaternion<float> > rotationf_view;
+  EXPECT_FALSE(archive.FindArray(3, &rotationf_view));
+  EXPECT_FALSE(archive.FindArray(5, &empty_view));
+  EXPECT_FALSE(archive.GetArray(4, &empty_view));
+
+  // Reject truncated archives, archives with a different byte order or
+  // version, a size smaller than the header and out of range arrays.
+  EXPECT_FALSE(archive.Initialize(buffer, size - 1));
+  EXPECT_EQ(0u, archive.num_arrays());
+  const struct {
+    size_t offset;
+    uint32_t value;
+  } kCorruptions[] = {
+      {offsetof(mathfu::BinaryArchiveHeader, byte_order), 0x04030201},
+      {offsetof(mathfu::BinaryArchiveHeader, version),
+       mathfu::kBinaryArchiveVersion + 1},
+      {offsetof(mathfu::BinaryArchiveHeader, size),
+       static_cast<uint32_t>(sizeof(mathfu::BinaryArchiveHeader) - 1)},
+      {sizeof(mathfu::BinaryArchiveHeader) +
+           offsetof(mathfu::BinaryArchiveArray, count),
+       0xFFFFFFFF},
+      {sizeof(mathfu::BinaryArchiveHeader) +
+           offsetof(mathfu::BinaryArchiveArray, offset),
+       mathfu::kBinaryArchiveAlignment * 2 + 4}};
+  for (size_t i = 0; i < sizeof(kCorruptions) / sizeof(kCorruptions[0]);
+       ++i) {
+    uint8_t* const field = buffer + kCorruptions[i].offset;
+    uint32_t original;
+    memcpy(&original, field, sizeof(original));
+    memcpy(field, &kCorruptions[i].value, sizeof(kCorruptions[i].value));
+    EXPECT_FALSE(archive.Initialize(buffer, size));
+    memcpy(field, &original, sizeof(original));
+  }
+  EXPECT_TRUE(archive.Initialize(buffer, size));
+
+  // Map the archive from a file.
+  const std::string filename =
+      ::testing::TempDir() + "mathfu_binary_archive_test.bin";
+  ASSERT_TRUE(writer.Write(filename.c_str()));
+  mathfu::BinaryArchive mapped;
+  ASSERT_TRUE(mapped.Open(filename.c_str()));
+  ASSERT_EQ(4u, mapped.num_arrays());
+  ASSERT_TRUE(mapped.FindArray(2, &transform_view));
+  ASSERT_EQ(transforms.size(), transform_view.size());
+  EXPECT_EQ(0, memcmp(&transforms[0], transform_view.data(),
+                      sizeof(transforms[0]) * transforms.size()));
+  mapped.Close();
+  EXPECT_EQ(0u, mapped.num_arrays());
+  remove(filename.c_str());
+  EXPECT_FALSE(mapped.Open(filename.c_str()));
+  mathfu::FreeAligned(buffer);
+}
+
+// Format and parse vectors, matrices and quaternions.
+TEST_F(VectorTests, ToCharsFromChars) {
+  typedef mathfu::Vector<float, 3> Vec3;
+  typedef mathfu::Matrix<float, 2, 2> Mat2;
+  char buffer[256];
+  const Vec3 v(1.5f, -2.0f, 0.1f);
+  mathfu::ToCharsResult written =
+      mathfu::ToChars(buffer, buffer + sizeof(buffer), v);
+  EXPECT_EQ(std::errc(), written.ec);
+  EXPECT_EQ("1.5 -2 0.1", std::string(buffer, written.ptr));
+  written = mathfu::ToChars(buffer, buffer + sizeof(buffer), v, ',');
+  EXPECT_EQ("1.5,-2,0.1", std::string(buffer, written.ptr));
+  EXPECT_EQ(std::errc::value_too_large,
+            mathfu::ToChars(buffer, buffer + 9, v, ',').ec);
+
+  Vec3 parsed(static_cast<float>(0));
+  const char kText[] = " 1.5 , -2,0.1\n";
+  mathfu::FromCharsResult read =
+      mathfu::FromChars(kText, kText + sizeof(kText) - 1, &parsed, ',');
+  EXPECT_EQ(std::errc(), read.ec);
+  EXPECT_EQ(kText + sizeof(kText) - 2, read.ptr);
+  for (int i = 0; i < 3; ++i) EXPECT_EQ(v[i], parsed[i]);
+  const char kShort[] = "1 2";
+  EXPECT_EQ(std::errc::invalid_argument,
+            mathfu::FromChars(kShort, kShort + 3, &parsed).ec);
+  const char kDoubleSeparator[] = "1,,2,3";
+  EXPECT_EQ(std::errc::invalid_argument,
+            mathfu::FromChars(kDoubleSeparator, kDoubleSeparator + 6, &parsed,
+                              ',')
+                .ec);
+  EXPECT_EQ(v[0], parsed[0]);
+
+  // Values round trip exactly.
+  const Mat2 m(1.0f / 3.0f, 1e-30f, -7e20f, 0.2f);
+  written = mathfu::ToChars(buffer, buffer + sizeof(buffer), m);
+  Mat2 parsed_m;
+  read = mathfu::FromChars(buffer, written.ptr, &parsed_m);
+  EXPECT_EQ(written.ptr, read.ptr);
+  for (int i = 0; i < 4; ++i) EXPECT_EQ(m[i], parsed_m[i]);
+  const mathfu::Quaternion<double> q(0.1, 0.2, 0.3, 1.0 / 7.0);
+  written = mathfu::ToChars(buffer, buffer + sizeof(buffer), q);
+  mathfu::Quaternion<double> parsed_q;
+  read = mathfu::FromChars(buffer, written.ptr, &parsed_q);
+  for (int i = 0; i < 4; ++i) EXPECT_EQ(q[i], parsed_q[i]);
+
+  // Arrays are written one per line.
+  const mathfu::Vector<int, 2> ints[] = {mathfu::Vector<int, 2>(1, -2),
+                                         mathfu::Vector<int, 2>(30, 4)};
+  written = mathfu::ToCharsArray(buffer, buffer + sizeof(buffer), ints, 2, ',');
+  EXPECT_EQ("1,-2\n30,4\n", std::string(buffer, written.ptr));
+  EXPECT_EQ(std::errc::value_too_large,
+            mathfu::ToCharsArray(buffer, buffer + 9, ints, 2, ',').ec);
+  mathfu::Vector<int, 2> parsed_ints[2];
+  read = mathfu::FromCharsArray(buffer, written.ptr, parsed_ints, 2, ',');
+  EXPECT_EQ(std::errc(), read.ec);
+  EXPECT_EQ(30, parsed_ints[1][0]);
+  EXPECT_EQ(4, parsed_ints[1][1]);
+
+  // Errors match std::from_chars() with or without the C library fallback.
+  const char kOutOfRange[] = "1 1e40 2";
+  read = mathfu::FromChars(kOutOfRange, kOutOfRange + 8, &parsed);
+  EXPECT_EQ(std::errc::result_out_of_range, read.ec);
+  EXPECT_EQ(kOutOfRange + 6, read.ptr);
+  const char kPlus[] = "+1 2 3";
+  read = mathfu::FromChars(kPlus, kPlus + 6, &parsed);
+  EXPECT_EQ(std::errc::invalid_argument, read.ec);
+  EXPECT_EQ(kPlus, read.ptr);
+  EXPECT_EQ(v[0], parsed[0]);
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   printf("%s (%s)\n", argv[0], MATHFU_BUILD_OPTIONS_STRING);